@@ -0,0 +1,146 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "xframe/xreindex_view.hpp"
+#include "xframe/xvariable_masked_view.hpp"
+#include "xframe/xvariable_view.hpp"
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        /**************
+         * assignment *
+         **************/
+
+        // Operands share their coordinates, the data are assigned with
+        // a linear loop
+        void assign_trivial(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto a = make_variable(n);
+            auto b = make_variable(n);
+            variable_type res = a + b;
+            for (auto _ : state)
+            {
+                res = a + b;
+                benchmark::ClobberMemory();
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * n));
+        }
+
+        // Operands have overlapping coordinates, each element is gathered
+        void assign_non_trivial(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            int offset = static_cast<int>(n / 2);
+            auto a = make_variable(n);
+            auto b = make_variable(n, offset, offset);
+            variable_type res = a + b;
+            for (auto _ : state)
+            {
+                res = a + b;
+                benchmark::ClobberMemory();
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * n));
+        }
+
+        BENCHMARK(assign_trivial)->Range(min_variable_size, max_variable_size);
+        BENCHMARK(assign_non_trivial)->Range(min_variable_size, max_variable_size);
+
+        /*******************
+         * view assignment *
+         *******************/
+
+        // Copies the central quarter of the variable
+        void assign_from_view(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(n);
+            int start = static_cast<int>(n / 4);
+            int stop = static_cast<int>(3 * n / 4);
+            auto v = select(var, {{"x", range(start, stop)}, {"y", range(start, stop)}});
+            for (auto _ : state)
+            {
+                variable_type res = v;
+                benchmark::DoNotOptimize(res);
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.data().size()));
+        }
+
+        // Overwrites the central quarter of the variable
+        void assign_to_view(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(n);
+            int start = static_cast<int>(n / 4);
+            int stop = static_cast<int>(3 * n / 4);
+            auto v = select(var, {{"x", range(start, stop)}, {"y", range(start, stop)}});
+            variable_type src = v;
+            for (auto _ : state)
+            {
+                v = src;
+                benchmark::ClobberMemory();
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.data().size()));
+        }
+
+        BENCHMARK(assign_from_view)->Range(min_variable_size, max_variable_size);
+        BENCHMARK(assign_to_view)->Range(min_variable_size, max_variable_size);
+
+        /***********
+         * reindex *
+         ***********/
+
+        // The new x axis overlaps the second half of the original one, half
+        // of the result is missing
+        void assign_from_reindex(benchmark::State& state)
+        {
+            using coordinate_map = coordinate_type::map_type;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(n);
+            coordinate_map new_coord;
+            new_coord["x"] = xaxis<int, std::size_t>(make_int_labels(n, false, static_cast<int>(n / 2)));
+            auto v = reindex(var, new_coord);
+            for (auto _ : state)
+            {
+                variable_type res = v;
+                benchmark::DoNotOptimize(res);
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * n));
+        }
+
+        BENCHMARK(assign_from_reindex)->Range(min_variable_size, max_variable_size);
+
+        /*********
+         * where *
+         *********/
+
+        // Sets the elements of the first half of the y axis
+        void assign_where(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(n);
+            int threshold = static_cast<int>(n / 2);
+            auto masked = where(var, var.axis<int>("y") < threshold);
+            for (auto _ : state)
+            {
+                masked = 1.;
+                benchmark::ClobberMemory();
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n * n));
+        }
+
+        BENCHMARK(assign_where)->Range(min_variable_size, max_variable_size);
+    }
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "xframe/xaxis.hpp"
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        template <class L>
+        inline std::vector<L> make_labels(std::size_t n, bool shuffled);
+
+        template <>
+        inline std::vector<int> make_labels<int>(std::size_t n, bool shuffled)
+        {
+            return make_int_labels(n, shuffled);
+        }
+
+        template <>
+        inline std::vector<fstring> make_labels<fstring>(std::size_t n, bool shuffled)
+        {
+            auto res = make_string_labels(n);
+            return shuffled ? make_probes(std::move(res)) : res;
+        }
+
+        /**************
+         * axis build *
+         **************/
+
+        template <class L, class MT>
+        void axis_build(benchmark::State& state)
+        {
+            using axis_type = xaxis<L, std::size_t, MT>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto labels = make_labels<L>(n, true);
+            for (auto _ : state)
+            {
+                axis_type a(labels);
+                benchmark::DoNotOptimize(a);
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+        }
+
+        BENCHMARK_TEMPLATE(axis_build, int, map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_build, int, hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_build, int, flat_hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_build, int, sorted_vector_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_build, fstring, map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_build, fstring, hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_build, fstring, flat_hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_build, fstring, sorted_vector_tag)->Range(min_axis_size, max_axis_size);
+
+        /***************
+         * axis lookup *
+         ***************/
+
+        template <class L, class MT>
+        void axis_contains(benchmark::State& state)
+        {
+            using axis_type = xaxis<L, std::size_t, MT>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            axis_type a(make_labels<L>(n, false));
+            auto probes = make_probes(make_labels<L>(n, false));
+            for (auto _ : state)
+            {
+                for (const auto& l : probes)
+                {
+                    benchmark::DoNotOptimize(a.contains(l));
+                }
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+        }
+
+        BENCHMARK_TEMPLATE(axis_contains, int, map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_contains, int, hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_contains, int, flat_hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_contains, int, sorted_vector_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_contains, fstring, map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_contains, fstring, hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_contains, fstring, flat_hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_contains, fstring, sorted_vector_tag)->Range(min_axis_size, max_axis_size);
+
+        template <class L, class MT>
+        void axis_access(benchmark::State& state)
+        {
+            using axis_type = xaxis<L, std::size_t, MT>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            axis_type a(make_labels<L>(n, false));
+            auto probes = make_probes(make_labels<L>(n, false));
+            for (auto _ : state)
+            {
+                for (const auto& l : probes)
+                {
+                    benchmark::DoNotOptimize(a[l]);
+                }
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * n));
+        }
+
+        BENCHMARK_TEMPLATE(axis_access, int, map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_access, int, hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_access, int, flat_hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_access, int, sorted_vector_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_access, fstring, map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_access, fstring, hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_access, fstring, flat_hash_map_tag)->Range(min_axis_size, max_axis_size);
+        BENCHMARK_TEMPLATE(axis_access, fstring, sorted_vector_tag)->Range(min_axis_size, max_axis_size);
+
+        /**************************
+         * axis merge / intersect *
+         **************************/
+
+        // The second axis overlaps the second half of the first one. Copying
+        // the first axis is part of the measure, as merge and intersect are
+        // performed in place.
+        template <class MT>
+        void axis_merge(benchmark::State& state)
+        {
+            using axis_type = xaxis<int, std::size_t, MT>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            bool shuffled = state.range(1) != 0;
+            axis_type a(make_int_labels(n, shuffled));
+            axis_type b(make_int_labels(n, shuffled, static_cast<int>(n / 2)));
+            for (auto _ : state)
+            {
+                axis_type res = a;
+                benchmark::DoNotOptimize(res.merge(b));
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2 * n));
+        }
+
+        template <class MT>
+        void axis_intersect(benchmark::State& state)
+        {
+            using axis_type = xaxis<int, std::size_t, MT>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            bool shuffled = state.range(1) != 0;
+            axis_type a(make_int_labels(n, shuffled));
+            axis_type b(make_int_labels(n, shuffled, static_cast<int>(n / 2)));
+            for (auto _ : state)
+            {
+                axis_type res = a;
+                benchmark::DoNotOptimize(res.intersect(b));
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 2 * n));
+        }
+
+        // Second argument: 0 for sorted labels, 1 for unsorted labels
+        BENCHMARK_TEMPLATE(axis_merge, map_tag)->Ranges({{min_axis_size, max_axis_size}, {0, 1}});
+        BENCHMARK_TEMPLATE(axis_merge, hash_map_tag)->Ranges({{min_axis_size, max_axis_size}, {0, 1}});
+        BENCHMARK_TEMPLATE(axis_intersect, map_tag)->Ranges({{min_axis_size, max_axis_size}, {0, 1}});
+        BENCHMARK_TEMPLATE(axis_intersect, hash_map_tag)->Ranges({{min_axis_size, max_axis_size}, {0, 1}});
+    }
+}
@@ -0,0 +1,40 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "xframe/xcoordinate.hpp"
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        // c1 and c2 hold identical labels when the second argument is 0,
+        // overlapping labels otherwise
+        template <class Join>
+        void coordinate_broadcast(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            int offset = state.range(1) != 0 ? static_cast<int>(n / 2) : 0;
+            auto c1 = make_coordinate(n);
+            auto c2 = make_coordinate(n, offset, offset);
+            for (auto _ : state)
+            {
+                coordinate_type res;
+                benchmark::DoNotOptimize(broadcast_coordinates<Join>(res, c1, c2));
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 4 * n));
+        }
+
+        BENCHMARK_TEMPLATE(coordinate_broadcast, join::outer)->Ranges({{min_axis_size, max_axis_size}, {0, 1}});
+        BENCHMARK_TEMPLATE(coordinate_broadcast, join::inner)->Ranges({{min_axis_size, max_axis_size}, {0, 1}});
+    }
+}
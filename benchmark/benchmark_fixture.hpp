@@ -0,0 +1,106 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_BENCHMARK_FIXTURE_HPP
+#define XFRAME_BENCHMARK_FIXTURE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+#include "xframe/xnamed_axis.hpp"
+#include "xframe/xvariable.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        using data_type = xt::xoptional_assembly<xt::xarray<double>, xt::xarray<bool>>;
+        using coordinate_type = xcoordinate<fstring>;
+        using dimension_type = xdimension<fstring>;
+        using variable_type = xvariable_container<coordinate_type, data_type>;
+
+        // Sizes used by the benchmarks on axes, from 1K to 1M labels
+        constexpr std::size_t min_axis_size = std::size_t(1) << 10;
+        constexpr std::size_t max_axis_size = std::size_t(1) << 20;
+
+        // Number of labels along each dimension of the benchmarked variables
+        constexpr std::size_t min_variable_size = std::size_t(1) << 6;
+        constexpr std::size_t max_variable_size = std::size_t(1) << 11;
+
+        // { start, ..., start + n - 1 }, shuffled if requested
+        inline std::vector<int> make_int_labels(std::size_t n, bool shuffled, int start = 0)
+        {
+            std::vector<int> res(n);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                res[i] = start + static_cast<int>(i);
+            }
+            if (shuffled)
+            {
+                std::shuffle(res.begin(), res.end(), std::mt19937(42));
+            }
+            return res;
+        }
+
+        // { "l0000000", "l0000001", ... }, sorted
+        inline std::vector<fstring> make_string_labels(std::size_t n, std::size_t start = 0)
+        {
+            std::vector<fstring> res;
+            res.reserve(n);
+            char buffer[16];
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                std::snprintf(buffer, sizeof(buffer), "l%07zu", start + i);
+                res.emplace_back(buffer);
+            }
+            return res;
+        }
+
+        // Labels to look up, in random order
+        template <class L>
+        inline std::vector<L> make_probes(std::vector<L> labels)
+        {
+            std::shuffle(labels.begin(), labels.end(), std::mt19937(7));
+            return labels;
+        }
+
+        // x: { x0, ..., x0 + n - 1 }
+        // y: { y0, ..., y0 + n - 1 }
+        inline coordinate_type make_coordinate(std::size_t n, int x0 = 0, int y0 = 0)
+        {
+            int size = static_cast<int>(n);
+            return coordinate<fstring>(
+                named_axis(fstring("x"), axis(x0, x0 + size)),
+                named_axis(fstring("y"), axis(y0, y0 + size))
+            );
+        }
+
+        // coordinates: make_coordinate(n, x0, y0)
+        // data(i, j) = i * n + j, every seventh element missing
+        inline variable_type make_variable(std::size_t n, int x0 = 0, int y0 = 0)
+        {
+            auto c = make_coordinate(n, x0, y0);
+            data_type d(typename data_type::shape_type({n, n}));
+            for (std::size_t i = 0; i < d.size(); ++i)
+            {
+                d.storage()[i].value() = double(i);
+                d.storage()[i].has_value() = i % 7 != 0;
+            }
+            return variable_type(std::move(d), std::move(c), dimension_type({"x", "y"}));
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,166 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <benchmark/benchmark.h>
+
+#include "xframe/xvariable_view.hpp"
+#include "benchmark_fixture.hpp"
+
+namespace xf
+{
+    namespace bench
+    {
+        // Number of elements accessed by each iteration of the benchmarks
+        constexpr std::size_t nb_accesses = std::size_t(1) << 12;
+
+        inline std::vector<std::size_t> make_positions(std::size_t n)
+        {
+            auto labels = make_probes(make_int_labels(nb_accesses, false));
+            std::vector<std::size_t> res(labels.size());
+            std::transform(labels.cbegin(), labels.cend(), res.begin(),
+                           [n](int l) { return static_cast<std::size_t>(l) % n; });
+            return res;
+        }
+
+        void variable_select(benchmark::State& state)
+        {
+            using selector_type = variable_type::selector_sequence_type<>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            const auto var = make_variable(n);
+            auto pos = make_positions(n);
+            std::vector<selector_type> selectors;
+            selectors.reserve(pos.size());
+            for (std::size_t i = 0; i < pos.size(); ++i)
+            {
+                int x = static_cast<int>(pos[i]);
+                int y = static_cast<int>(pos[pos.size() - i - 1]);
+                selectors.push_back({{"x", x}, {"y", y}});
+            }
+            for (auto _ : state)
+            {
+                for (const auto& s : selectors)
+                {
+                    benchmark::DoNotOptimize(var.select(s));
+                }
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * selectors.size()));
+        }
+
+        void variable_prepared_select(benchmark::State& state)
+        {
+            using label_sequence_type = variable_type::label_sequence_type<>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            const auto var = make_variable(n);
+            auto selector = var.prepare_selector({"x", "y"});
+            auto pos = make_positions(n);
+            std::vector<label_sequence_type> labels;
+            labels.reserve(pos.size());
+            for (std::size_t i = 0; i < pos.size(); ++i)
+            {
+                int x = static_cast<int>(pos[i]);
+                int y = static_cast<int>(pos[pos.size() - i - 1]);
+                labels.push_back({x, y});
+            }
+            for (auto _ : state)
+            {
+                for (const auto& l : labels)
+                {
+                    benchmark::DoNotOptimize(var.select(selector, l));
+                }
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * labels.size()));
+        }
+
+        void variable_iselect(benchmark::State& state)
+        {
+            using iselector_type = variable_type::iselector_sequence_type<>;
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            const auto var = make_variable(n);
+            auto pos = make_positions(n);
+            std::vector<iselector_type> selectors;
+            selectors.reserve(pos.size());
+            for (std::size_t i = 0; i < pos.size(); ++i)
+            {
+                selectors.push_back({{"x", pos[i]}, {"y", pos[pos.size() - i - 1]}});
+            }
+            for (auto _ : state)
+            {
+                for (const auto& s : selectors)
+                {
+                    benchmark::DoNotOptimize(var.iselect(s));
+                }
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * selectors.size()));
+        }
+
+        void variable_locate(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            const auto var = make_variable(n);
+            auto pos = make_positions(n);
+            for (auto _ : state)
+            {
+                for (std::size_t i = 0; i < pos.size(); ++i)
+                {
+                    int x = static_cast<int>(pos[i]);
+                    int y = static_cast<int>(pos[pos.size() - i - 1]);
+                    benchmark::DoNotOptimize(var.locate(x, y));
+                }
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * pos.size()));
+        }
+
+        BENCHMARK(variable_select)->Range(min_variable_size, max_variable_size);
+        BENCHMARK(variable_prepared_select)->Range(min_variable_size, max_variable_size);
+        BENCHMARK(variable_iselect)->Range(min_variable_size, max_variable_size);
+        BENCHMARK(variable_locate)->Range(min_variable_size, max_variable_size);
+
+        /*********
+         * views *
+         *********/
+
+        // Builds a view on the central quarter of the variable
+        void view_build(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(n);
+            int start = static_cast<int>(n / 4);
+            int stop = static_cast<int>(3 * n / 4);
+            for (auto _ : state)
+            {
+                auto v = select(var, {{"x", range(start, stop)}, {"y", range(start, stop)}});
+                benchmark::DoNotOptimize(v);
+            }
+        }
+
+        // Reads all the elements of a view on the central quarter of the variable
+        void view_iterate(benchmark::State& state)
+        {
+            std::size_t n = static_cast<std::size_t>(state.range(0));
+            auto var = make_variable(n);
+            int start = static_cast<int>(n / 4);
+            int stop = static_cast<int>(3 * n / 4);
+            auto v = select(var, {{"x", range(start, stop)}, {"y", range(start, stop)}});
+            for (auto _ : state)
+            {
+                double sum = 0.;
+                for (auto it = v.data().cbegin(); it != v.data().cend(); ++it)
+                {
+                    sum += it->value();
+                }
+                benchmark::DoNotOptimize(sum);
+            }
+            state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * v.data().size()));
+        }
+
+        BENCHMARK(view_build)->Range(min_variable_size, max_variable_size);
+        BENCHMARK(view_iterate)->Range(min_variable_size, max_variable_size);
+    }
+}
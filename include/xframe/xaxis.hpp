@@ -13,18 +13,22 @@
 
 #include <initializer_list>
 #include <iterator>
+#include <stdexcept>
 #include <algorithm>
 #include <map>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "xtl/xclosure.hpp"
 #include "xtl/xiterator_base.hpp"
 
 #include "xtensor/xbuilder.hpp"
 
 #include "xaxis_base.hpp"
+#include "xflat_hash_map.hpp"
 #include "xframe_utils.hpp"
+#include "xsorted_index.hpp"
 
 namespace xf
 {
@@ -34,12 +38,17 @@ namespace xf
     template <class L, class T>
     class xaxis_default;
 
+    template <class L, class T>
+    class xaxis_arange;
+
     /*********************
      * map container tag *
      *********************/
 
     struct map_tag {};
     struct hash_map_tag {};
+    struct sorted_vector_tag {};
+    struct flat_hash_map_tag {};
 
     template <class K, class T, class MT>
     struct map_container;
@@ -56,9 +65,163 @@ namespace xf
         using type = std::unordered_map<K, T>;
     };
 
+    template <class K, class T>
+    struct map_container<K, T, sorted_vector_tag>
+    {
+        using type = xsorted_index<K, T>;
+    };
+
+    template <class K, class T>
+    struct map_container<K, T, flat_hash_map_tag>
+    {
+        using type = xflat_hash_map<K, T>;
+    };
+
     template <class K, class T, class MT>
     using map_container_t = typename map_container<K, T, MT>::type;
 
+    /**********************
+     * xaxis_index_policy *
+     **********************/
+
+    namespace detail
+    {
+        // Node-based maps hold the label-position pairs, iterators
+        // of the axis return references to these pairs.
+        template <class M>
+        struct xaxis_index_policy
+        {
+            using map_type = M;
+            using key_type = typename map_type::key_type;
+            using mapped_type = typename map_type::mapped_type;
+            using value_type = typename map_type::value_type;
+            using const_reference = typename map_type::const_reference;
+            using const_pointer = typename map_type::const_pointer;
+
+            template <class LL>
+            static void populate(map_type& index, const LL& labels, bool /*is_sorted*/)
+            {
+                index.clear();
+                for (std::size_t i = 0; i < labels.size(); ++i)
+                {
+                    index[labels[i]] = mapped_type(i);
+                }
+            }
+
+            template <class LL>
+            static void extend(map_type& index, const LL& labels, std::size_t first, bool /*is_sorted*/)
+            {
+                for (std::size_t i = first; i < labels.size(); ++i)
+                {
+                    index[labels[i]] = mapped_type(i);
+                }
+            }
+
+            template <class LL>
+            static std::size_t position(const map_type& index, const LL& labels, const key_type& key)
+            {
+                auto iter = index.find(key);
+                return iter != index.end() ? static_cast<std::size_t>(iter->second) : labels.size();
+            }
+
+            template <class It>
+            static const_reference dereference(const map_type& index, It it, It /*first*/)
+            {
+                return *(index.find(*it));
+            }
+
+            template <class It>
+            static const_pointer arrow(const map_type& index, It it, It /*first*/)
+            {
+                return &(*(index.find(*it)));
+            }
+        };
+
+        // Other indexes do not hold label-position pairs, iterators of
+        // the axis return proxies holding a reference on the label and
+        // the position by value, so that they do not depend on the
+        // lifetime of the iterator.
+        template <class K, class T>
+        struct xaxis_proxy_index_policy
+        {
+            using key_type = K;
+            using mapped_type = T;
+            using value_type = std::pair<key_type, mapped_type>;
+            using const_reference = std::pair<const key_type&, mapped_type>;
+            using const_pointer = xtl::xclosure_pointer<const_reference>;
+
+            template <class M, class It>
+            static const_reference dereference(const M& /*index*/, It it, It first)
+            {
+                return const_reference(*it, static_cast<mapped_type>(it - first));
+            }
+
+            template <class M, class It>
+            static const_pointer arrow(const M& index, It it, It first)
+            {
+                return const_pointer(dereference(index, it, first));
+            }
+        };
+
+        template <class K, class T>
+        struct xaxis_index_policy<xsorted_index<K, T>> : xaxis_proxy_index_policy<K, T>
+        {
+            using map_type = xsorted_index<K, T>;
+
+            template <class LL>
+            static void populate(map_type& index, const LL& labels, bool is_sorted)
+            {
+                index.build(labels, is_sorted);
+            }
+
+            template <class LL>
+            static void extend(map_type& index, const LL& labels, std::size_t /*first*/, bool is_sorted)
+            {
+                index.build(labels, is_sorted);
+            }
+
+            template <class LL>
+            static std::size_t position(const map_type& index, const LL& labels, const K& key)
+            {
+                return index.find(labels, key);
+            }
+        };
+
+        template <class K, class T>
+        struct xaxis_index_policy<xflat_hash_map<K, T>> : xaxis_proxy_index_policy<K, T>
+        {
+            using map_type = xflat_hash_map<K, T>;
+
+            template <class LL>
+            static void populate(map_type& index, const LL& labels, bool /*is_sorted*/)
+            {
+                index.clear();
+                index.reserve(labels.size());
+                for (std::size_t i = 0; i < labels.size(); ++i)
+                {
+                    index[labels[i]] = T(i);
+                }
+            }
+
+            template <class LL>
+            static void extend(map_type& index, const LL& labels, std::size_t first, bool /*is_sorted*/)
+            {
+                index.reserve(labels.size());
+                for (std::size_t i = first; i < labels.size(); ++i)
+                {
+                    index[labels[i]] = T(i);
+                }
+            }
+
+            template <class LL>
+            static std::size_t position(const map_type& index, const LL& labels, const K& key)
+            {
+                const T* pos = index.find(key);
+                return pos != nullptr ? static_cast<std::size_t>(*pos) : labels.size();
+            }
+        };
+    }
+
     /*********
      * xaxis *
      *********/
@@ -75,8 +238,9 @@ namespace xf
      * @tparam T the integer type used to represent positions. Default value is
      *           \c std::size_t.
      * @tparam MT the tag used for choosing the map type which holds the label-
-     *            position pairs. Possible values are \c map_tag and \c hash_map_tag.
-     *            Default value is \c hash_map_tag.
+     *            position pairs. Possible values are \c map_tag, \c hash_map_tag,
+     *            \c flat_hash_map_tag and \c sorted_vector_tag. Default value is
+     *            \c hash_map_tag.
      */
     template <class L, class T = std::size_t, class MT = hash_map_tag>
     class xaxis : public xaxis_base<xaxis<L, T, MT>>
@@ -89,11 +253,12 @@ namespace xf
         using label_list = typename base_type::label_list;
         using mapped_type = typename base_type::mapped_type;
         using map_type = map_container_t<key_type, mapped_type, MT>;
-        using value_type = typename map_type::value_type;
-        using reference = typename map_type::const_reference;
-        using const_reference = typename map_type::const_reference;
-        using pointer = typename map_type::const_pointer;
-        using const_pointer = typename map_type::const_pointer;
+        using index_policy = detail::xaxis_index_policy<map_type>;
+        using value_type = typename index_policy::value_type;
+        using reference = typename index_policy::const_reference;
+        using const_reference = typename index_policy::const_reference;
+        using pointer = typename index_policy::const_pointer;
+        using const_pointer = typename index_policy::const_pointer;
         using size_type = typename base_type::size_type;
         using difference_type = typename base_type::difference_type;
         using iterator = typename base_type::iterator;
@@ -109,6 +274,9 @@ namespace xf
         template <class L1>
         explicit xaxis(xaxis_default<L1, T> axis);
 
+        template <class L1>
+        explicit xaxis(const xaxis_arange<L1, T>& axis);
+
         template <class InputIt>
         xaxis(InputIt first, InputIt last);
 
@@ -152,10 +320,14 @@ namespace xf
         xaxis(const label_list& labels, bool is_sorted);
         xaxis(label_list&& labels, bool is_sorted);
 
-        typename map_type::const_iterator find_index(const key_type& key) const;
+        using label_iterator = typename label_list::const_iterator;
+
+        size_type position(const key_type& key) const;
+        const_reference dereference(label_iterator it) const;
+        const_pointer arrow(label_iterator it) const;
 
         template <class... Args>
-        bool merge_impl(const Args&... axes);
+        bool merge_impl(bool index_populated, const Args&... axes);
 
         template <class Arg1, class... Args>
         bool merge_empty(const Arg1& a, const Args&... axes);
@@ -174,6 +346,7 @@ namespace xf
 
         friend class xaxis_iterator<L, T, MT>;
         friend class xaxis_default<L, T>;
+        friend class xaxis_arange<L, T>;
     };
 
     template <class L, class T, class MT, class... Args>
@@ -368,6 +541,27 @@ namespace xf
         populate_index();
     }
 
+    /**
+     * Constructs an axis from an \c xaxis_arange. The labels of the range
+     * are materialized.
+     * @sa xaxis_arange
+     */
+    template <class L, class T, class MT>
+    template <class L1>
+    inline xaxis<L, T, MT>::xaxis(const xaxis_arange<L1, T>& axis)
+        : base_type(), m_index(), m_is_sorted(true)
+    {
+        static_assert(std::is_same<L, L1>::value, "key_type L and key_type L1 must be the same");
+
+        auto& labels = this->mutable_labels();
+        labels.reserve(axis.size());
+        for (std::size_t i = 0; i < axis.size(); ++i)
+        {
+            labels.push_back(axis.label(i));
+        }
+        populate_index();
+    }
+
     /**
      * Constructs an axis from the content of the range [first, last)
      * @param first An iterator to the first label.
@@ -403,7 +597,7 @@ namespace xf
     template <class L, class T, class MT>
     inline bool xaxis<L, T, MT>::contains(const key_type& key) const
     {
-        return m_index.count(key) != typename map_type::size_type(0);
+        return position(key) != this->size();
     }
 
     /**
@@ -414,7 +608,12 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis<L, T, MT>::operator[](const key_type& key) const -> mapped_type
     {
-        return m_index.at(key);
+        size_type pos = position(key);
+        if (pos == this->size())
+        {
+            throw std::out_of_range("invalid xaxis key");
+        }
+        return mapped_type(pos);
     }
     //@}
 
@@ -460,8 +659,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis<L, T, MT>::find(const key_type& key) const -> const_iterator
     {
-        auto map_iter = m_index.find(key);
-        return map_iter != m_index.end() ? cbegin() + map_iter->second : cend();
+        return cbegin() + static_cast<difference_type>(position(key));
     }
 
     /**
@@ -499,7 +697,7 @@ namespace xf
     template <class... Args>
     inline bool xaxis<L, T, MT>::merge(const Args&... axes)
     {
-        return this->empty() ? merge_empty(axes...) : merge_impl(axes...);
+        return this->empty() ? merge_empty(axes...) : merge_impl(true, axes...);
     }
 
     /**
@@ -529,28 +727,39 @@ namespace xf
     template <class L, class T, class MT>
     inline void xaxis<L, T, MT>::populate_index()
     {
-        for(size_type i = 0; i < this->labels().size(); ++i)
-        {
-            m_index[this->labels()[i]] = T(i);
-        }
+        XFRAME_TRACE_SCOPE(populate_index)
+        index_policy::populate(m_index, this->labels(), m_is_sorted);
     }
 
     template <class L, class T, class MT>
     void xaxis<L, T, MT>::set_labels(const label_list& labels)
     {
         this->mutable_labels() = labels;
+        m_is_sorted = init_is_sorted();
         populate_index();
     }
 
     template <class L, class T, class MT>
-    inline auto xaxis<L, T, MT>::find_index(const key_type& key) const -> typename map_type::const_iterator
+    inline auto xaxis<L, T, MT>::position(const key_type& key) const -> size_type
+    {
+        return index_policy::position(m_index, this->labels(), key);
+    }
+
+    template <class L, class T, class MT>
+    inline auto xaxis<L, T, MT>::dereference(label_iterator it) const -> const_reference
     {
-        return m_index.find(key);
+        return index_policy::dereference(m_index, it, this->labels().cbegin());
+    }
+
+    template <class L, class T, class MT>
+    inline auto xaxis<L, T, MT>::arrow(label_iterator it) const -> const_pointer
+    {
+        return index_policy::arrow(m_index, it, this->labels().cbegin());
     }
 
     template <class L, class T, class MT>
     template <class... Args>
-    inline bool xaxis<L, T, MT>::merge_impl(const Args&... axes)
+    inline bool xaxis<L, T, MT>::merge_impl(bool index_populated, const Args&... axes)
     {
         bool res = true;
         if(all_sorted(*this, axes...))
@@ -560,8 +769,10 @@ namespace xf
         }
         else
         {
+            // The index may depend on the labels being sorted
+            bool must_populate = !index_populated || m_is_sorted;
             m_is_sorted = false;
-            if (m_index.empty())
+            if (must_populate)
             {
                 populate_index();
             }
@@ -575,7 +786,8 @@ namespace xf
     inline bool xaxis<L, T, MT>::merge_empty(const Arg1& a, const Args&... axes)
     {
         this->mutable_labels() = a.labels();
-        return merge_impl(axes...);
+        m_is_sorted = a.is_sorted();
+        return merge_impl(false, axes...);
     }
 
     template <class L, class T, class MT>
@@ -628,29 +840,38 @@ namespace xf
         }
         else if(output_iter == output_end)
         {
-            std::copy(a.begin(), a.begin() + std::distance(input_iter, input_end),
-                      std::inserter(labels, labels.begin()));
+            labels.insert(labels.begin(), a.begin(), a.begin() + std::distance(input_iter, input_end));
             populate_index();
             res &= broadcasting;
         }
         else
         {
+            // The index must not be queried once the labels have been
+            // modified, missing labels are gathered before insertion.
+            label_list missing_labels;
             while(input_iter != input_end)
             {
                 if(!contains(*input_iter))
                 {
-                    if(output_iter != labels.rbegin())
-                    {
-                        labels.insert(labels.begin(), *input_iter);
-                    }
-                    else
-                    {
-                        labels.push_back(*input_iter);
-                    }
+                    missing_labels.push_back(*input_iter);
                 }
                 ++input_iter;
             }
-            populate_index();
+            if(output_iter != labels.rbegin())
+            {
+                // Missing labels are prepended in the order of the input,
+                // positions of existing labels are shifted.
+                labels.insert(labels.begin(), missing_labels.rbegin(), missing_labels.rend());
+                populate_index();
+            }
+            else
+            {
+                // Missing labels are appended, positions of existing
+                // labels are unchanged.
+                size_type old_size = labels.size();
+                labels.insert(labels.end(), missing_labels.begin(), missing_labels.end());
+                index_policy::extend(m_index, labels, old_size, m_is_sorted);
+            }
             res = false;
         }
         return res;
@@ -667,31 +888,41 @@ namespace xf
     inline bool xaxis<L, T, MT>::intersect_unsorted(const Arg& al, const Args&... axes_labels)
     {
         bool res = intersect_unsorted(axes_labels...);
+
+        xflat_hash_map<key_type, size_type> other_index;
+        other_index.reserve(al.size());
+        for (size_type i = 0; i < al.size(); ++i)
+        {
+            other_index.insert(al[i], i);
+        }
+
+        // Labels are compacted in place, keeping the order of this axis
         auto& labels = this->mutable_labels();
-        auto iter = labels.begin();
-        auto iter_end = labels.end();
-        bool must_populate = false;
-        while (iter != iter_end)
+        size_type output = 0;
+        for (size_type i = 0; i < labels.size(); ++i)
         {
-            auto it = std::find(al.begin(), al.end(), *iter);
-            if (it == al.end())
+            const size_type* pos = other_index.find(labels[i]);
+            if (pos == nullptr)
             {
-                iter = labels.erase(iter, iter + 1);
-                iter_end = labels.end();
                 res = false;
-                must_populate = true;
             }
             else
             {
-                if (it - al.begin() != iter - labels.begin())
+                if (*pos != output)
                 {
                     res = false;
                 }
-                ++iter;
+                if (output != i)
+                {
+                    labels[output] = std::move(labels[i]);
+                }
+                ++output;
             }
         }
-        if (must_populate)
+
+        if (output != labels.size())
         {
+            labels.erase(labels.begin() + static_cast<difference_type>(output), labels.end());
             populate_index();
         }
         return res;
@@ -762,13 +993,13 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_iterator<L, T, MT>::operator*() const -> reference
     {
-        return *(p_c->find_index(*m_it));
+        return p_c->dereference(m_it);
     }
 
     template <class L, class T, class MT>
     inline auto xaxis_iterator<L, T, MT>::operator->() const -> pointer
     {
-        return &(*(p_c->find_index(*m_it)));
+        return p_c->arrow(m_it);
     }
 
     template <class L, class T, class MT>
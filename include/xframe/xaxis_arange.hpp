@@ -0,0 +1,923 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XAXIS_ARANGE_HPP
+#define XFRAME_XAXIS_ARANGE_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtl/xiterator_base.hpp"
+
+#include "xaxis.hpp"
+
+namespace xf
+{
+    template <class L, class T>
+    class xaxis_arange_iterator;
+
+    /****************
+     * xaxis_arange *
+     ****************/
+
+    /**
+     * @class xaxis_arange
+     * @brief Axis holding an arithmetic progression of integral labels.
+     *
+     * The xaxis_arange class is used for modeling an axis whose labels are
+     * the arithmetic progression start, start + step, ..., start + (size - 1) * step.
+     * Only the start, the step and the size are stored: the position of a label
+     * and the label at a given position are computed, and no index is built.
+     * Merging or intersecting aligned ranges (i.e. ranges with the same step whose
+     * labels belong to the same progression) is done in constant time.
+     *
+     * The list of labels is built on demand only, when \c labels() is called;
+     * label(i) gives access to a label without building it. Once built, the
+     * list is immutable and shared by copies of the axis, so that \c labels()
+     * may be called concurrently.
+     *
+     * @tparam L the type of labels. This must be an integral type.
+     * @tparam T the integer type used to represent positions. Default value is
+     *           \c std::size_t.
+     */
+    template <class L, class T = std::size_t>
+    class xaxis_arange
+    {
+    public:
+
+        using self_type = xaxis_arange<L, T>;
+        using axis_type = xaxis<L, T>;
+        using key_type = L;
+        using mapped_type = T;
+        using label_list = std::vector<key_type>;
+        using value_type = std::pair<key_type, mapped_type>;
+        using reference = value_type&;
+        using const_reference = const value_type&;
+        using pointer = value_type*;
+        using const_pointer = const value_type*;
+        using size_type = typename label_list::size_type;
+        using difference_type = typename label_list::difference_type;
+        using iterator = xaxis_arange_iterator<L, T>;
+        using const_iterator = iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = reverse_iterator;
+
+        static_assert(std::is_integral<key_type>::value, "key_type L must be an integral type");
+        static_assert(std::is_integral<mapped_type>::value, "mapped_type T must be an integral type");
+
+        xaxis_arange();
+        xaxis_arange(key_type start, key_type step, size_type size);
+
+        xaxis_arange(const xaxis_arange& rhs);
+        xaxis_arange& operator=(const xaxis_arange& rhs);
+
+        key_type start() const noexcept;
+        key_type step() const noexcept;
+
+        const label_list& labels() const;
+        key_type label(size_type i) const noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+
+        bool is_sorted() const noexcept;
+        bool is_aligned(const self_type& rhs) const noexcept;
+
+        bool contains(const key_type& key) const noexcept;
+        mapped_type operator[](const key_type& key) const;
+
+        template <class F>
+        axis_type filter(const F& f) const noexcept;
+
+        template <class F>
+        axis_type filter(const F& f, size_type size) const noexcept;
+
+        const_iterator find(const key_type& key) const noexcept;
+
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        template <class... Args>
+        bool can_merge(const Args&... axes) const noexcept;
+
+        template <class... Args>
+        bool can_intersect(const Args&... axes) const noexcept;
+
+        template <class... Args>
+        bool merge(const Args&... axes);
+
+        template <class... Args>
+        bool intersect(const Args&... axes);
+
+    private:
+
+        key_type back_bound() const noexcept;
+        void reset(key_type start, size_type size) noexcept;
+
+        bool merge_impl() noexcept;
+        bool merge_impl(const self_type& rhs) noexcept;
+        template <class Arg, class... Args>
+        bool merge_impl(const Arg& rhs, const Args&... axes) noexcept;
+
+        void intersect_impl() noexcept;
+        void intersect_impl(const self_type& rhs) noexcept;
+        template <class Arg, class... Args>
+        void intersect_impl(const Arg& rhs, const Args&... axes) noexcept;
+
+        bool same_step() const noexcept;
+        template <class Arg, class... Args>
+        bool same_step(const Arg& rhs, const Args&... axes) const noexcept;
+
+        bool same_labels() const noexcept;
+        template <class Arg, class... Args>
+        bool same_labels(const Arg& rhs, const Args&... axes) const noexcept;
+
+        key_type m_start;
+        key_type m_step;
+        size_type m_size;
+        mutable std::shared_ptr<const label_list> p_labels;
+    };
+
+    template <class L, class T>
+    bool operator==(const xaxis_arange<L, T>& lhs, const xaxis_arange<L, T>& rhs) noexcept;
+
+    template <class L, class T>
+    bool operator!=(const xaxis_arange<L, T>& lhs, const xaxis_arange<L, T>& rhs) noexcept;
+
+    template <class OS, class L, class T>
+    OS& operator<<(OS& out, const xaxis_arange<L, T>& axis);
+
+    /************************
+     * xaxis_arange builder *
+     ************************/
+
+    template <class T = std::size_t, class L>
+    xaxis_arange<L, T> range_axis(L start, L stop, L step = 1);
+
+    /*************************
+     * xaxis_arange_iterator *
+     *************************/
+
+    template <class L, class T>
+    class xaxis_arange_iterator : public xtl::xrandom_access_iterator_base<xaxis_arange_iterator<L, T>,
+                                                                          typename xaxis_arange<L, T>::value_type,
+                                                                          typename xaxis_arange<L, T>::difference_type,
+                                                                          typename xaxis_arange<L, T>::const_pointer,
+                                                                          typename xaxis_arange<L, T>::const_reference>
+    {
+    public:
+
+        using self_type = xaxis_arange_iterator<L, T>;
+        using container_type = xaxis_arange<L, T>;
+        using key_type = typename container_type::key_type;
+        using mapped_type = typename container_type::mapped_type;
+        using value_type = typename container_type::value_type;
+        using reference = typename container_type::const_reference;
+        using pointer = typename container_type::const_pointer;
+        using difference_type = typename container_type::difference_type;
+        using iterator_category = std::random_access_iterator_tag;
+
+        xaxis_arange_iterator() = default;
+        xaxis_arange_iterator(key_type label, key_type step, mapped_type position);
+
+        self_type& operator++();
+        self_type& operator--();
+
+        self_type& operator+=(difference_type n);
+        self_type& operator-=(difference_type n);
+
+        difference_type operator-(const self_type& rhs) const;
+
+        reference operator*() const;
+        pointer operator->() const;
+
+        bool equal(const self_type& rhs) const noexcept;
+        bool less_than(const self_type& rhs) const noexcept;
+
+    private:
+
+        value_type m_value;
+        key_type m_step;
+    };
+
+    template <class L, class T>
+    typename xaxis_arange_iterator<L, T>::difference_type operator-(const xaxis_arange_iterator<L, T>& lhs, const xaxis_arange_iterator<L, T>& rhs);
+
+    template <class L, class T>
+    bool operator==(const xaxis_arange_iterator<L, T>& lhs, const xaxis_arange_iterator<L, T>& rhs) noexcept;
+
+    template <class L, class T>
+    bool operator<(const xaxis_arange_iterator<L, T>& lhs, const xaxis_arange_iterator<L, T>& rhs) noexcept;
+
+    /*******************************
+     * xaxis_arange implementation *
+     *******************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an empty range axis with a unit step.
+     */
+    template <class L, class T>
+    inline xaxis_arange<L, T>::xaxis_arange()
+        : m_start(0), m_step(1), m_size(0), p_labels()
+    {
+    }
+
+    /**
+     * Constructs a range axis holding \c size labels. The labels sequence
+     * is [start, start + step, ..., start + (size - 1) * step].
+     * @param start the first label.
+     * @param step the spacing between two consecutive labels. This must be
+     *             strictly positive.
+     * @param size the number of labels.
+     */
+    template <class L, class T>
+    inline xaxis_arange<L, T>::xaxis_arange(key_type start, key_type step, size_type size)
+        : m_start(start), m_step(step), m_size(size), p_labels()
+    {
+        if (!(key_type(0) < step))
+        {
+            throw std::runtime_error("xaxis_arange step must be strictly positive");
+        }
+    }
+
+    // The label list may be published by another thread while
+    // the axis is copied
+    template <class L, class T>
+    inline xaxis_arange<L, T>::xaxis_arange(const xaxis_arange& rhs)
+        : m_start(rhs.m_start), m_step(rhs.m_step), m_size(rhs.m_size), p_labels(std::atomic_load(&rhs.p_labels))
+    {
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::operator=(const xaxis_arange& rhs) -> xaxis_arange&
+    {
+        m_start = rhs.m_start;
+        m_step = rhs.m_step;
+        m_size = rhs.m_size;
+        std::atomic_store(&p_labels, std::atomic_load(&rhs.p_labels));
+        return *this;
+    }
+    //@}
+
+    /**
+     * @name Labels
+     */
+    //@{
+    /**
+     * Returns the first label of the range.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::start() const noexcept -> key_type
+    {
+        return m_start;
+    }
+
+    /**
+     * Returns the spacing between two consecutive labels.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::step() const noexcept -> key_type
+    {
+        return m_step;
+    }
+
+    /**
+     * Returns the list of labels contained in the axis. This list is
+     * built on the first call, prefer label(i) to access a few labels.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::labels() const -> const label_list&
+    {
+        std::shared_ptr<const label_list> res = std::atomic_load(&p_labels);
+        if (res == nullptr)
+        {
+            auto labels = std::make_shared<label_list>(m_size);
+            for (size_type i = 0; i < m_size; ++i)
+            {
+                (*labels)[i] = label(i);
+            }
+            // Threads building the list concurrently agree on the
+            // first one published
+            std::shared_ptr<const label_list> built = std::move(labels);
+            res = std::atomic_compare_exchange_strong(&p_labels, &res, built) ? built : res;
+        }
+        return *res;
+    }
+
+    /**
+     * Return the i-th label of the axis.
+     * @param i the position of the label.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::label(size_type i) const noexcept -> key_type
+    {
+        return static_cast<key_type>(m_start + static_cast<key_type>(i) * m_step);
+    }
+
+    /**
+     * Checks if the axis has no labels.
+     */
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /**
+     * Returns the number of labels in the axis.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns true if the labels list is sorted, which is always the
+     * case for a range axis.
+     */
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::is_sorted() const noexcept
+    {
+        return true;
+    }
+
+    /**
+     * Returns true if the labels of this axis and the labels of \c rhs
+     * belong to the same arithmetic progression. Empty ranges are aligned
+     * with any range.
+     * @param rhs the range to compare with.
+     */
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::is_aligned(const self_type& rhs) const noexcept
+    {
+        if (empty() || rhs.empty())
+        {
+            return true;
+        }
+        key_type offset = m_start < rhs.m_start ? key_type(rhs.m_start - m_start) : key_type(m_start - rhs.m_start);
+        return m_step == rhs.m_step && offset % m_step == 0;
+    }
+    //@}
+
+    /**
+     * @name Data
+     */
+    //@{
+    /**
+     * Returns true if the axis contains the speficied label.
+     * @param key the label to search for.
+     */
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::contains(const key_type& key) const noexcept
+    {
+        if (key < m_start)
+        {
+            return false;
+        }
+        key_type offset = static_cast<key_type>(key - m_start);
+        return offset % m_step == 0 && static_cast<size_type>(offset / m_step) < m_size;
+    }
+
+    /**
+     * Returns the position of the specified label. If this last one is
+     * not found, an exception is thrown.
+     * @param key the label to search for.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::operator[](const key_type& key) const -> mapped_type
+    {
+        if (!contains(key))
+        {
+            throw std::out_of_range("invalid xaxis_arange key");
+        }
+        return static_cast<mapped_type>((key - m_start) / m_step);
+    }
+    //@}
+
+    /**
+     * @name Filters
+     */
+    //@{
+    /**
+     * Builds an return a new axis by applying the given filter to the axis.
+     * @param f the filter used to select the labels to keep in the new axis.
+     */
+    template <class L, class T>
+    template <class F>
+    inline auto xaxis_arange<L, T>::filter(const F& f) const noexcept -> axis_type
+    {
+        label_list l;
+        for (size_type i = 0; i < m_size; ++i)
+        {
+            key_type k = label(i);
+            if (f(k))
+            {
+                l.push_back(k);
+            }
+        }
+        return axis_type(std::move(l), true);
+    }
+
+    /**
+     * Builds an return a new axis by applying the given filter to the axis. When
+     * the size of the new list of labels is known, this method allows some
+     * optimizations compared to the previous one.
+     * @param f the filter used to select the labels to keep in the new axis.
+     * @param size the size of the new label list.
+     */
+    template <class L, class T>
+    template <class F>
+    inline auto xaxis_arange<L, T>::filter(const F& f, size_type size) const noexcept -> axis_type
+    {
+        label_list l(size);
+        auto out = l.begin();
+        for (size_type i = 0; i < m_size && out != l.end(); ++i)
+        {
+            key_type k = label(i);
+            if (f(k))
+            {
+                *out++ = k;
+            }
+        }
+        return axis_type(std::move(l), true);
+    }
+    //@}
+
+    /**
+     * @name Iterators
+     */
+    //@{
+    /**
+     * Returns a constant iterator to the element with label equivalent to \c key. If
+     * no such element is found, past-the-end iterator is returned.
+     * @param key the label to search for.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::find(const key_type& key) const noexcept -> const_iterator
+    {
+        return contains(key) ? const_iterator(key, m_step, static_cast<mapped_type>((key - m_start) / m_step)) : cend();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the axis.
+     * This element is a pair label - position.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the axis.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the axis.
+     * This element is a pair label - position.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(m_start, m_step, mapped_type(0));
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the axis.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::cend() const noexcept -> const_iterator
+    {
+        return const_iterator(back_bound(), m_step, static_cast<mapped_type>(m_size));
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the reverse axis.
+     * This element is a pair label - position.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return crbegin();
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the reversed axis.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::rend() const noexcept -> const_reverse_iterator
+    {
+        return crend();
+    }
+
+    /**
+     * Returns a constant iterator to the first element of the reverse axis.
+     * This element is a pair label - position.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    /**
+     * Returns a constant iterator to the element following the last element
+     * of the reversed axis.
+     */
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cbegin());
+    }
+    //@}
+
+    /**
+     * @name Set operations
+     */
+    //@{
+    /**
+     * Returns true if the union of this axis and of the range arguments
+     * is a range that can be computed by merge, i.e. if all the ranges are
+     * aligned and there is no gap between them.
+     * @param axes the ranges to merge.
+     */
+    template <class L, class T>
+    template <class... Args>
+    inline bool xaxis_arange<L, T>::can_merge(const Args&... axes) const noexcept
+    {
+        self_type tmp(m_start, m_step, m_size);
+        return tmp.merge_impl(axes...);
+    }
+
+    /**
+     * Returns true if the intersection of this axis and of the range arguments
+     * can be computed by intersect, i.e. if all the ranges have the same step.
+     * @param axes the ranges to intersect.
+     */
+    template <class L, class T>
+    template <class... Args>
+    inline bool xaxis_arange<L, T>::can_intersect(const Args&... axes) const noexcept
+    {
+        return same_step(axes...);
+    }
+
+    /**
+     * Merges all the range arguments into this one in constant time. After this
+     * function call, the axis contains all the labels from all the arguments.
+     * If the union of the ranges is not a range, an exception is thrown and
+     * the axis is left unchanged.
+     * @param axes the ranges to merge.
+     * @return true if all the ranges hold the same labels.
+     * @sa can_merge
+     */
+    template <class L, class T>
+    template <class... Args>
+    inline bool xaxis_arange<L, T>::merge(const Args&... axes)
+    {
+        bool res = same_labels(axes...);
+        self_type tmp(m_start, m_step, m_size);
+        if (!tmp.merge_impl(axes...))
+        {
+            throw std::runtime_error("merged labels of xaxis_arange do not form a range");
+        }
+        reset(tmp.m_start, tmp.m_size);
+        m_step = tmp.m_step;
+        return res;
+    }
+
+    /**
+     * Replaces the labels with the intersection of the labels of
+     * the range arguments and the labels of this axis. This is done
+     * in constant time. If the ranges do not have the same step, an
+     * exception is thrown and the axis is left unchanged.
+     * @param axes the ranges to intersect.
+     * @return true if the intersection is equivalent to this axis.
+     * @sa can_intersect
+     */
+    template <class L, class T>
+    template <class... Args>
+    inline bool xaxis_arange<L, T>::intersect(const Args&... axes)
+    {
+        if (!can_intersect(axes...))
+        {
+            throw std::runtime_error("intersected xaxis_arange objects must have the same step");
+        }
+        size_type old_size = m_size;
+        intersect_impl(axes...);
+        return m_size == old_size;
+    }
+    //@}
+
+    template <class L, class T>
+    inline auto xaxis_arange<L, T>::back_bound() const noexcept -> key_type
+    {
+        return label(m_size);
+    }
+
+    template <class L, class T>
+    inline void xaxis_arange<L, T>::reset(key_type start, size_type size) noexcept
+    {
+        m_start = start;
+        m_size = size;
+        std::atomic_store(&p_labels, std::shared_ptr<const label_list>());
+    }
+
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::merge_impl() noexcept
+    {
+        return true;
+    }
+
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::merge_impl(const self_type& rhs) noexcept
+    {
+        if (rhs.empty())
+        {
+            return true;
+        }
+        if (empty())
+        {
+            m_start = rhs.m_start;
+            m_step = rhs.m_step;
+            m_size = rhs.m_size;
+            return true;
+        }
+        if (!is_aligned(rhs) || back_bound() < rhs.m_start || rhs.back_bound() < m_start)
+        {
+            return false;
+        }
+        key_type first = std::min(m_start, rhs.m_start);
+        key_type last = std::max(back_bound(), rhs.back_bound());
+        m_start = first;
+        m_size = static_cast<size_type>((last - first) / m_step);
+        return true;
+    }
+
+    template <class L, class T>
+    template <class Arg, class... Args>
+    inline bool xaxis_arange<L, T>::merge_impl(const Arg& rhs, const Args&... axes) noexcept
+    {
+        // Merging the ranges in the order of the arguments may create
+        // temporary gaps, so they are merged in increasing order of their start.
+        self_type self(m_start, m_step, m_size);
+        const self_type* args[] = { &self, &rhs, &axes... };
+        std::sort(std::begin(args), std::end(args),
+                  [](const self_type* a, const self_type* b) { return a->m_start < b->m_start; });
+        m_size = 0;
+        bool res = true;
+        for (const self_type* arg : args)
+        {
+            res = res && merge_impl(*arg);
+        }
+        return res;
+    }
+
+    template <class L, class T>
+    inline void xaxis_arange<L, T>::intersect_impl() noexcept
+    {
+    }
+
+    template <class L, class T>
+    inline void xaxis_arange<L, T>::intersect_impl(const self_type& rhs) noexcept
+    {
+        if (empty())
+        {
+            return;
+        }
+        if (!is_aligned(rhs))
+        {
+            reset(m_start, 0);
+            return;
+        }
+        key_type first = std::max(m_start, rhs.m_start);
+        key_type last = std::min(back_bound(), rhs.back_bound());
+        size_type size = first < last ? static_cast<size_type>((last - first) / m_step) : size_type(0);
+        reset(first, size);
+    }
+
+    template <class L, class T>
+    template <class Arg, class... Args>
+    inline void xaxis_arange<L, T>::intersect_impl(const Arg& rhs, const Args&... axes) noexcept
+    {
+        intersect_impl(rhs);
+        intersect_impl(axes...);
+    }
+
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::same_step() const noexcept
+    {
+        return true;
+    }
+
+    template <class L, class T>
+    template <class Arg, class... Args>
+    inline bool xaxis_arange<L, T>::same_step(const Arg& rhs, const Args&... axes) const noexcept
+    {
+        return (empty() || rhs.empty() || rhs.m_step == m_step) && same_step(axes...);
+    }
+
+    template <class L, class T>
+    inline bool xaxis_arange<L, T>::same_labels() const noexcept
+    {
+        return true;
+    }
+
+    template <class L, class T>
+    template <class Arg, class... Args>
+    inline bool xaxis_arange<L, T>::same_labels(const Arg& rhs, const Args&... axes) const noexcept
+    {
+        return *this == rhs && same_labels(axes...);
+    }
+
+    /**
+     * Returns true if \c lhs and \c rhs hold the same labels.
+     * @param lhs a range axis.
+     * @param rhs a range axis.
+     */
+    template <class L, class T>
+    inline bool operator==(const xaxis_arange<L, T>& lhs, const xaxis_arange<L, T>& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() &&
+            (lhs.empty() || (lhs.start() == rhs.start() && (lhs.size() == 1 || lhs.step() == rhs.step())));
+    }
+
+    /**
+     * Returns true if \c lhs and \c rhs hold different labels.
+     * @param lhs a range axis.
+     * @param rhs a range axis.
+     */
+    template <class L, class T>
+    inline bool operator!=(const xaxis_arange<L, T>& lhs, const xaxis_arange<L, T>& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    template <class OS, class L, class T>
+    inline OS& operator<<(OS& out, const xaxis_arange<L, T>& axis)
+    {
+        out << '(';
+        for (std::size_t i = 0; i < axis.size(); ++i)
+        {
+            if (i != 0)
+            {
+                out << ", ";
+            }
+            out << axis.label(i);
+        }
+        out << ')';
+        return out;
+    }
+
+    /***************************************
+     * xaxis_arange builder implementation *
+     ***************************************/
+
+    /**
+     * Returns a range axis holding the labels of [start, stop)
+     * spaced by \c step. No label is stored.
+     * @param start the first label of the range.
+     * @param stop the end of the range. The range does not contain
+     *             this value.
+     * @param step Spacing between labels. This must be strictly positive.
+     *             Default step is \c 1.
+     * @tparam T the integral type used for positions. Default value
+     *           is \c std::size_t.
+     * @tparam L the type of the labels. This must be an integral type.
+     */
+    template <class T, class L>
+    inline xaxis_arange<L, T> range_axis(L start, L stop, L step)
+    {
+        if (!(L(0) < step))
+        {
+            throw std::runtime_error("xaxis_arange step must be strictly positive");
+        }
+        std::size_t size = start < stop ? static_cast<std::size_t>((stop - start + step - 1) / step) : std::size_t(0);
+        return xaxis_arange<L, T>(start, step, size);
+    }
+
+    /****************************************
+     * xaxis_arange_iterator implementation *
+     ****************************************/
+
+    template <class L, class T>
+    inline xaxis_arange_iterator<L, T>::xaxis_arange_iterator(key_type label, key_type step, mapped_type position)
+        : m_value(label, position), m_step(step)
+    {
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange_iterator<L, T>::operator++() -> self_type&
+    {
+        m_value.first = static_cast<key_type>(m_value.first + m_step);
+        ++m_value.second;
+        return *this;
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange_iterator<L, T>::operator--() -> self_type&
+    {
+        m_value.first = static_cast<key_type>(m_value.first - m_step);
+        --m_value.second;
+        return *this;
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange_iterator<L, T>::operator+=(difference_type n) -> self_type&
+    {
+        m_value.first = static_cast<key_type>(m_value.first + static_cast<key_type>(n) * m_step);
+        m_value.second = static_cast<mapped_type>(static_cast<difference_type>(m_value.second) + n);
+        return *this;
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange_iterator<L, T>::operator-=(difference_type n) -> self_type&
+    {
+        m_value.first = static_cast<key_type>(m_value.first - static_cast<key_type>(n) * m_step);
+        m_value.second = static_cast<mapped_type>(static_cast<difference_type>(m_value.second) - n);
+        return *this;
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange_iterator<L, T>::operator-(const self_type& rhs) const -> difference_type
+    {
+        return static_cast<difference_type>(m_value.second) - static_cast<difference_type>(rhs.m_value.second);
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange_iterator<L, T>::operator*() const -> reference
+    {
+        return m_value;
+    }
+
+    template <class L, class T>
+    inline auto xaxis_arange_iterator<L, T>::operator->() const -> pointer
+    {
+        return &m_value;
+    }
+
+    template <class L, class T>
+    inline bool xaxis_arange_iterator<L, T>::equal(const self_type& rhs) const noexcept
+    {
+        return m_value.second == rhs.m_value.second;
+    }
+
+    template <class L, class T>
+    inline bool xaxis_arange_iterator<L, T>::less_than(const self_type& rhs) const noexcept
+    {
+        return m_value.second < rhs.m_value.second;
+    }
+
+    template <class L, class T>
+    inline typename xaxis_arange_iterator<L, T>::difference_type operator-(const xaxis_arange_iterator<L, T>& lhs, const xaxis_arange_iterator<L, T>& rhs)
+    {
+        return lhs.operator-(rhs);
+    }
+
+    template <class L, class T>
+    inline bool operator==(const xaxis_arange_iterator<L, T>& lhs, const xaxis_arange_iterator<L, T>& rhs) noexcept
+    {
+        return lhs.equal(rhs);
+    }
+
+    template <class L, class T>
+    inline bool operator<(const xaxis_arange_iterator<L, T>& lhs, const xaxis_arange_iterator<L, T>& rhs) noexcept
+    {
+        return lhs.less_than(rhs);
+    }
+}
+
+#endif
@@ -332,7 +332,7 @@ namespace xf
     template <class D1, class D2>
     inline bool operator==(const xaxis_base<D1>& lhs, const xaxis_base<D2>& rhs) noexcept
     {
-        return lhs.labels() == rhs.labels();
+        return static_cast<const void*>(&lhs) == static_cast<const void*>(&rhs) || lhs.labels() == rhs.labels();
     }
 
     /**
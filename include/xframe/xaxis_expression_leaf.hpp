@@ -64,6 +64,9 @@ namespace xf
         template <std::size_t N = std::numeric_limits<size_type>::max()>
         const_reference operator()(const selector_sequence_type<N>& selector) const;
 
+        const name_type& name() const noexcept;
+        const_reference label(size_type i) const;
+
     private:
 
         xaxis_closure_t<CTA> m_named_axis;
@@ -101,6 +104,25 @@ namespace xf
         }
         throw std::runtime_error(std::string("Missing label for axis ") + std::string(m_named_axis.name()));
     }
+
+    /**
+     * Returns the name of the underlying xnamed_axis.
+     */
+    template <class CTA>
+    inline auto xaxis_expression_leaf<CTA>::name() const noexcept -> const name_type&
+    {
+        return m_named_axis.name();
+    }
+
+    /**
+     * Returns the label of the underlying xnamed_axis at position \c i.
+     * @param i the position of the label.
+     */
+    template <class CTA>
+    inline auto xaxis_expression_leaf<CTA>::label(size_type i) const -> const_reference
+    {
+        return m_named_axis.label(i);
+    }
 }
 
 #endif
@@ -11,8 +11,21 @@
 #ifndef XFRAME_XAXIS_FUNCTION_HPP
 #define XFRAME_XAXIS_FUNCTION_HPP
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
 #include "xtensor/xoptional.hpp"
 #include "xtensor/xgenerator.hpp"
+#include "xtensor/xutils.hpp"
 
 #include "xframe_expression.hpp"
 #include "xframe_utils.hpp"
@@ -65,6 +78,9 @@ namespace xf
         template <std::size_t N = dynamic()>
         const_reference operator()(const selector_sequence_type<N>& selector) const;
 
+        const std::tuple<xaxis_expression_closure_t<CT>...>& arguments() const noexcept;
+        const functor_type& functor() const noexcept;
+
     private:
 
         template <std::size_t N, std::size_t... I>
@@ -126,12 +142,137 @@ namespace xf
 #endif
     }
 
+    /**
+     * Returns the arguments of the xaxis_function.
+     */
+    template <class F, class R, class... CT>
+    inline auto xaxis_function<F, R, CT...>::arguments() const noexcept -> const std::tuple<xaxis_expression_closure_t<CT>...>&
+    {
+        return m_e;
+    }
+
+    /**
+     * Returns the functor applied to the arguments of the xaxis_function.
+     */
+    template <class F, class R, class... CT>
+    inline auto xaxis_function<F, R, CT...>::functor() const noexcept -> const functor_type&
+    {
+        return m_f;
+    }
+
     /**********************
      * axis_function_mask *
      **********************/
 
     namespace detail
     {
+        // Dimension an axis expression depends on: a position in the dimension
+        // mapping, mask_no_dimension for constant expressions or
+        // mask_many_dimensions for expressions of several dimensions
+        constexpr std::size_t mask_no_dimension = std::numeric_limits<std::size_t>::max();
+        constexpr std::size_t mask_many_dimensions = mask_no_dimension - 1;
+
+        template <class CTA, class DM>
+        std::size_t mask_dimension(const xaxis_expression_leaf<CTA>& e, const DM& dim_mapping);
+
+        template <class CT, class DM>
+        std::size_t mask_dimension(const xaxis_scalar<CT>& e, const DM& dim_mapping) noexcept;
+
+        template <class F, class R, class... CT, class DM>
+        std::size_t mask_dimension(const xaxis_function<F, R, CT...>& e, const DM& dim_mapping);
+
+        template <class T>
+        using xmask_table_t = std::vector<std::conditional_t<std::is_same<T, bool>::value, std::uint8_t, T>>;
+
+        /**
+         * Evaluation of an axis expression on the positions of a variable.
+         * Subexpressions depending on a single dimension are evaluated once
+         * per label of this dimension and stored in a table, so that
+         * evaluating the mask at a given position only requires to read
+         * these tables and to combine them.
+         */
+        template <class E>
+        class xaxis_mask_node;
+
+        template <class CTA>
+        class xaxis_mask_node<xaxis_expression_leaf<CTA>>
+        {
+        public:
+
+            using expression_type = xaxis_expression_leaf<CTA>;
+            using value_type = std::decay_t<typename expression_type::value_type>;
+
+            template <class DM, class S>
+            void init(const expression_type& e, const DM& dim_mapping, const S& shape);
+
+            template <class It>
+            value_type evaluate(It index) const;
+
+        private:
+
+            xmask_table_t<value_type> m_table;
+            std::size_t m_dimension = 0;
+        };
+
+        template <class CT>
+        class xaxis_mask_node<xaxis_scalar<CT>>
+        {
+        public:
+
+            using expression_type = xaxis_scalar<CT>;
+            using value_type = std::decay_t<typename expression_type::value_type>;
+
+            template <class DM, class S>
+            void init(const expression_type& e, const DM& dim_mapping, const S& shape);
+
+            template <class It>
+            value_type evaluate(It index) const;
+
+        private:
+
+            value_type m_value;
+        };
+
+        template <class F, class R, class... CT>
+        class xaxis_mask_node<xaxis_function<F, R, CT...>>
+        {
+        public:
+
+            using expression_type = xaxis_function<F, R, CT...>;
+            using functor_type = typename expression_type::functor_type;
+            using value_type = R;
+
+            template <class DM, class S>
+            void init(const expression_type& e, const DM& dim_mapping, const S& shape);
+
+            template <class It>
+            value_type evaluate(It index) const;
+
+        private:
+
+            using argument_nodes = std::tuple<xaxis_mask_node<std::decay_t<xaxis_expression_closure_t<CT>>>...>;
+
+            template <std::size_t I, class DM, class S>
+            std::enable_if_t<(I < sizeof...(CT))> init_arguments(const expression_type& e, const DM& dim_mapping, const S& shape);
+
+            template <std::size_t I, class DM, class S>
+            std::enable_if_t<(I == sizeof...(CT))> init_arguments(const expression_type& e, const DM& dim_mapping, const S& shape);
+
+            template <std::size_t... I, class It>
+            value_type evaluate_arguments(std::index_sequence<I...>, It index) const;
+
+            argument_nodes m_arguments;
+            std::shared_ptr<const functor_type> p_functor;
+            xmask_table_t<value_type> m_table;
+            std::size_t m_dimension = mask_no_dimension;
+        };
+
+        /**
+         * Generator of the mask of an xvariable_masked_view. The axis expression
+         * is evaluated once per label of the dimensions it depends on when the
+         * mask is built; separable expressions such as
+         * `axis1 < 5 && not_equal(axis2, 'i')` never look up labels afterwards.
+         */
         template <class AF, class DM>
         class axis_function_mask_impl
         {
@@ -143,61 +284,193 @@ namespace xf
             using name_type = typename axis_function_type::name_type;
             using size_type = typename axis_function_type::size_type;
 
-            template <std::size_t N = dynamic()>
-            using selector_sequence_type = detail::xselector_sequence_t<std::pair<name_type, size_type>, N>;
+            template <class S>
+            axis_function_mask_impl(AF&& axis_function, DM&& dim_mapping, const S& shape);
+
+            template <class... Args>
+            value_type operator()(Args... args) const;
+
+            template <class It>
+            value_type element(It first, It last) const;
+
+        private:
+
+            xaxis_mask_node<std::decay_t<AF>> m_node;
+        };
+
+        /*************************************
+         * axis_function_mask implementation *
+         *************************************/
 
-            axis_function_mask_impl(AF&& axis_function, DM&& dim_mapping)
-                : m_axis_function(std::forward<AF>(axis_function)),
-                  m_dimension_mapping(std::forward<DM>(dim_mapping))
+        inline std::size_t combine_mask_dimensions(std::size_t lhs, std::size_t rhs) noexcept
+        {
+            if (lhs == mask_no_dimension)
             {
+                return rhs;
             }
+            return rhs == mask_no_dimension || rhs == lhs ? lhs : mask_many_dimensions;
+        }
 
-            template <class... Args>
-            inline value_type operator()(Args... args) const
+        template <class CTA, class DM>
+        inline std::size_t mask_dimension(const xaxis_expression_leaf<CTA>& e, const DM& dim_mapping)
+        {
+            if (!dim_mapping.contains(e.name()))
             {
-                auto selector = make_selector(std::make_index_sequence<sizeof...(Args)>(), args...);
-#ifdef _MSC_VER
-                return m_axis_function.operator()<sizeof...(Args)>(selector);
-#else
-                return m_axis_function.template operator()<sizeof...(Args)>(selector);
-#endif
+                throw std::runtime_error(std::string("Missing label for axis ") + std::string(e.name()));
             }
+            return static_cast<std::size_t>(dim_mapping[e.name()]);
+        }
 
-            template <class It>
-            inline value_type element(It first, It last) const
+        template <class CT, class DM>
+        inline std::size_t mask_dimension(const xaxis_scalar<CT>& /*e*/, const DM& /*dim_mapping*/) noexcept
+        {
+            return mask_no_dimension;
+        }
+
+        template <class F, class R, class... CT, class DM>
+        inline std::size_t mask_dimension(const xaxis_function<F, R, CT...>& e, const DM& dim_mapping)
+        {
+            auto func = [&dim_mapping](std::size_t res, const auto& arg) {
+                return combine_mask_dimensions(res, mask_dimension(arg, dim_mapping));
+            };
+            return xt::accumulate(func, mask_no_dimension, e.arguments());
+        }
+
+        template <class It>
+        inline std::size_t mask_index(It index, std::size_t dimension)
+        {
+            std::advance(index, static_cast<typename std::iterator_traits<It>::difference_type>(dimension));
+            return static_cast<std::size_t>(*index);
+        }
+
+        template <class CTA>
+        template <class DM, class S>
+        inline void xaxis_mask_node<xaxis_expression_leaf<CTA>>::init(const expression_type& e, const DM& dim_mapping, const S& shape)
+        {
+            using size_type = typename expression_type::size_type;
+            m_dimension = mask_dimension(e, dim_mapping);
+            std::size_t size = static_cast<std::size_t>(shape[m_dimension]);
+            m_table.reserve(size);
+            for (std::size_t i = 0; i < size; ++i)
             {
-                // TODO avoid dynamic allocation
-                auto selector = selector_sequence_type<dynamic()>();
-                std::size_t i = 0;
-                for (It it = first; it != last; ++it)
-                {
-                    selector.push_back(std::make_pair(m_dimension_mapping.label(i++), static_cast<size_type>(*it)));
-                }
-#ifdef _MSC_VER
-                return m_axis_function.operator()<dynamic()>(selector);
-#else
-                return m_axis_function.template operator()<dynamic()>(selector);
-#endif
+                m_table.push_back(e.label(static_cast<size_type>(i)));
             }
+        }
 
-        private:
+        template <class CTA>
+        template <class It>
+        inline auto xaxis_mask_node<xaxis_expression_leaf<CTA>>::evaluate(It index) const -> value_type
+        {
+            return m_table[mask_index(index, m_dimension)];
+        }
 
-            AF m_axis_function;
-            DM m_dimension_mapping;
+        template <class CT>
+        template <class DM, class S>
+        inline void xaxis_mask_node<xaxis_scalar<CT>>::init(const expression_type& e, const DM& /*dim_mapping*/, const S& /*shape*/)
+        {
+            m_value = e(xselector_sequence_t<std::pair<xaxis_scalar_name, std::size_t>, dynamic()>());
+        }
 
-            template <class... Args, std::size_t... I>
-            inline selector_sequence_type<sizeof...(Args)> make_selector(std::index_sequence<I...>, Args&&... args) const
+        template <class CT>
+        template <class It>
+        inline auto xaxis_mask_node<xaxis_scalar<CT>>::evaluate(It /*index*/) const -> value_type
+        {
+            return m_value;
+        }
+
+        template <class F, class R, class... CT>
+        template <class DM, class S>
+        inline void xaxis_mask_node<xaxis_function<F, R, CT...>>::init(const expression_type& e, const DM& dim_mapping, const S& shape)
+        {
+            using selector_type = typename expression_type::template selector_sequence_type<>;
+            using size_type = typename expression_type::size_type;
+
+            m_dimension = mask_dimension(e, dim_mapping);
+            if (m_dimension == mask_many_dimensions)
             {
-                return {std::make_pair(m_dimension_mapping.label(I), static_cast<size_type>(args))...};
+                p_functor = std::make_shared<const functor_type>(e.functor());
+                init_arguments<0>(e, dim_mapping, shape);
             }
-        };
+            else if (m_dimension == mask_no_dimension)
+            {
+                m_table.push_back(e(selector_type()));
+            }
+            else
+            {
+                std::size_t size = static_cast<std::size_t>(shape[m_dimension]);
+                selector_type selector = { std::make_pair(dim_mapping.label(m_dimension), size_type(0)) };
+                m_table.reserve(size);
+                for (std::size_t i = 0; i < size; ++i)
+                {
+                    selector[0].second = static_cast<size_type>(i);
+                    m_table.push_back(e(selector));
+                }
+            }
+        }
+
+        template <class F, class R, class... CT>
+        template <class It>
+        inline auto xaxis_mask_node<xaxis_function<F, R, CT...>>::evaluate(It index) const -> value_type
+        {
+            if (m_dimension == mask_many_dimensions)
+            {
+                return evaluate_arguments(std::make_index_sequence<sizeof...(CT)>(), index);
+            }
+            return m_table[m_dimension == mask_no_dimension ? std::size_t(0) : mask_index(index, m_dimension)];
+        }
+
+        template <class F, class R, class... CT>
+        template <std::size_t I, class DM, class S>
+        inline std::enable_if_t<(I < sizeof...(CT))>
+        xaxis_mask_node<xaxis_function<F, R, CT...>>::init_arguments(const expression_type& e, const DM& dim_mapping, const S& shape)
+        {
+            std::get<I>(m_arguments).init(std::get<I>(e.arguments()), dim_mapping, shape);
+            init_arguments<I + 1>(e, dim_mapping, shape);
+        }
+
+        template <class F, class R, class... CT>
+        template <std::size_t I, class DM, class S>
+        inline std::enable_if_t<(I == sizeof...(CT))>
+        xaxis_mask_node<xaxis_function<F, R, CT...>>::init_arguments(const expression_type& /*e*/, const DM& /*dim_mapping*/, const S& /*shape*/)
+        {
+        }
+
+        template <class F, class R, class... CT>
+        template <std::size_t... I, class It>
+        inline auto xaxis_mask_node<xaxis_function<F, R, CT...>>::evaluate_arguments(std::index_sequence<I...>, It index) const -> value_type
+        {
+            return (*p_functor)(std::get<I>(m_arguments).evaluate(index)...);
+        }
+
+        template <class AF, class DM>
+        template <class S>
+        inline axis_function_mask_impl<AF, DM>::axis_function_mask_impl(AF&& axis_function, DM&& dim_mapping, const S& shape)
+            : m_node()
+        {
+            m_node.init(axis_function, dim_mapping, shape);
+        }
+
+        template <class AF, class DM>
+        template <class... Args>
+        inline auto axis_function_mask_impl<AF, DM>::operator()(Args... args) const -> value_type
+        {
+            std::array<std::size_t, sizeof...(Args)> index = { static_cast<std::size_t>(args)... };
+            return m_node.evaluate(index.cbegin());
+        }
+
+        template <class AF, class DM>
+        template <class It>
+        inline auto axis_function_mask_impl<AF, DM>::element(It first, It /*last*/) const -> value_type
+        {
+            return m_node.evaluate(first);
+        }
     }
 
     template <class AF, class DM, class S>
-    inline auto axis_function_mask(AF&& axis_function, DM&& dim_mapping, const S& shape) noexcept
+    inline auto axis_function_mask(AF&& axis_function, DM&& dim_mapping, const S& shape)
     {
         return xt::detail::make_xgenerator(
-            detail::axis_function_mask_impl<AF, DM>(std::forward<AF>(axis_function), std::forward<DM>(dim_mapping)),
+            detail::axis_function_mask_impl<AF, DM>(std::forward<AF>(axis_function), std::forward<DM>(dim_mapping), shape),
             shape
         );
     }
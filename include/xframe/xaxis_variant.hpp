@@ -11,12 +11,17 @@
 #ifndef XFRAME_XAXIS_VARIANT_HPP
 #define XFRAME_XAXIS_VARIANT_HPP
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
+#include <memory>
+#include <stdexcept>
 #include "xtl/xclosure.hpp"
 #include "xtl/xmeta_utils.hpp"
 #include "xtl/xvariant.hpp"
 #include "xaxis.hpp"
 #include "xaxis_default.hpp"
+#include "xaxis_arange.hpp"
 #include "xvector_variant.hpp"
 
 namespace xf
@@ -24,25 +29,31 @@ namespace xf
 
     namespace detail
     {
+        inline std::uint64_t new_axis_stamp() noexcept
+        {
+            static std::atomic<std::uint64_t> counter(0);
+            return ++counter;
+        }
+
         template <class V, class S, class... L>
-        struct add_default_axis;
+        struct add_integral_axes;
 
         template <class... A, class S>
-        struct add_default_axis<xtl::variant<A...>, S>
+        struct add_integral_axes<xtl::variant<A...>, S>
         {
             using type = xtl::variant<A...>;
         };
 
         template <class... A, class S, class L1, class... L>
-        struct add_default_axis<xtl::variant<A...>, S, L1, L...>
+        struct add_integral_axes<xtl::variant<A...>, S, L1, L...>
         {
             using type = typename xtl::mpl::if_t<std::is_integral<L1>,
-                add_default_axis<xtl::variant<A..., xaxis_default<L1, S>>, S, L...>,
-                add_default_axis<xtl::variant<A...>, S, L...>>::type;
+                add_integral_axes<xtl::variant<A..., xaxis_default<L1, S>, xaxis_arange<L1, S>>, S, L...>,
+                add_integral_axes<xtl::variant<A...>, S, L...>>::type;
         };
 
         template <class V, class S, class... L>
-        using add_default_axis_t = typename add_default_axis<V, S, L...>::type;
+        using add_integral_axes_t = typename add_integral_axes<V, S, L...>::type;
 
         template <class V>
         struct get_axis_variant_iterator;
@@ -63,14 +74,14 @@ namespace xf
         struct xaxis_variant_traits<S, MT, TL<L...>>
         {
             using tmp_storage_type = xtl::variant<xaxis<L, S, MT>...>;
-            using storage_type = add_default_axis_t<tmp_storage_type, S, L...>;
+            using storage_type = add_integral_axes_t<tmp_storage_type, S, L...>;
             using label_list = xvector_variant_cref<std::vector<L>...>;
             using key_type = xtl::variant<typename xaxis<L, S, MT>::key_type...>;
             using key_reference = xtl::variant<xtl::xclosure_wrapper<const typename xaxis<L, S, MT>::key_type&>...>;
             using mapped_type = S;
             using value_type = std::pair<key_type, mapped_type>;
             using reference = std::pair<key_reference, mapped_type&>;
-            using const_reference = std::pair<key_reference, const mapped_type&>;
+            using const_reference = std::pair<key_reference, mapped_type>;
             using pointer = xtl::xclosure_pointer<reference>;
             using const_pointer = xtl::xclosure_pointer<const_reference>;
             using size_type = typename label_list::size_type;
@@ -95,11 +106,16 @@ namespace xf
      * required to access the underlying axis. This allows to store axes with
      * different label types in a coordinate system.
      *
+     * Copies of an xaxis_variant share the underlying axis, which makes copying
+     * coordinates cheap. The axis is copied only when merge or intersect modifies
+     * an xaxis_variant whose labels are shared with other copies.
+     *
      * @tparam L the type list of labels
      * @tparam T the integer type used to represent positions.
      * @tparam MT the tag used for choosing the map type which holds the label-
-     *            position pairs. Possible values are \c map_tag and \c hash_map_tag.
-     *            Default value is \c hash_map_tag.
+     *            position pairs. Possible values are \c map_tag, \c hash_map_tag,
+     *            \c flat_hash_map_tag and \c sorted_vector_tag. Default value is
+     *            \c hash_map_tag.
      */
     template <class L, class T, class MT = hash_map_tag>
     class xaxis_variant
@@ -129,7 +145,7 @@ namespace xf
         using const_reverse_iterator = std::reverse_iterator<const_iterator>;
         using subiterator = typename traits_type::subiterator;
 
-        xaxis_variant() = default;
+        xaxis_variant();
         template <class LB>
         xaxis_variant(const xaxis<LB, T, MT>& axis);
         template <class LB>
@@ -138,6 +154,13 @@ namespace xf
         xaxis_variant(const xaxis_default<LB, T>& axis);
         template <class LB>
         xaxis_variant(xaxis_default<LB, T>&& axis);
+        template <class LB>
+        xaxis_variant(const xaxis_arange<LB, T>& axis);
+        template <class LB>
+        xaxis_variant(xaxis_arange<LB, T>&& axis);
+
+        xaxis_variant(const xaxis_variant&) = default;
+        xaxis_variant& operator=(const xaxis_variant&) = default;
 
         label_list labels() const;
         key_type label(size_type i) const;
@@ -147,6 +170,8 @@ namespace xf
 
         bool is_sorted() const noexcept;
 
+        std::uint64_t stamp() const noexcept;
+
         bool contains(const key_type& key) const;
         mapped_type operator[](const key_type& key) const;
 
@@ -183,7 +208,71 @@ namespace xf
 
     private:
 
-        storage_type m_data;
+        const storage_type& storage() const noexcept;
+        void detach();
+        void materialize_range();
+
+        bool shares_labels() const noexcept;
+        template <class A, class... Args>
+        bool shares_labels(const A& axis, const Args&... axes) const noexcept;
+
+        template <class A>
+        static const void* storage_address(const A& axis) noexcept;
+        static const void* storage_address(const self_type& axis) noexcept;
+
+        template <class F, class A, class... Args>
+        static bool range_operation(F& f, A& arg, const Args&... axes);
+
+        template <class F, class K, class... Args>
+        static bool range_operation(F& f, xaxis_arange<K, T>& arg, const Args&... axes);
+
+        template <class R>
+        static bool hold_range() noexcept;
+
+        template <class R, class... Args>
+        static bool hold_range(const self_type& axis, const Args&... axes) noexcept;
+
+        template <class A, class... Args>
+        static bool merge_axis(A& arg, const Args&... axes);
+
+        template <class K, class... Args>
+        static bool merge_axis(xaxis_arange<K, T>& arg, const Args&... axes);
+
+        template <class A, class... Args>
+        static bool intersect_axis(A& arg, const Args&... axes);
+
+        template <class K, class... Args>
+        static bool intersect_axis(xaxis_arange<K, T>& arg, const Args&... axes);
+
+        template <class A>
+        static bool is_range(const A& arg) noexcept;
+
+        template <class K>
+        static bool is_range(const xaxis_arange<K, T>& arg) noexcept;
+
+        template <class A>
+        static bool is_default(const A& arg) noexcept;
+
+        template <class K>
+        static bool is_default(const xaxis_default<K, T>& arg) noexcept;
+
+        template <class A>
+        static self_type as_xaxis_impl(const A& arg);
+
+        template <class A>
+        static bool same_labels(const A& lhs, const A& rhs);
+
+        template <class A1, class A2>
+        static bool same_labels(const A1& lhs, const A2& rhs);
+
+        template <class A1, class A2>
+        static bool same_labels_impl(const A1& lhs, const A2& rhs, std::true_type);
+
+        template <class A1, class A2>
+        static bool same_labels_impl(const A1& lhs, const A2& rhs, std::false_type) noexcept;
+
+        std::shared_ptr<storage_type> p_data;
+        std::uint64_t m_stamp = detail::new_axis_stamp();
 
         template <class OS, class L1, class T1, class MT1>
         friend OS& operator<<(OS&, const xaxis_variant<L1, T1, MT1>&);
@@ -255,6 +344,15 @@ namespace xf
      * @name Constructors
      */
     //@{
+    /**
+     * Constructs an empty xaxis_variant.
+     */
+    template <class L, class T, class MT>
+    inline xaxis_variant<L, T, MT>::xaxis_variant()
+        : p_data(std::make_shared<storage_type>())
+    {
+    }
+
     /**
      * Constructs an xaxis_variant from the specified xaxis. This latter is copied
      * in the variant.
@@ -264,7 +362,7 @@ namespace xf
     template <class L, class T, class MT>
     template <class LB>
     inline xaxis_variant<L, T, MT>::xaxis_variant(const xaxis<LB, T, MT>& axis)
-        : m_data(axis)
+        : p_data(std::make_shared<storage_type>(axis))
     {
     }
 
@@ -277,7 +375,7 @@ namespace xf
     template <class L, class T, class MT>
     template <class LB>
     inline xaxis_variant<L, T, MT>::xaxis_variant(xaxis<LB, T, MT>&& axis)
-        : m_data(std::move(axis))
+        : p_data(std::make_shared<storage_type>(std::move(axis)))
     {
     }
 
@@ -290,7 +388,7 @@ namespace xf
     template <class L, class T, class MT>
     template <class LB>
     inline xaxis_variant<L, T, MT>::xaxis_variant(const xaxis_default<LB, T>& axis)
-        : m_data(axis)
+        : p_data(std::make_shared<storage_type>(axis))
     {
     }
 
@@ -303,7 +401,33 @@ namespace xf
     template <class L, class T, class MT>
     template <class LB>
     inline xaxis_variant<L, T, MT>::xaxis_variant(xaxis_default<LB, T>&& axis)
-        : m_data(std::move(axis))
+        : p_data(std::make_shared<storage_type>(std::move(axis)))
+    {
+    }
+
+    /**
+     * Constructs an xaxis_variant from the specified xaxis_arange. This latter is
+     * copied in the variant.
+     * @tparam LB the label type of the axis argument.
+     * @param axis the axis to copy in the variant.
+     */
+    template <class L, class T, class MT>
+    template <class LB>
+    inline xaxis_variant<L, T, MT>::xaxis_variant(const xaxis_arange<LB, T>& axis)
+        : p_data(std::make_shared<storage_type>(axis))
+    {
+    }
+
+    /**
+     * Constructs an xaxis_variant from the specified xaxis_arange. This latter
+     * is moved in the variant.
+     * @tparam LB the label type of the axis argument.
+     * @param axis the axis to move in the variant.
+     */
+    template <class L, class T, class MT>
+    template <class LB>
+    inline xaxis_variant<L, T, MT>::xaxis_variant(xaxis_arange<LB, T>&& axis)
+        : p_data(std::make_shared<storage_type>(std::move(axis)))
     {
     }
 
@@ -319,7 +443,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::labels() const -> label_list
     {
-        return xtl::visit([](auto&& arg) -> label_list { return arg.labels(); }, m_data);
+        return xtl::visit([](auto&& arg) -> label_list { return arg.labels(); }, storage());
     };
 
     /**
@@ -329,7 +453,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::label(size_type i) const -> key_type
     {
-        return xtl::visit([i](auto&& arg) -> key_type { return arg.labels()[i]; }, m_data);
+        return xtl::visit([i](auto&& arg) -> key_type { return arg.label(i); }, storage());
     }
 
     /**
@@ -338,7 +462,7 @@ namespace xf
     template <class L, class T, class MT>
     inline bool xaxis_variant<L, T, MT>::empty() const
     {
-        return xtl::visit([](auto&& arg) { return arg.empty(); }, m_data);
+        return xtl::visit([](auto&& arg) { return arg.empty(); }, storage());
     }
 
     /**
@@ -347,7 +471,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::size() const -> size_type
     {
-        return xtl::visit([](auto&& arg) { return arg.size(); }, m_data);
+        return xtl::visit([](auto&& arg) { return arg.size(); }, storage());
     }
 
     /**
@@ -356,7 +480,18 @@ namespace xf
     template <class L, class T, class MT>
     inline bool xaxis_variant<L, T, MT>::is_sorted() const noexcept
     {
-        return xtl::visit([](auto&& arg) { return arg.is_sorted(); }, m_data);
+        return xtl::visit([](auto&& arg) { return arg.is_sorted(); }, storage());
+    }
+
+    /**
+     * Returns an identifier of the labels held by the axis. Copies of an axis
+     * share its stamp, while merging or intersecting an axis gives it a new one;
+     * two axes with the same stamp therefore hold the same labels.
+     */
+    template <class L, class T, class MT>
+    inline std::uint64_t xaxis_variant<L, T, MT>::stamp() const noexcept
+    {
+        return m_stamp;
     }
     //@}
 
@@ -376,7 +511,7 @@ namespace xf
             using type = typename std::decay_t<decltype(arg)>::key_type;
             return arg.contains(xtl::get<type>(key));
         };
-        return xtl::visit(lambda, m_data);
+        return xtl::visit(lambda, storage());
     }
 
     /**
@@ -392,7 +527,7 @@ namespace xf
             using type = typename std::decay_t<decltype(arg)>::key_type;
             return arg[xtl::get<type>(key)];
         };
-        return xtl::visit(lambda, m_data);
+        return xtl::visit(lambda, storage());
     }
     //@}
 
@@ -408,7 +543,7 @@ namespace xf
     template <class F>
     inline auto xaxis_variant<L, T, MT>::filter(const F& f) const -> self_type
     {
-        return xtl::visit([&f](const auto& arg) { return self_type(arg.filter(f)); }, m_data);
+        return xtl::visit([&f](const auto& arg) { return self_type(arg.filter(f)); }, storage());
     }
 
     /**
@@ -422,7 +557,7 @@ namespace xf
     template <class F>
     inline auto xaxis_variant<L, T, MT>::filter(const F& f, size_type size) const -> self_type
     {
-        return xtl::visit([&f, size](const auto& arg) { return self_type(arg.filter(f, size)); }, m_data);
+        return xtl::visit([&f, size](const auto& arg) { return self_type(arg.filter(f, size)); }, storage());
     }
     //@}
 
@@ -443,7 +578,7 @@ namespace xf
             using type = typename std::decay_t<decltype(arg)>::key_type;
             return subiterator(arg.find(xtl::get<type>(key)));
         };
-        return xtl::visit(lambda, m_data);
+        return xtl::visit(lambda, storage());
     }
 
     /**
@@ -473,7 +608,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::cbegin() const -> const_iterator
     {
-        return xtl::visit([](auto&& arg) { return subiterator(arg.cbegin()); }, m_data);
+        return xtl::visit([](auto&& arg) { return subiterator(arg.cbegin()); }, storage());
     }
 
     /**
@@ -483,7 +618,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::cend() const -> const_iterator
     {
-        return xtl::visit([](auto&& arg) { return subiterator(arg.cend()); }, m_data);
+        return xtl::visit([](auto&& arg) { return subiterator(arg.cend()); }, storage());
     }
 
     /**
@@ -513,7 +648,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::crbegin() const -> const_reverse_iterator
     {
-        return xtl::visit([](auto&& arg) { return subiterator(arg.cend()); }, m_data);
+        return xtl::visit([](auto&& arg) { return subiterator(arg.cend()); }, storage());
     }
 
     /**
@@ -523,7 +658,7 @@ namespace xf
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::crend() const -> const_reverse_iterator
     {
-        return xtl::visit([](auto&& arg) { return subiterator(arg.cbegin()); }, m_data);
+        return xtl::visit([](auto&& arg) { return subiterator(arg.cbegin()); }, storage());
     }
     //@}
 
@@ -569,12 +704,37 @@ namespace xf
     template <class... Args>
     inline bool xaxis_variant<L, T, MT>::merge(const Args&... axes)
     {
-        auto lambda = [&axes...](auto&& arg) -> bool
+        if (shares_labels(axes...))
+        {
+            return true;
+        }
+        detach();
+        bool res = true;
+        auto range_merge = [&res](auto& arg, const auto&... ranges) -> bool
         {
-            using key_type = typename std::decay_t<decltype(arg)>::key_type;
-            return arg.merge(xaxis_variant_adaptor<L, T, MT, key_type>(axes)...);
+            bool can_merge = arg.can_merge(ranges...);
+            if (can_merge)
+            {
+                res = arg.merge(ranges...);
+            }
+            return can_merge;
         };
-        return xtl::visit(lambda, m_data);
+        auto range_lambda = [&range_merge, &axes...](auto& arg) -> bool
+        {
+            return self_type::range_operation(range_merge, arg, axes...);
+        };
+        if (!xtl::visit(range_lambda, *p_data))
+        {
+            materialize_range();
+            auto lambda = [&axes...](auto&& arg) -> bool
+            {
+                using key_type = typename std::decay_t<decltype(arg)>::key_type;
+                return self_type::merge_axis(arg, xaxis_variant_adaptor<L, T, MT, key_type>(axes)...);
+            };
+            res = xtl::visit(lambda, *p_data);
+        }
+        m_stamp = detail::new_axis_stamp();
+        return res;
     }
 
     /**
@@ -587,30 +747,261 @@ namespace xf
     template <class... Args>
     inline bool xaxis_variant<L, T, MT>::intersect(const Args&... axes)
     {
-        auto lambda = [&axes...](auto&& arg) -> bool
+        if (shares_labels(axes...))
         {
-            using key_type = typename std::decay_t<decltype(arg)>::key_type;
-            return arg.intersect(xaxis_variant_adaptor<L, T, MT, key_type>(axes)...);
+            return true;
+        }
+        detach();
+        bool res = true;
+        auto range_intersect = [&res](auto& arg, const auto&... ranges) -> bool
+        {
+            bool can_intersect = arg.can_intersect(ranges...);
+            if (can_intersect)
+            {
+                res = arg.intersect(ranges...);
+            }
+            return can_intersect;
         };
-        return xtl::visit(lambda, m_data);
+        auto range_lambda = [&range_intersect, &axes...](auto& arg) -> bool
+        {
+            return self_type::range_operation(range_intersect, arg, axes...);
+        };
+        if (!xtl::visit(range_lambda, *p_data))
+        {
+            materialize_range();
+            auto lambda = [&axes...](auto&& arg) -> bool
+            {
+                using key_type = typename std::decay_t<decltype(arg)>::key_type;
+                return self_type::intersect_axis(arg, xaxis_variant_adaptor<L, T, MT, key_type>(axes)...);
+            };
+            res = xtl::visit(lambda, *p_data);
+        }
+        m_stamp = detail::new_axis_stamp();
+        return res;
     }
     //@}
 
+    /**
+     * Returns an axis supporting set operations and holding the same labels
+     * as this axis. Default axes are converted into xaxis, other axes share
+     * their labels with the returned axis.
+     */
     template <class L, class T, class MT>
     inline auto xaxis_variant<L, T, MT>::as_xaxis() const -> self_type
     {
-        return xtl::visit([](auto&& arg) { return self_type(xaxis<typename std::decay_t<decltype(arg)>::key_type, T, MT>(arg)); }, m_data);
+        if (xtl::visit([](const auto& arg) { return self_type::is_default(arg); }, storage()))
+        {
+            return xtl::visit([](const auto& arg) { return self_type::as_xaxis_impl(arg); }, storage());
+        }
+        return *this;
+    }
+
+    template <class L, class T, class MT>
+    inline auto xaxis_variant<L, T, MT>::storage() const noexcept -> const storage_type&
+    {
+        return *p_data;
+    }
+
+    // Labels are shared between copies of an axis and
+    // must be copied before being modified
+    template <class L, class T, class MT>
+    inline void xaxis_variant<L, T, MT>::detach()
+    {
+        if (p_data.use_count() != 1)
+        {
+            p_data = std::make_shared<storage_type>(*p_data);
+        }
+    }
+
+    template <class L, class T, class MT>
+    template <class A>
+    inline const void* xaxis_variant<L, T, MT>::storage_address(const A& /*axis*/) noexcept
+    {
+        return nullptr;
+    }
+
+    template <class L, class T, class MT>
+    inline const void* xaxis_variant<L, T, MT>::storage_address(const self_type& axis) noexcept
+    {
+        return axis.p_data.get();
+    }
+
+    // Set operations with axes sharing the labels of this axis
+    // leave it unchanged
+    template <class L, class T, class MT>
+    inline bool xaxis_variant<L, T, MT>::shares_labels() const noexcept
+    {
+        return true;
+    }
+
+    template <class L, class T, class MT>
+    template <class A, class... Args>
+    inline bool xaxis_variant<L, T, MT>::shares_labels(const A& axis, const Args&... axes) const noexcept
+    {
+        return storage_address(axis) == p_data.get() && shares_labels(axes...);
+    }
+
+    // Set operations on ranges which do not result in a range
+    // require to store the labels in an xaxis.
+    template <class L, class T, class MT>
+    inline void xaxis_variant<L, T, MT>::materialize_range()
+    {
+        if (xtl::visit([](const auto& arg) { return self_type::is_range(arg); }, storage()))
+        {
+            p_data = std::make_shared<storage_type>(xtl::visit([](const auto& arg) -> storage_type
+            {
+                return xaxis<typename std::decay_t<decltype(arg)>::key_type, T, MT>(arg);
+            }, storage()));
+        }
+    }
+
+    template <class L, class T, class MT>
+    template <class F, class A, class... Args>
+    inline bool xaxis_variant<L, T, MT>::range_operation(F& /*f*/, A& /*arg*/, const Args&... /*axes*/)
+    {
+        return false;
+    }
+
+    template <class L, class T, class MT>
+    template <class F, class K, class... Args>
+    inline bool xaxis_variant<L, T, MT>::range_operation(F& f, xaxis_arange<K, T>& arg, const Args&... axes)
+    {
+        using range_type = xaxis_arange<K, T>;
+        return hold_range<range_type>(axes...) && f(arg, xtl::get<range_type>(axes.storage())...);
+    }
+
+    template <class L, class T, class MT>
+    template <class R>
+    inline bool xaxis_variant<L, T, MT>::hold_range() noexcept
+    {
+        return true;
+    }
+
+    template <class L, class T, class MT>
+    template <class R, class... Args>
+    inline bool xaxis_variant<L, T, MT>::hold_range(const self_type& axis, const Args&... axes) noexcept
+    {
+        return xtl::holds_alternative<R>(axis.storage()) && hold_range<R>(axes...);
+    }
+
+    template <class L, class T, class MT>
+    template <class A, class... Args>
+    inline bool xaxis_variant<L, T, MT>::merge_axis(A& arg, const Args&... axes)
+    {
+        return arg.merge(axes...);
+    }
+
+    template <class L, class T, class MT>
+    template <class K, class... Args>
+    inline bool xaxis_variant<L, T, MT>::merge_axis(xaxis_arange<K, T>& /*arg*/, const Args&... /*axes*/)
+    {
+        throw std::runtime_error("xaxis_arange can only be merged with xaxis_arange");
+    }
+
+    template <class L, class T, class MT>
+    template <class A, class... Args>
+    inline bool xaxis_variant<L, T, MT>::intersect_axis(A& arg, const Args&... axes)
+    {
+        return arg.intersect(axes...);
+    }
+
+    template <class L, class T, class MT>
+    template <class K, class... Args>
+    inline bool xaxis_variant<L, T, MT>::intersect_axis(xaxis_arange<K, T>& /*arg*/, const Args&... /*axes*/)
+    {
+        throw std::runtime_error("xaxis_arange can only be intersected with xaxis_arange");
+    }
+
+    template <class L, class T, class MT>
+    template <class A>
+    inline bool xaxis_variant<L, T, MT>::is_range(const A& /*arg*/) noexcept
+    {
+        return false;
+    }
+
+    template <class L, class T, class MT>
+    template <class K>
+    inline bool xaxis_variant<L, T, MT>::is_range(const xaxis_arange<K, T>& /*arg*/) noexcept
+    {
+        return true;
+    }
+
+    template <class L, class T, class MT>
+    template <class A>
+    inline auto xaxis_variant<L, T, MT>::as_xaxis_impl(const A& arg) -> self_type
+    {
+        return self_type(xaxis<typename A::key_type, T, MT>(arg));
+    }
+
+    template <class L, class T, class MT>
+    template <class A>
+    inline bool xaxis_variant<L, T, MT>::is_default(const A& /*arg*/) noexcept
+    {
+        return false;
+    }
+
+    template <class L, class T, class MT>
+    template <class K>
+    inline bool xaxis_variant<L, T, MT>::is_default(const xaxis_default<K, T>& /*arg*/) noexcept
+    {
+        return true;
+    }
+
+    template <class L, class T, class MT>
+    template <class A>
+    inline bool xaxis_variant<L, T, MT>::same_labels(const A& lhs, const A& rhs)
+    {
+        return lhs == rhs;
+    }
+
+    // Axes of different kinds, e.g. an xaxis_arange and an xaxis,
+    // are equivalent when they hold the same labels
+    template <class L, class T, class MT>
+    template <class A1, class A2>
+    inline bool xaxis_variant<L, T, MT>::same_labels(const A1& lhs, const A2& rhs)
+    {
+        using is_same_key = std::is_same<typename A1::key_type, typename A2::key_type>;
+        return same_labels_impl(lhs, rhs, is_same_key());
+    }
+
+    template <class L, class T, class MT>
+    template <class A1, class A2>
+    inline bool xaxis_variant<L, T, MT>::same_labels_impl(const A1& lhs, const A2& rhs, std::true_type)
+    {
+        if (lhs.size() != rhs.size())
+        {
+            return false;
+        }
+        for (size_type i = 0; i < lhs.size(); ++i)
+        {
+            if (lhs.label(i) != rhs.label(i))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template <class L, class T, class MT>
+    template <class A1, class A2>
+    inline bool xaxis_variant<L, T, MT>::same_labels_impl(const A1& /*lhs*/, const A2& /*rhs*/, std::false_type) noexcept
+    {
+        return false;
     }
 
     /**
      * Returns true is this axis and \c rhs are equivalent axes, i.e. they contain the same
-     * label - position pairs.
+     * label - position pairs, even if they are not of the same kind.
      * @param rhs an axis.
      */
     template <class L, class T, class MT>
     inline bool xaxis_variant<L, T, MT>::operator==(const self_type& rhs) const
     {
-        return m_data == rhs.m_data;
+        return p_data == rhs.p_data || m_stamp == rhs.m_stamp ||
+            xtl::visit([](const auto& lhs_axis, const auto& rhs_axis)
+            {
+                return self_type::same_labels(lhs_axis, rhs_axis);
+            }, storage(), rhs.storage());
     }
 
     /**
@@ -621,13 +1012,13 @@ namespace xf
     template <class L, class T, class MT>
     inline bool xaxis_variant<L, T, MT>::operator!=(const self_type& rhs) const
     {
-        return m_data != rhs.m_data;
+        return !(*this == rhs);
     }
 
     template <class OS, class L, class T, class MT>
     inline OS& operator<<(OS& out, const xaxis_variant<L, T, MT>& axis)
     {
-        xtl::visit([&out](auto&& arg) { out << arg; }, axis.m_data);
+        xtl::visit([&out](auto&& arg) { out << arg; }, axis.storage());
         return out;
     }
 
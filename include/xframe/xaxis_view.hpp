@@ -38,8 +38,9 @@ namespace xf
      * @tparam L the type list of labels.
      * @tparam T the integer type used to represent positions.
      * @tparam MT the tag used for choosing the map type which holds the label-
-     *            position pairs. Possible values are \c map_tag and \c hash_map_tag.
-     *            Default value is \c hash_map_tag.
+     *            position pairs. Possible values are \c map_tag, \c hash_map_tag,
+     *            \c flat_hash_map_tag and \c sorted_vector_tag. Default value is
+     *            \c hash_map_tag.
      * @sa xaxis_variant
      */
     template <class L, class T, class MT = hash_map_tag>
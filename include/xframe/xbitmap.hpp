@@ -0,0 +1,925 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XBITMAP_HPP
+#define XFRAME_XBITMAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+namespace xf
+{
+    using bitmap_word_type = std::uint64_t;
+
+    /*********************
+     * xbitmap_reference *
+     *********************/
+
+    /**
+     * @class xbitmap_reference
+     * @brief Proxy reference to a bit of a validity bitmap.
+     */
+    class xbitmap_reference
+    {
+    public:
+
+        using word_type = bitmap_word_type;
+
+        xbitmap_reference(word_type* word, word_type mask) noexcept;
+
+        xbitmap_reference(const xbitmap_reference&) = default;
+        xbitmap_reference& operator=(const xbitmap_reference& rhs) noexcept;
+        xbitmap_reference& operator=(bool value) noexcept;
+
+        xbitmap_reference& operator&=(bool value) noexcept;
+        xbitmap_reference& operator|=(bool value) noexcept;
+
+        operator bool() const noexcept;
+        bool operator~() const noexcept;
+        void flip() noexcept;
+
+    private:
+
+        word_type* p_word;
+        word_type m_mask;
+    };
+
+    void swap(xbitmap_reference lhs, xbitmap_reference rhs) noexcept;
+
+    /********************
+     * xbitmap_iterator *
+     ********************/
+
+    template <bool is_const>
+    class xbitmap_iterator
+    {
+    public:
+
+        using self_type = xbitmap_iterator<is_const>;
+        using word_type = bitmap_word_type;
+        using word_pointer = std::conditional_t<is_const, const word_type*, word_type*>;
+
+        using value_type = bool;
+        using reference = std::conditional_t<is_const, bool, xbitmap_reference>;
+        using pointer = void;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::random_access_iterator_tag;
+
+        xbitmap_iterator() noexcept = default;
+        xbitmap_iterator(word_pointer words, difference_type index) noexcept;
+
+        template <bool C, class = std::enable_if_t<is_const && !C>>
+        xbitmap_iterator(const xbitmap_iterator<C>& rhs) noexcept;
+
+        reference operator*() const noexcept;
+        reference operator[](difference_type n) const noexcept;
+
+        self_type& operator++() noexcept;
+        self_type& operator--() noexcept;
+        self_type operator++(int) noexcept;
+        self_type operator--(int) noexcept;
+
+        self_type& operator+=(difference_type n) noexcept;
+        self_type& operator-=(difference_type n) noexcept;
+        self_type operator+(difference_type n) const noexcept;
+        self_type operator-(difference_type n) const noexcept;
+
+        template <bool C>
+        difference_type operator-(const xbitmap_iterator<C>& rhs) const noexcept;
+
+        template <bool C>
+        bool operator==(const xbitmap_iterator<C>& rhs) const noexcept;
+        template <bool C>
+        bool operator!=(const xbitmap_iterator<C>& rhs) const noexcept;
+        template <bool C>
+        bool operator<(const xbitmap_iterator<C>& rhs) const noexcept;
+        template <bool C>
+        bool operator<=(const xbitmap_iterator<C>& rhs) const noexcept;
+        template <bool C>
+        bool operator>(const xbitmap_iterator<C>& rhs) const noexcept;
+        template <bool C>
+        bool operator>=(const xbitmap_iterator<C>& rhs) const noexcept;
+
+        word_pointer words() const noexcept;
+        difference_type index() const noexcept;
+
+    private:
+
+        word_pointer p_words = nullptr;
+        difference_type m_index = 0;
+    };
+
+    template <bool is_const>
+    xbitmap_iterator<is_const> operator+(typename xbitmap_iterator<is_const>::difference_type n,
+                                         const xbitmap_iterator<is_const>& it) noexcept;
+
+    /*******************
+     * xbitmap_storage *
+     *******************/
+
+    /**
+     * @class xbitmap_storage
+     * @brief Packed validity bitmap.
+     *
+     * The xbitmap_storage class is a container of booleans holding one bit
+     * per element, similar to the validity bitmaps of Apache Arrow. Bits
+     * are stored in 64-bit words, in a buffer aligned on 64 bytes and
+     * padded to a multiple of 64 bytes. The bits past the last element
+     * are always cleared, so that whole words can be combined and counted.
+     *
+     * It models the storage concept of xtensor so that it can be used as
+     * the flag container of an xoptional_assembly, see xbitmap_array.
+     */
+    class xbitmap_storage
+    {
+    public:
+
+        using word_type = bitmap_word_type;
+        using value_type = bool;
+        using reference = xbitmap_reference;
+        using const_reference = bool;
+        using iterator = xbitmap_iterator<false>;
+        using const_iterator = xbitmap_iterator<true>;
+        using pointer = iterator;
+        using const_pointer = const_iterator;
+        using reverse_iterator = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+        using allocator_type = std::allocator<bool>;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+
+        static constexpr size_type word_bits = 64;
+        static constexpr size_type alignment = 64;
+
+        xbitmap_storage() noexcept = default;
+        explicit xbitmap_storage(size_type size);
+        xbitmap_storage(size_type size, bool value);
+        xbitmap_storage(std::initializer_list<bool> init);
+
+        template <class It, class = decltype(*std::declval<It>())>
+        xbitmap_storage(It first, It last);
+
+        ~xbitmap_storage();
+
+        xbitmap_storage(const xbitmap_storage& rhs);
+        xbitmap_storage& operator=(const xbitmap_storage& rhs);
+
+        xbitmap_storage(xbitmap_storage&& rhs) noexcept;
+        xbitmap_storage& operator=(xbitmap_storage&& rhs) noexcept;
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type max_size() const noexcept;
+        void resize(size_type size);
+        void resize(size_type size, bool value);
+        void clear() noexcept;
+
+        reference operator[](size_type i) noexcept;
+        const_reference operator[](size_type i) const noexcept;
+
+        reference front() noexcept;
+        const_reference front() const noexcept;
+        reference back() noexcept;
+        const_reference back() const noexcept;
+
+        pointer data() noexcept;
+        const_pointer data() const noexcept;
+
+        word_type* words() noexcept;
+        const word_type* words() const noexcept;
+        size_type word_count() const noexcept;
+
+        void fill(bool value) noexcept;
+        size_type count() const noexcept;
+        bool all() const noexcept;
+        bool none() const noexcept;
+
+        template <class B>
+        void unpack(B* out) const noexcept;
+
+        iterator begin() noexcept;
+        iterator end() noexcept;
+        const_iterator begin() const noexcept;
+        const_iterator end() const noexcept;
+        const_iterator cbegin() const noexcept;
+        const_iterator cend() const noexcept;
+
+        reverse_iterator rbegin() noexcept;
+        reverse_iterator rend() noexcept;
+        const_reverse_iterator rbegin() const noexcept;
+        const_reverse_iterator rend() const noexcept;
+        const_reverse_iterator crbegin() const noexcept;
+        const_reverse_iterator crend() const noexcept;
+
+        void swap(xbitmap_storage& rhs) noexcept;
+
+    private:
+
+        static size_type words_for(size_type size) noexcept;
+        static size_type capacity_for(size_type size) noexcept;
+
+        void allocate(size_type size);
+        void deallocate() noexcept;
+        void clear_tail() noexcept;
+
+        void* p_raw = nullptr;
+        word_type* p_words = nullptr;
+        size_type m_size = 0;
+        size_type m_capacity = 0;
+    };
+
+    bool operator==(const xbitmap_storage& lhs, const xbitmap_storage& rhs) noexcept;
+    bool operator!=(const xbitmap_storage& lhs, const xbitmap_storage& rhs) noexcept;
+
+    void swap(xbitmap_storage& lhs, xbitmap_storage& rhs) noexcept;
+
+    /**
+     * Tensor of booleans backed by a validity bitmap.
+     */
+    using xbitmap_array = xt::xarray_container<xbitmap_storage, XTENSOR_DEFAULT_LAYOUT, xt::dynamic_shape<std::size_t>>;
+
+    /**
+     * Optional assembly whose missing values are stored in a validity bitmap.
+     */
+    template <class T>
+    using xbitmap_optional_assembly = xt::xoptional_assembly<xt::xarray<T>, xbitmap_array>;
+
+    template <class D>
+    struct is_bitmap_optional_assembly : std::false_type
+    {
+    };
+
+    template <class VE>
+    struct is_bitmap_optional_assembly<xt::xoptional_assembly<VE, xbitmap_array>> : std::true_type
+    {
+    };
+
+    namespace detail
+    {
+        std::size_t popcount(bitmap_word_type w) noexcept;
+
+        void bitmap_and(bitmap_word_type* res, const bitmap_word_type* lhs,
+                        const bitmap_word_type* rhs, std::size_t word_count) noexcept;
+    }
+
+    /************************************
+     * xbitmap_reference implementation *
+     ************************************/
+
+    inline xbitmap_reference::xbitmap_reference(word_type* word, word_type mask) noexcept
+        : p_word(word), m_mask(mask)
+    {
+    }
+
+    inline xbitmap_reference& xbitmap_reference::operator=(const xbitmap_reference& rhs) noexcept
+    {
+        return *this = bool(rhs);
+    }
+
+    inline xbitmap_reference& xbitmap_reference::operator=(bool value) noexcept
+    {
+        if (value)
+        {
+            *p_word |= m_mask;
+        }
+        else
+        {
+            *p_word &= ~m_mask;
+        }
+        return *this;
+    }
+
+    inline xbitmap_reference& xbitmap_reference::operator&=(bool value) noexcept
+    {
+        if (!value)
+        {
+            *p_word &= ~m_mask;
+        }
+        return *this;
+    }
+
+    inline xbitmap_reference& xbitmap_reference::operator|=(bool value) noexcept
+    {
+        if (value)
+        {
+            *p_word |= m_mask;
+        }
+        return *this;
+    }
+
+    inline xbitmap_reference::operator bool() const noexcept
+    {
+        return (*p_word & m_mask) != 0;
+    }
+
+    inline bool xbitmap_reference::operator~() const noexcept
+    {
+        return !bool(*this);
+    }
+
+    inline void xbitmap_reference::flip() noexcept
+    {
+        *p_word ^= m_mask;
+    }
+
+    inline void swap(xbitmap_reference lhs, xbitmap_reference rhs) noexcept
+    {
+        bool tmp = lhs;
+        lhs = bool(rhs);
+        rhs = tmp;
+    }
+
+    /***********************************
+     * xbitmap_iterator implementation *
+     ***********************************/
+
+    template <bool is_const>
+    inline xbitmap_iterator<is_const>::xbitmap_iterator(word_pointer words, difference_type index) noexcept
+        : p_words(words), m_index(index)
+    {
+    }
+
+    template <bool is_const>
+    template <bool C, class>
+    inline xbitmap_iterator<is_const>::xbitmap_iterator(const xbitmap_iterator<C>& rhs) noexcept
+        : p_words(rhs.words()), m_index(rhs.index())
+    {
+    }
+
+    namespace detail
+    {
+        template <class W>
+        inline bool bitmap_get(const W* words, std::ptrdiff_t i) noexcept
+        {
+            return ((words[i >> 6] >> (i & 63)) & bitmap_word_type(1)) != 0;
+        }
+
+        inline xbitmap_reference bitmap_ref(bitmap_word_type* words, std::ptrdiff_t i) noexcept
+        {
+            return xbitmap_reference(words + (i >> 6), bitmap_word_type(1) << (i & 63));
+        }
+
+        inline bool bitmap_deref(const bitmap_word_type* words, std::ptrdiff_t i) noexcept
+        {
+            return bitmap_get(words, i);
+        }
+
+        inline xbitmap_reference bitmap_deref(bitmap_word_type* words, std::ptrdiff_t i) noexcept
+        {
+            return bitmap_ref(words, i);
+        }
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator*() const noexcept -> reference
+    {
+        return detail::bitmap_deref(p_words, m_index);
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator[](difference_type n) const noexcept -> reference
+    {
+        return detail::bitmap_deref(p_words, m_index + n);
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator++() noexcept -> self_type&
+    {
+        ++m_index;
+        return *this;
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator--() noexcept -> self_type&
+    {
+        --m_index;
+        return *this;
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator++(int) noexcept -> self_type
+    {
+        self_type tmp(*this);
+        ++m_index;
+        return tmp;
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator--(int) noexcept -> self_type
+    {
+        self_type tmp(*this);
+        --m_index;
+        return tmp;
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator+=(difference_type n) noexcept -> self_type&
+    {
+        m_index += n;
+        return *this;
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator-=(difference_type n) noexcept -> self_type&
+    {
+        m_index -= n;
+        return *this;
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator+(difference_type n) const noexcept -> self_type
+    {
+        return self_type(p_words, m_index + n);
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::operator-(difference_type n) const noexcept -> self_type
+    {
+        return self_type(p_words, m_index - n);
+    }
+
+    template <bool is_const>
+    template <bool C>
+    inline auto xbitmap_iterator<is_const>::operator-(const xbitmap_iterator<C>& rhs) const noexcept -> difference_type
+    {
+        return m_index - rhs.index();
+    }
+
+    template <bool is_const>
+    template <bool C>
+    inline bool xbitmap_iterator<is_const>::operator==(const xbitmap_iterator<C>& rhs) const noexcept
+    {
+        return p_words == rhs.words() && m_index == rhs.index();
+    }
+
+    template <bool is_const>
+    template <bool C>
+    inline bool xbitmap_iterator<is_const>::operator!=(const xbitmap_iterator<C>& rhs) const noexcept
+    {
+        return !(*this == rhs);
+    }
+
+    template <bool is_const>
+    template <bool C>
+    inline bool xbitmap_iterator<is_const>::operator<(const xbitmap_iterator<C>& rhs) const noexcept
+    {
+        return m_index < rhs.index();
+    }
+
+    template <bool is_const>
+    template <bool C>
+    inline bool xbitmap_iterator<is_const>::operator<=(const xbitmap_iterator<C>& rhs) const noexcept
+    {
+        return m_index <= rhs.index();
+    }
+
+    template <bool is_const>
+    template <bool C>
+    inline bool xbitmap_iterator<is_const>::operator>(const xbitmap_iterator<C>& rhs) const noexcept
+    {
+        return m_index > rhs.index();
+    }
+
+    template <bool is_const>
+    template <bool C>
+    inline bool xbitmap_iterator<is_const>::operator>=(const xbitmap_iterator<C>& rhs) const noexcept
+    {
+        return m_index >= rhs.index();
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::words() const noexcept -> word_pointer
+    {
+        return p_words;
+    }
+
+    template <bool is_const>
+    inline auto xbitmap_iterator<is_const>::index() const noexcept -> difference_type
+    {
+        return m_index;
+    }
+
+    template <bool is_const>
+    inline xbitmap_iterator<is_const> operator+(typename xbitmap_iterator<is_const>::difference_type n,
+                                                const xbitmap_iterator<is_const>& it) noexcept
+    {
+        return it + n;
+    }
+
+    /**********************************
+     * xbitmap_storage implementation *
+     **********************************/
+
+    /**
+     * Constructs a bitmap of \c size cleared bits.
+     */
+    inline xbitmap_storage::xbitmap_storage(size_type size)
+    {
+        allocate(size);
+    }
+
+    /**
+     * Constructs a bitmap of \c size bits set to \c value.
+     */
+    inline xbitmap_storage::xbitmap_storage(size_type size, bool value)
+    {
+        allocate(size);
+        fill(value);
+    }
+
+    inline xbitmap_storage::xbitmap_storage(std::initializer_list<bool> init)
+        : xbitmap_storage(init.begin(), init.end())
+    {
+    }
+
+    template <class It, class>
+    inline xbitmap_storage::xbitmap_storage(It first, It last)
+    {
+        allocate(static_cast<size_type>(std::distance(first, last)));
+        std::copy(first, last, begin());
+    }
+
+    inline xbitmap_storage::~xbitmap_storage()
+    {
+        deallocate();
+    }
+
+    inline xbitmap_storage::xbitmap_storage(const xbitmap_storage& rhs)
+    {
+        allocate(rhs.m_size);
+        std::copy(rhs.p_words, rhs.p_words + words_for(m_size), p_words);
+    }
+
+    inline xbitmap_storage& xbitmap_storage::operator=(const xbitmap_storage& rhs)
+    {
+        if (this != &rhs)
+        {
+            xbitmap_storage tmp(rhs);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    inline xbitmap_storage::xbitmap_storage(xbitmap_storage&& rhs) noexcept
+    {
+        swap(rhs);
+    }
+
+    inline xbitmap_storage& xbitmap_storage::operator=(xbitmap_storage&& rhs) noexcept
+    {
+        swap(rhs);
+        return *this;
+    }
+
+    inline bool xbitmap_storage::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    inline auto xbitmap_storage::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    inline auto xbitmap_storage::max_size() const noexcept -> size_type
+    {
+        return std::numeric_limits<size_type>::max() - alignment * 8;
+    }
+
+    /**
+     * Resizes the bitmap. Existing bits are kept, new bits are cleared.
+     */
+    inline void xbitmap_storage::resize(size_type size)
+    {
+        resize(size, false);
+    }
+
+    /**
+     * Resizes the bitmap. Existing bits are kept, new bits are set to \c value.
+     */
+    inline void xbitmap_storage::resize(size_type size, bool value)
+    {
+        size_type old_size = m_size;
+        if (words_for(size) > m_capacity)
+        {
+            xbitmap_storage tmp(size);
+            std::copy(p_words, p_words + words_for(old_size), tmp.p_words);
+            swap(tmp);
+        }
+        m_size = size;
+        if (size > old_size)
+        {
+            std::fill(begin() + static_cast<difference_type>(old_size), end(), value);
+        }
+        clear_tail();
+    }
+
+    inline void xbitmap_storage::clear() noexcept
+    {
+        m_size = 0;
+        clear_tail();
+    }
+
+    inline auto xbitmap_storage::operator[](size_type i) noexcept -> reference
+    {
+        return detail::bitmap_ref(p_words, static_cast<difference_type>(i));
+    }
+
+    inline auto xbitmap_storage::operator[](size_type i) const noexcept -> const_reference
+    {
+        return detail::bitmap_get(p_words, static_cast<difference_type>(i));
+    }
+
+    inline auto xbitmap_storage::front() noexcept -> reference
+    {
+        return (*this)[0];
+    }
+
+    inline auto xbitmap_storage::front() const noexcept -> const_reference
+    {
+        return (*this)[0];
+    }
+
+    inline auto xbitmap_storage::back() noexcept -> reference
+    {
+        return (*this)[m_size - 1];
+    }
+
+    inline auto xbitmap_storage::back() const noexcept -> const_reference
+    {
+        return (*this)[m_size - 1];
+    }
+
+    /**
+     * Returns an iterator to the first bit. Bits cannot be addressed,
+     * so the data of a bitmap is accessed through an iterator; use
+     * words() to access the underlying buffer.
+     */
+    inline auto xbitmap_storage::data() noexcept -> pointer
+    {
+        return begin();
+    }
+
+    inline auto xbitmap_storage::data() const noexcept -> const_pointer
+    {
+        return begin();
+    }
+
+    /**
+     * Returns a pointer to the 64-byte aligned buffer of words. Bit \c i
+     * of the bitmap is bit <tt>i % 64</tt> of word <tt>i / 64</tt>.
+     */
+    inline auto xbitmap_storage::words() noexcept -> word_type*
+    {
+        return p_words;
+    }
+
+    inline auto xbitmap_storage::words() const noexcept -> const word_type*
+    {
+        return p_words;
+    }
+
+    /**
+     * Returns the number of words holding the bits of the bitmap.
+     */
+    inline auto xbitmap_storage::word_count() const noexcept -> size_type
+    {
+        return words_for(m_size);
+    }
+
+    inline void xbitmap_storage::fill(bool value) noexcept
+    {
+        std::fill(p_words, p_words + words_for(m_size), value ? ~word_type(0) : word_type(0));
+        clear_tail();
+    }
+
+    /**
+     * Returns the number of set bits.
+     */
+    inline auto xbitmap_storage::count() const noexcept -> size_type
+    {
+        size_type res = 0;
+        size_type nb_words = words_for(m_size);
+        for (size_type i = 0; i < nb_words; ++i)
+        {
+            res += detail::popcount(p_words[i]);
+        }
+        return res;
+    }
+
+    inline bool xbitmap_storage::all() const noexcept
+    {
+        return count() == m_size;
+    }
+
+    inline bool xbitmap_storage::none() const noexcept
+    {
+        size_type nb_words = words_for(m_size);
+        return std::all_of(p_words, p_words + nb_words, [](word_type w) { return w == 0; });
+    }
+
+    /**
+     * Writes the bits of the bitmap into \c out, one element per bit.
+     */
+    template <class B>
+    inline void xbitmap_storage::unpack(B* out) const noexcept
+    {
+        size_type nb_full = m_size / word_bits;
+        for (size_type w = 0; w < nb_full; ++w)
+        {
+            word_type word = p_words[w];
+            B* o = out + w * word_bits;
+            for (size_type b = 0; b < word_bits; ++b)
+            {
+                o[b] = static_cast<B>((word >> b) & word_type(1));
+            }
+        }
+        for (size_type i = nb_full * word_bits; i < m_size; ++i)
+        {
+            out[i] = static_cast<B>((*this)[i]);
+        }
+    }
+
+    inline auto xbitmap_storage::begin() noexcept -> iterator
+    {
+        return iterator(p_words, 0);
+    }
+
+    inline auto xbitmap_storage::end() noexcept -> iterator
+    {
+        return iterator(p_words, static_cast<difference_type>(m_size));
+    }
+
+    inline auto xbitmap_storage::begin() const noexcept -> const_iterator
+    {
+        return cbegin();
+    }
+
+    inline auto xbitmap_storage::end() const noexcept -> const_iterator
+    {
+        return cend();
+    }
+
+    inline auto xbitmap_storage::cbegin() const noexcept -> const_iterator
+    {
+        return const_iterator(p_words, 0);
+    }
+
+    inline auto xbitmap_storage::cend() const noexcept -> const_iterator
+    {
+        return const_iterator(p_words, static_cast<difference_type>(m_size));
+    }
+
+    inline auto xbitmap_storage::rbegin() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(end());
+    }
+
+    inline auto xbitmap_storage::rend() noexcept -> reverse_iterator
+    {
+        return reverse_iterator(begin());
+    }
+
+    inline auto xbitmap_storage::rbegin() const noexcept -> const_reverse_iterator
+    {
+        return crbegin();
+    }
+
+    inline auto xbitmap_storage::rend() const noexcept -> const_reverse_iterator
+    {
+        return crend();
+    }
+
+    inline auto xbitmap_storage::crbegin() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    inline auto xbitmap_storage::crend() const noexcept -> const_reverse_iterator
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    inline void xbitmap_storage::swap(xbitmap_storage& rhs) noexcept
+    {
+        using std::swap;
+        swap(p_raw, rhs.p_raw);
+        swap(p_words, rhs.p_words);
+        swap(m_size, rhs.m_size);
+        swap(m_capacity, rhs.m_capacity);
+    }
+
+    inline auto xbitmap_storage::words_for(size_type size) noexcept -> size_type
+    {
+        return (size + word_bits - 1) / word_bits;
+    }
+
+    inline auto xbitmap_storage::capacity_for(size_type size) noexcept -> size_type
+    {
+        constexpr size_type words_per_line = alignment / sizeof(word_type);
+        return (words_for(size) + words_per_line - 1) / words_per_line * words_per_line;
+    }
+
+    inline void xbitmap_storage::allocate(size_type size)
+    {
+        size_type capacity = capacity_for(size);
+        if (capacity != 0)
+        {
+            p_raw = std::malloc(capacity * sizeof(word_type) + alignment);
+            if (p_raw == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+            std::uintptr_t addr = reinterpret_cast<std::uintptr_t>(p_raw);
+            addr = (addr + alignment) & ~std::uintptr_t(alignment - 1);
+            p_words = reinterpret_cast<word_type*>(addr);
+            std::fill(p_words, p_words + capacity, word_type(0));
+        }
+        m_size = size;
+        m_capacity = capacity;
+    }
+
+    inline void xbitmap_storage::deallocate() noexcept
+    {
+        std::free(p_raw);
+        p_raw = nullptr;
+        p_words = nullptr;
+        m_size = 0;
+        m_capacity = 0;
+    }
+
+    inline void xbitmap_storage::clear_tail() noexcept
+    {
+        size_type nb_words = words_for(m_size);
+        size_type rem = m_size % word_bits;
+        if (rem != 0)
+        {
+            p_words[nb_words - 1] &= (word_type(1) << rem) - 1;
+        }
+        std::fill(p_words + nb_words, p_words + m_capacity, word_type(0));
+    }
+
+    inline bool operator==(const xbitmap_storage& lhs, const xbitmap_storage& rhs) noexcept
+    {
+        return lhs.size() == rhs.size() &&
+            std::equal(lhs.words(), lhs.words() + lhs.word_count(), rhs.words());
+    }
+
+    inline bool operator!=(const xbitmap_storage& lhs, const xbitmap_storage& rhs) noexcept
+    {
+        return !(lhs == rhs);
+    }
+
+    inline void swap(xbitmap_storage& lhs, xbitmap_storage& rhs) noexcept
+    {
+        lhs.swap(rhs);
+    }
+
+    namespace detail
+    {
+        inline std::size_t popcount(bitmap_word_type w) noexcept
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            return static_cast<std::size_t>(__builtin_popcountll(w));
+#else
+            w = w - ((w >> 1) & 0x5555555555555555ULL);
+            w = (w & 0x3333333333333333ULL) + ((w >> 2) & 0x3333333333333333ULL);
+            w = (w + (w >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+            return static_cast<std::size_t>((w * 0x0101010101010101ULL) >> 56);
+#endif
+        }
+
+        /**
+         * Computes the bitwise AND of two bitmaps, 64 elements at a time.
+         * \c res may alias \c lhs or \c rhs.
+         */
+        inline void bitmap_and(bitmap_word_type* res, const bitmap_word_type* lhs,
+                               const bitmap_word_type* rhs, std::size_t word_count) noexcept
+        {
+            for (std::size_t i = 0; i < word_count; ++i)
+            {
+                res[i] = lhs[i] & rhs[i];
+            }
+        }
+    }
+}
+
+#endif
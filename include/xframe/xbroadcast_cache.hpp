@@ -0,0 +1,402 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XBROADCAST_CACHE_HPP
+#define XFRAME_XBROADCAST_CACHE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "xframe_config.hpp"
+#include "xcoordinate.hpp"
+
+namespace xf
+{
+    /****************************
+     * broadcast cache settings *
+     ****************************/
+
+    struct xbroadcast_cache_statistics
+    {
+        std::size_t m_hits;
+        std::size_t m_misses;
+        std::size_t m_evictions;
+    };
+
+    xbroadcast_cache_statistics broadcast_cache_statistics() noexcept;
+    void reset_broadcast_cache_statistics() noexcept;
+
+    std::size_t get_broadcast_cache_capacity() noexcept;
+    void set_broadcast_cache_capacity(std::size_t n) noexcept;
+
+    void clear_broadcast_cache() noexcept;
+
+    /******************
+     * xbroadcast_key *
+     ******************/
+
+    /**
+     * @class xbroadcast_key
+     * @brief Identifies a broadcast of coordinates.
+     *
+     * The xbroadcast_key class holds the join type and the list of
+     * dimension names and axis stamps of the coordinates involved in a
+     * broadcast. Since axes holding different labels never share a
+     * stamp, two broadcasts with the same key give the same result.
+     *
+     * @tparam K the type of dimension names.
+     */
+    template <class K>
+    class xbroadcast_key
+    {
+    public:
+
+        using key_type = K;
+
+        explicit xbroadcast_key(join::join_id id);
+
+        template <class L, class S, class MT>
+        bool append(const xcoordinate<K, L, S, MT>& c);
+        bool append(const xfull_coordinate& c) noexcept;
+        template <class C>
+        bool append(const C& c) noexcept;
+
+        std::size_t hash() const noexcept;
+
+        bool operator==(const xbroadcast_key& rhs) const;
+
+    private:
+
+        void combine(std::size_t h) noexcept;
+
+        join::join_id m_join_id;
+        std::vector<std::pair<key_type, std::uint64_t>> m_axes;
+        std::size_t m_hash;
+    };
+
+    /********************
+     * xbroadcast_cache *
+     ********************/
+
+    /**
+     * @class xbroadcast_cache
+     * @brief Process-wide cache of broadcast coordinates.
+     *
+     * The xbroadcast_cache class maps keys of broadcasts to the resulting
+     * coordinates and trivial broadcast flags. The least recently used
+     * entries are evicted when the number of entries exceeds the capacity
+     * returned by get_broadcast_cache_capacity. There is one cache per
+     * coordinate type; all of them can be used concurrently.
+     *
+     * @tparam C the coordinate type.
+     */
+    template <class C>
+    class xbroadcast_cache
+    {
+    public:
+
+        using coordinate_type = C;
+        using key_type = xbroadcast_key<typename coordinate_type::key_type>;
+        using size_type = std::size_t;
+
+        static xbroadcast_cache& instance();
+
+        xbroadcast_cache(const xbroadcast_cache&) = delete;
+        xbroadcast_cache& operator=(const xbroadcast_cache&) = delete;
+
+        template <class F>
+        xtrivial_broadcast broadcast(const key_type& key, coordinate_type& coords, F&& compute);
+
+        size_type size();
+
+    private:
+
+        using value_type = std::pair<coordinate_type, xtrivial_broadcast>;
+        using value_pointer = std::shared_ptr<const value_type>;
+        using entry_list = std::list<std::pair<key_type, value_pointer>>;
+
+        struct key_hash
+        {
+            std::size_t operator()(const key_type& key) const noexcept;
+        };
+
+        using index_type = std::unordered_map<key_type, typename entry_list::iterator, key_hash>;
+
+        xbroadcast_cache() = default;
+
+        value_pointer find(const key_type& key);
+        void insert(const key_type& key, value_pointer value);
+        void synchronize();
+
+        std::mutex m_mutex;
+        entry_list m_entries;
+        index_type m_index;
+        std::size_t m_generation = 0;
+    };
+
+    /************************************
+     * broadcast cache settings details *
+     ************************************/
+
+    namespace detail
+    {
+        struct xbroadcast_cache_state
+        {
+            std::atomic<std::size_t> m_hits{0};
+            std::atomic<std::size_t> m_misses{0};
+            std::atomic<std::size_t> m_evictions{0};
+            std::atomic<std::size_t> m_capacity{XFRAME_BROADCAST_CACHE_CAPACITY};
+            std::atomic<std::size_t> m_generation{0};
+        };
+
+        inline xbroadcast_cache_state& broadcast_cache_state() noexcept
+        {
+            static xbroadcast_cache_state state;
+            return state;
+        }
+    }
+
+    /*******************************************
+     * broadcast cache settings implementation *
+     *******************************************/
+
+    /**
+     * Returns the number of hits, misses and evictions of the broadcast
+     * caches since the start of the program or the last call to
+     * reset_broadcast_cache_statistics.
+     */
+    inline xbroadcast_cache_statistics broadcast_cache_statistics() noexcept
+    {
+        auto& state = detail::broadcast_cache_state();
+        return { state.m_hits.load(), state.m_misses.load(), state.m_evictions.load() };
+    }
+
+    /**
+     * Resets the counters of the broadcast caches.
+     */
+    inline void reset_broadcast_cache_statistics() noexcept
+    {
+        auto& state = detail::broadcast_cache_state();
+        state.m_hits = 0;
+        state.m_misses = 0;
+        state.m_evictions = 0;
+    }
+
+    /**
+     * Returns the maximum number of entries of each broadcast cache.
+     */
+    inline std::size_t get_broadcast_cache_capacity() noexcept
+    {
+        return detail::broadcast_cache_state().m_capacity.load();
+    }
+
+    /**
+     * Sets the maximum number of entries of each broadcast cache. A value
+     * of 0 disables the caching of broadcast coordinates.
+     */
+    inline void set_broadcast_cache_capacity(std::size_t n) noexcept
+    {
+        detail::broadcast_cache_state().m_capacity = n;
+    }
+
+    /**
+     * Removes all the entries of the broadcast caches.
+     */
+    inline void clear_broadcast_cache() noexcept
+    {
+        ++detail::broadcast_cache_state().m_generation;
+    }
+
+    /*********************************
+     * xbroadcast_key implementation *
+     *********************************/
+
+    template <class K>
+    inline xbroadcast_key<K>::xbroadcast_key(join::join_id id)
+        : m_join_id(id), m_axes(), m_hash(static_cast<std::size_t>(id))
+    {
+    }
+
+    /**
+     * Appends the dimension names and the axis stamps of the coordinates
+     * \c c to the key.
+     * @return true.
+     */
+    template <class K>
+    template <class L, class S, class MT>
+    inline bool xbroadcast_key<K>::append(const xcoordinate<K, L, S, MT>& c)
+    {
+        // Separates the axes of consecutive coordinates
+        m_axes.emplace_back(key_type(), std::uint64_t(0));
+        combine(0);
+        for (const auto& axis : c)
+        {
+            m_axes.emplace_back(axis.first, axis.second.stamp());
+            combine(std::hash<key_type>()(axis.first));
+            combine(std::hash<std::uint64_t>()(axis.second.stamp()));
+        }
+        return true;
+    }
+
+    /**
+     * Scalars do not take part in the broadcast.
+     * @return true.
+     */
+    template <class K>
+    inline bool xbroadcast_key<K>::append(const xfull_coordinate& /*c*/) noexcept
+    {
+        return true;
+    }
+
+    /**
+     * Other coordinate types have no stable identity.
+     * @return false.
+     */
+    template <class K>
+    template <class C>
+    inline bool xbroadcast_key<K>::append(const C& /*c*/) noexcept
+    {
+        return false;
+    }
+
+    template <class K>
+    inline std::size_t xbroadcast_key<K>::hash() const noexcept
+    {
+        return m_hash;
+    }
+
+    template <class K>
+    inline bool xbroadcast_key<K>::operator==(const xbroadcast_key& rhs) const
+    {
+        return m_join_id == rhs.m_join_id && m_hash == rhs.m_hash && m_axes == rhs.m_axes;
+    }
+
+    template <class K>
+    inline void xbroadcast_key<K>::combine(std::size_t h) noexcept
+    {
+        m_hash ^= h + std::size_t(0x9e3779b97f4a7c15ull) + (m_hash << 6) + (m_hash >> 2);
+    }
+
+    /***********************************
+     * xbroadcast_cache implementation *
+     ***********************************/
+
+    template <class C>
+    inline auto xbroadcast_cache<C>::instance() -> xbroadcast_cache&
+    {
+        static xbroadcast_cache cache;
+        return cache;
+    }
+
+    /**
+     * Copies the coordinates of the broadcast identified by \c key into
+     * \c coords. If the broadcast is not in the cache, \c compute is called
+     * with \c coords to perform it and its result is stored.
+     * @param key the key of the broadcast.
+     * @param coords the empty coordinates to broadcast to.
+     * @param compute the function performing the broadcast.
+     * @return the trivial broadcast flags of the broadcast.
+     */
+    template <class C>
+    template <class F>
+    inline xtrivial_broadcast xbroadcast_cache<C>::broadcast(const key_type& key, coordinate_type& coords, F&& compute)
+    {
+        auto& state = detail::broadcast_cache_state();
+        value_pointer value = find(key);
+        if (value != nullptr)
+        {
+            ++state.m_hits;
+            coords = value->first;
+            return value->second;
+        }
+
+        ++state.m_misses;
+        xtrivial_broadcast res = compute(coords);
+        insert(key, std::make_shared<value_type>(coords, res));
+        return res;
+    }
+
+    /**
+     * Returns the number of entries in the cache.
+     */
+    template <class C>
+    inline auto xbroadcast_cache<C>::size() -> size_type
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        synchronize();
+        return m_entries.size();
+    }
+
+    template <class C>
+    inline std::size_t xbroadcast_cache<C>::key_hash::operator()(const key_type& key) const noexcept
+    {
+        return key.hash();
+    }
+
+    template <class C>
+    inline auto xbroadcast_cache<C>::find(const key_type& key) -> value_pointer
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        synchronize();
+        auto it = m_index.find(key);
+        if (it == m_index.end())
+        {
+            return nullptr;
+        }
+        m_entries.splice(m_entries.begin(), m_entries, it->second);
+        return it->second->second;
+    }
+
+    template <class C>
+    inline void xbroadcast_cache<C>::insert(const key_type& key, value_pointer value)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        synchronize();
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+        {
+            // Another thread computed the same broadcast in the meantime
+            m_entries.splice(m_entries.begin(), m_entries, it->second);
+            return;
+        }
+
+        m_entries.emplace_front(key, std::move(value));
+        m_index.emplace(key, m_entries.begin());
+        std::size_t capacity = get_broadcast_cache_capacity();
+        while (m_entries.size() > capacity)
+        {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+            ++detail::broadcast_cache_state().m_evictions;
+        }
+    }
+
+    template <class C>
+    inline void xbroadcast_cache<C>::synchronize()
+    {
+        std::size_t generation = detail::broadcast_cache_state().m_generation.load();
+        if (generation != m_generation)
+        {
+            m_index.clear();
+            m_entries.clear();
+            m_generation = generation;
+        }
+    }
+}
+
+#endif
@@ -66,8 +66,9 @@ namespace xf
      * @tparam S the integer type used to represent positions in axes. Default value
      *           is \c std::size_t.
      * @tparam MT the tag used for choosing the map type which holds the label-
-     *            position pairs in the axes. Possible values are \c map_tag and
-     *            \c hash_map_tag. Default value is \c hash_map_tag.
+     *            position pairs in the axes. Possible values are \c map_tag,
+     *            \c hash_map_tag, \c flat_hash_map_tag and \c sorted_vector_tag.
+     *            Default value is \c hash_map_tag.
      */
     template <class K, class L = XFRAME_DEFAULT_LABEL_LIST, class S = std::size_t, class MT = hash_map_tag>
     class xcoordinate : public xcoordinate_base<K, xaxis_variant<L, S, MT>>
@@ -309,6 +310,7 @@ namespace xf
     template <class Join, class... Args>
     inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast(const Args&... coordinates)
     {
+        XFRAME_TRACE_SCOPE(broadcast_coordinates)
         return this->empty() ? broadcast_empty<Join>(coordinates...) : broadcast_impl<Join>(coordinates...);
     }
 
@@ -343,7 +345,6 @@ namespace xf
     inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast_impl(const self_type& c, const Args&... coordinates)
     {
         auto res = broadcast_impl<Join>(coordinates...);
-        XFRAME_TRACE_BROADCAST_COORDINATES(*this, c);
         for(auto iter = c.begin(); iter != c.end(); ++iter)
         {
             auto inserted = this->coordinate().insert(*iter);
@@ -358,7 +359,6 @@ namespace xf
             }
         }
         res.m_same_dimensions &= (this->size() == c.size());
-        XFRAME_TRACE_COORDINATES_RESULT(*this, res);
         return res;
     }
 
@@ -367,7 +367,6 @@ namespace xf
     inline xtrivial_broadcast xcoordinate<K, L, S, MT>::broadcast_impl(const coordinate_view_type& c, const Args&... coordinates)
     {
         auto res = broadcast_impl<Join>(coordinates...);
-        XFRAME_TRACE_BROADCAST_COORDINATES(*this, c);
         for (auto iter = c.begin(); iter != c.end(); ++iter)
         {
             mapped_type axis = mapped_type(iter->second);
@@ -383,7 +382,6 @@ namespace xf
             }
         }
         res.m_same_dimensions &= (this->size() == c.size());
-        XFRAME_TRACE_COORDINATES_RESULT(*this, res);
         return res;
     }
 
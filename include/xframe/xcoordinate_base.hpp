@@ -303,6 +303,11 @@ namespace xf
     template <class K, class A1, class A2>
     inline bool operator==(const xcoordinate_base<K, A1>& lhs, const xcoordinate_base<K, A2>& rhs)
     {
+        if (static_cast<const void*>(&lhs) == static_cast<const void*>(&rhs))
+        {
+            return true;
+        }
+
         bool res = lhs.size() == rhs.size();
 
         auto liter = lhs.cbegin();
@@ -34,8 +34,9 @@ namespace xf
      * @tparam S the integer type used to represent positions in axes. Default value
      *           is \c std::size_t.
      * @tparam MT the tag used for choosing the map type which holds the label-
-     *            position pairs in the axes. Possible values are \c map_tag and
-     *            \c hash_map_tag. Default value is \c hash_map_tag.
+     *            position pairs in the axes. Possible values are \c map_tag,
+     *            \c hash_map_tag, \c flat_hash_map_tag and \c sorted_vector_tag.
+     *            Default value is \c hash_map_tag.
      * @sa xaxis_view
      */
     template <class K, class L = XFRAME_DEFAULT_LABEL_LIST, class S = std::size_t, class MT = hash_map_tag>
@@ -0,0 +1,852 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XCSV_HPP
+#define XFRAME_XCSV_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Defining XFRAME_CSV_MMAP to 0 makes read_csv load files with std::ifstream
+// instead of mapping them in memory
+#ifndef XFRAME_CSV_MMAP
+#if defined(__unix__) || defined(__APPLE__)
+#define XFRAME_CSV_MMAP 1
+#else
+#define XFRAME_CSV_MMAP 0
+#endif
+#endif
+
+#if XFRAME_CSV_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "xaxis.hpp"
+#include "xcoordinate.hpp"
+#include "xflag_writer.hpp"
+#include "xflat_hash_map.hpp"
+#include "xparallel.hpp"
+#include "xvariable.hpp"
+
+namespace xf
+{
+    template <class T = double>
+    xvariable<T, xcoordinate<fstring>> read_csv(const std::string& path,
+                                                const std::vector<fstring>& label_columns,
+                                                const fstring& value_column,
+                                                char delimiter = ',');
+
+    template <class T = double>
+    xvariable<T, xcoordinate<fstring>> read_wide_csv(const std::string& path,
+                                                     const std::vector<fstring>& label_columns,
+                                                     const fstring& column_dimension,
+                                                     char delimiter = ',');
+
+    /***************************
+     * read_csv implementation *
+     ***************************/
+
+    namespace detail
+    {
+        constexpr std::size_t csv_chunk_size = std::size_t(1) << 20;
+        constexpr std::size_t csv_npos = std::numeric_limits<std::size_t>::max();
+
+        /**
+         * Read-only view on the content of a file, mapped in memory when
+         * XFRAME_CSV_MMAP is 1.
+         */
+        class xcsv_file
+        {
+        public:
+
+            explicit xcsv_file(const std::string& path);
+            ~xcsv_file();
+
+            xcsv_file(const xcsv_file&) = delete;
+            xcsv_file& operator=(const xcsv_file&) = delete;
+
+            const char* begin() const noexcept;
+            const char* end() const noexcept;
+
+        private:
+
+            const char* p_data = nullptr;
+            std::size_t m_size = 0;
+#if XFRAME_CSV_MMAP
+            void* p_map = nullptr;
+#else
+            std::vector<char> m_buffer;
+#endif
+        };
+
+        inline xcsv_file::xcsv_file(const std::string& path)
+        {
+#if XFRAME_CSV_MMAP
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+            {
+                throw std::runtime_error("Cannot open CSV file " + path);
+            }
+            struct stat st;
+            if (::fstat(fd, &st) != 0)
+            {
+                ::close(fd);
+                throw std::runtime_error("Cannot read CSV file " + path);
+            }
+            m_size = static_cast<std::size_t>(st.st_size);
+            if (m_size != 0)
+            {
+                void* map = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (map == MAP_FAILED)
+                {
+                    ::close(fd);
+                    throw std::runtime_error("Cannot map CSV file " + path);
+                }
+                p_map = map;
+                p_data = static_cast<const char*>(map);
+            }
+            ::close(fd);
+#else
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+            {
+                throw std::runtime_error("Cannot open CSV file " + path);
+            }
+            m_buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            p_data = m_buffer.data();
+            m_size = m_buffer.size();
+#endif
+        }
+
+        inline xcsv_file::~xcsv_file()
+        {
+#if XFRAME_CSV_MMAP
+            if (p_map != nullptr)
+            {
+                ::munmap(p_map, m_size);
+            }
+#endif
+        }
+
+        inline const char* xcsv_file::begin() const noexcept
+        {
+            return p_data;
+        }
+
+        inline const char* xcsv_file::end() const noexcept
+        {
+            return p_data + m_size;
+        }
+
+        /**
+         * Field of a CSV file, pointing into the content of the file.
+         */
+        struct xcsv_token
+        {
+            const char* p_first;
+            std::size_t m_size;
+        };
+
+        struct xcsv_token_hash
+        {
+            std::size_t operator()(const xcsv_token& t) const noexcept
+            {
+                std::uint64_t res = 14695981039346656037ull;
+                for (std::size_t i = 0; i < t.m_size; ++i)
+                {
+                    res = (res ^ static_cast<unsigned char>(t.p_first[i])) * 1099511628211ull;
+                }
+                return static_cast<std::size_t>(res);
+            }
+        };
+
+        struct xcsv_token_equal
+        {
+            bool operator()(const xcsv_token& lhs, const xcsv_token& rhs) const noexcept
+            {
+                return lhs.m_size == rhs.m_size && std::memcmp(lhs.p_first, rhs.p_first, lhs.m_size) == 0;
+            }
+        };
+
+        using xcsv_dictionary = xflat_hash_map<xcsv_token, std::uint32_t, xcsv_token_hash, xcsv_token_equal>;
+
+        inline xcsv_token make_csv_token(const char* first, const char* last) noexcept
+        {
+            while (first != last && *first == ' ')
+            {
+                ++first;
+            }
+            while (last != first && last[-1] == ' ')
+            {
+                --last;
+            }
+            return xcsv_token{ first, static_cast<std::size_t>(last - first) };
+        }
+
+        /**
+         * Calls f(first, last) on each non-empty line of [first, last), without
+         * the line terminator.
+         */
+        template <class F>
+        inline void for_each_csv_line(const char* first, const char* last, F&& f)
+        {
+            while (first != last)
+            {
+                const void* eol = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+                const char* line_end = eol != nullptr ? static_cast<const char*>(eol) : last;
+                const char* next = eol != nullptr ? line_end + 1 : last;
+                if (line_end != first && line_end[-1] == '\r')
+                {
+                    --line_end;
+                }
+                if (line_end != first)
+                {
+                    f(first, line_end);
+                }
+                first = next;
+            }
+        }
+
+        /**
+         * Calls f(column, first, last) on each field of a line, until f
+         * returns false.
+         */
+        template <class F>
+        inline void for_each_csv_field(const char* first, const char* last, char delimiter, F&& f)
+        {
+            std::size_t column = 0;
+            const char* field = first;
+            for (const char* it = first; it != last; ++it)
+            {
+                if (*it == delimiter)
+                {
+                    if (!f(column, field, it))
+                    {
+                        return;
+                    }
+                    ++column;
+                    field = it + 1;
+                }
+            }
+            f(column, field, last);
+        }
+
+        /**
+         * Splits [first, last) into chunks of whole lines, a few per thread
+         * for balancing the load. Returns the boundaries of the chunks.
+         */
+        inline std::vector<const char*> split_csv_chunks(const char* first, const char* last, std::size_t nb_threads)
+        {
+            std::size_t size = static_cast<std::size_t>(last - first);
+            std::size_t nb_chunks = nb_threads < 2 ? std::size_t(1)
+                                                   : std::max(std::min(size / csv_chunk_size, 4 * nb_threads), std::size_t(1));
+            std::vector<const char*> res(1, first);
+            for (std::size_t i = 1; i < nb_chunks; ++i)
+            {
+                const char* p = std::max(first + size / nb_chunks * i, res.back());
+                const void* eol = std::memchr(p, '\n', static_cast<std::size_t>(last - p));
+                if (eol == nullptr)
+                {
+                    break;
+                }
+                p = static_cast<const char*>(eol) + 1;
+                if (p == last)
+                {
+                    break;
+                }
+                res.push_back(p);
+            }
+            res.push_back(last);
+            return res;
+        }
+
+        inline bool is_csv_missing(const xcsv_token& t) noexcept
+        {
+            const char* p = t.p_first;
+            switch (t.m_size)
+            {
+            case 0:
+                return true;
+            case 2:
+                return p[0] == 'N' && p[1] == 'A';
+            case 3:
+                return std::memcmp(p, "N/A", 3) == 0 || std::memcmp(p, "NaN", 3) == 0 || std::memcmp(p, "nan", 3) == 0;
+            default:
+                return false;
+            }
+        }
+
+        /**
+         * Parses the magnitude and the sign of an integer. If canonical is true,
+         * leading zeros, plus signs and negative zeros are rejected, so that
+         * distinct fields never denote the same integer.
+         */
+        inline bool parse_csv_integer(const xcsv_token& t, bool canonical, bool& negative, std::uint64_t& magnitude) noexcept
+        {
+            const char* first = t.p_first;
+            const char* last = first + t.m_size;
+            negative = first != last && *first == '-';
+            if (first != last && (*first == '-' || (!canonical && *first == '+')))
+            {
+                ++first;
+            }
+            if (first == last || (canonical && *first == '0' && (last - first > 1 || negative)))
+            {
+                return false;
+            }
+            while (!canonical && last - first > 1 && *first == '0')
+            {
+                ++first;
+            }
+            if (last - first > 19)
+            {
+                return false;
+            }
+            std::uint64_t res = 0;
+            for (; first != last; ++first)
+            {
+                unsigned digit = static_cast<unsigned>(*first - '0');
+                if (digit > 9)
+                {
+                    return false;
+                }
+                res = res * 10 + digit;
+            }
+            magnitude = res;
+            return true;
+        }
+
+        template <class T>
+        inline bool to_csv_integral(bool negative, std::uint64_t magnitude, T& res) noexcept
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            std::uint64_t max = static_cast<unsigned_type>(std::numeric_limits<T>::max());
+            if (!negative || magnitude == 0)
+            {
+                res = static_cast<T>(magnitude);
+                return magnitude <= max;
+            }
+            if (!std::is_signed<T>::value || magnitude - 1 > max)
+            {
+                return false;
+            }
+            res = static_cast<T>(-static_cast<T>(magnitude - 1) - 1);
+            return true;
+        }
+
+        template <class T>
+        inline bool parse_csv_number(const xcsv_token& t, T& res, std::true_type) noexcept
+        {
+            bool negative = false;
+            std::uint64_t magnitude = 0;
+            return parse_csv_integer(t, false, negative, magnitude) && to_csv_integral(negative, magnitude, res);
+        }
+
+        template <class T>
+        inline bool parse_csv_floating_fallback(const xcsv_token& t, T& res)
+        {
+            std::string buffer(t.p_first, t.m_size);
+            char* end = nullptr;
+            double value = std::strtod(buffer.c_str(), &end);
+            res = static_cast<T>(value);
+            return t.m_size != 0 && end == buffer.c_str() + buffer.size();
+        }
+
+        /**
+         * Parses a floating point number. Numbers with at most 19 significant
+         * digits whose mantissa is exactly representable and whose decimal
+         * exponent is at most 22 in magnitude are computed with a single exact
+         * multiplication or division, which is correctly rounded; other numbers
+         * are parsed with std::strtod.
+         */
+        template <class T>
+        inline bool parse_csv_number(const xcsv_token& t, T& res, std::false_type)
+        {
+            static const double powers[] = {
+                1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+            };
+
+            const char* it = t.p_first;
+            const char* last = it + t.m_size;
+            bool negative = it != last && *it == '-';
+            if (it != last && (*it == '-' || *it == '+'))
+            {
+                ++it;
+            }
+
+            std::uint64_t mantissa = 0;
+            int nb_digits = 0;
+            int exponent = 0;
+            bool has_digits = false;
+            for (; it != last && static_cast<unsigned>(*it - '0') < 10; ++it)
+            {
+                has_digits = true;
+                if (mantissa != 0 || *it != '0')
+                {
+                    mantissa = mantissa * 10 + static_cast<unsigned>(*it - '0');
+                    ++nb_digits;
+                }
+            }
+            if (it != last && *it == '.')
+            {
+                for (++it; it != last && static_cast<unsigned>(*it - '0') < 10; ++it)
+                {
+                    has_digits = true;
+                    if (mantissa != 0 || *it != '0')
+                    {
+                        mantissa = mantissa * 10 + static_cast<unsigned>(*it - '0');
+                        ++nb_digits;
+                    }
+                    --exponent;
+                }
+            }
+            if (has_digits && it != last && (*it == 'e' || *it == 'E'))
+            {
+                ++it;
+                bool negative_exponent = it != last && *it == '-';
+                if (it != last && (*it == '-' || *it == '+'))
+                {
+                    ++it;
+                }
+                int e = 0;
+                bool has_exponent = false;
+                for (; it != last && static_cast<unsigned>(*it - '0') < 10; ++it)
+                {
+                    has_exponent = true;
+                    e = std::min(e * 10 + (*it - '0'), 100000);
+                }
+                has_digits = has_exponent;
+                exponent += negative_exponent ? -e : e;
+            }
+
+            if (!has_digits || it != last || nb_digits > 19)
+            {
+                return parse_csv_floating_fallback(t, res);
+            }
+            if (mantissa == 0)
+            {
+                res = negative ? -T(0) : T(0);
+                return true;
+            }
+            if (mantissa > (std::uint64_t(1) << 53) || exponent < -22 || exponent > 22)
+            {
+                return parse_csv_floating_fallback(t, res);
+            }
+            double value = static_cast<double>(mantissa);
+            value = exponent < 0 ? value / powers[-exponent] : value * powers[exponent];
+            res = static_cast<T>(negative ? -value : value);
+            return true;
+        }
+
+        /**
+         * Parses a value field. Returns false if the field denotes a missing
+         * value, that is if it is empty, NA, N/A, NaN or nan.
+         */
+        template <class T>
+        inline bool parse_csv_value(const char* first, const char* last, T& res)
+        {
+            xcsv_token t = make_csv_token(first, last);
+            if (is_csv_missing(t))
+            {
+                res = T();
+                return false;
+            }
+            if (!parse_csv_number(t, res, std::is_integral<T>()))
+            {
+                throw std::runtime_error("Invalid value in CSV file: " + std::string(t.p_first, t.m_size));
+            }
+            return true;
+        }
+
+        /**
+         * Adds the axis of a dimension to coordinates. The labels are integers
+         * if all of them are canonical integers fitting in an int, strings
+         * otherwise.
+         */
+        template <class M>
+        inline void add_csv_axis(M& coordinates, const fstring& name, const std::vector<xcsv_token>& labels)
+        {
+            std::vector<int> int_labels(labels.size());
+            bool integral = true;
+            for (std::size_t i = 0; i < labels.size() && integral; ++i)
+            {
+                bool negative = false;
+                std::uint64_t magnitude = 0;
+                integral = parse_csv_integer(labels[i], true, negative, magnitude) &&
+                           to_csv_integral(negative, magnitude, int_labels[i]);
+            }
+            if (integral)
+            {
+                coordinates.emplace(name, xaxis<int, std::size_t>(std::move(int_labels)));
+            }
+            else
+            {
+                std::vector<XFRAME_STRING_LABEL> string_labels;
+                string_labels.reserve(labels.size());
+                for (const auto& t : labels)
+                {
+                    string_labels.emplace_back(t.p_first, t.m_size);
+                }
+                coordinates.emplace(name, xaxis<XFRAME_STRING_LABEL, std::size_t>(std::move(string_labels)));
+            }
+        }
+
+        /**
+         * Lines of a chunk of a CSV file, and the labels of the lines resolved
+         * into identifiers local to the chunk.
+         */
+        struct xcsv_chunk
+        {
+            std::vector<xcsv_dictionary> m_dictionaries;
+            std::vector<std::vector<xcsv_token>> m_labels;
+            std::vector<std::uint32_t> m_ids;
+            std::vector<xcsv_token> m_lines;
+            std::vector<std::size_t> m_rows;
+        };
+
+        /**
+         * Reads the names of the columns on the first non-empty line of
+         * [first, last), and moves first past that line.
+         */
+        inline std::vector<xcsv_token> read_csv_header(const char*& first, const char* last, char delimiter)
+        {
+            if (last - first >= 3 && std::memcmp(first, "\xEF\xBB\xBF", 3) == 0)
+            {
+                first += 3;
+            }
+            std::vector<xcsv_token> res;
+            while (first != last && res.empty())
+            {
+                const void* eol = std::memchr(first, '\n', static_cast<std::size_t>(last - first));
+                const char* next = eol != nullptr ? static_cast<const char*>(eol) + 1 : last;
+                for_each_csv_line(first, next, [&res, delimiter](const char* line_first, const char* line_last)
+                {
+                    for_each_csv_field(line_first, line_last, delimiter, [&res](std::size_t, const char* f, const char* l)
+                    {
+                        res.push_back(make_csv_token(f, l));
+                        return true;
+                    });
+                });
+                first = next;
+            }
+            if (res.empty())
+            {
+                throw std::runtime_error("Missing header in CSV file");
+            }
+            return res;
+        }
+
+        inline std::size_t find_csv_column(const std::vector<xcsv_token>& header, const fstring& name)
+        {
+            auto iter = std::find_if(header.cbegin(), header.cend(), [&name](const xcsv_token& t)
+            {
+                return t.m_size == name.size() && std::memcmp(t.p_first, name.data(), t.m_size) == 0;
+            });
+            if (iter == header.cend())
+            {
+                throw std::out_of_range("invalid column name in read_csv: " + std::string(name.data(), name.size()));
+            }
+            return static_cast<std::size_t>(iter - header.cbegin());
+        }
+
+        /**
+         * Reads the lines of [first, last). The labels of the lines are resolved
+         * in parallel by chunks of lines, then merged in the order of the file
+         * into the axes of the dimensions. The values are then parsed in
+         * parallel into the data of the variable, whose shape is known.
+         */
+        template <class T>
+        inline xvariable<T, xcoordinate<fstring>> read_csv_lines(const char* first, const char* last, char delimiter,
+                                                                 const std::vector<xcsv_token>& header,
+                                                                 const std::vector<fstring>& label_columns,
+                                                                 const std::vector<std::size_t>& value_positions,
+                                                                 const fstring* column_dimension)
+        {
+            using variable_type = xvariable<T, xcoordinate<fstring>>;
+            using coordinate_map = typename variable_type::coordinate_map;
+            using dimension_list = typename variable_type::dimension_list;
+            using data_type = typename variable_type::data_type;
+
+            static_assert(std::is_arithmetic<T>::value && !std::is_same<T, bool>::value,
+                          "read_csv requires a numeric value type");
+
+            std::size_t nb_labels = label_columns.size();
+            std::size_t nb_values = value_positions.size();
+            if (nb_labels == 0)
+            {
+                throw std::runtime_error("read_csv requires at least one label column");
+            }
+            std::vector<std::size_t> label_index(header.size(), csv_npos);
+            std::vector<std::size_t> value_index(header.size(), csv_npos);
+            for (std::size_t k = 0; k < nb_labels; ++k)
+            {
+                std::size_t column = find_csv_column(header, label_columns[k]);
+                if (label_index[column] != csv_npos)
+                {
+                    throw std::runtime_error("Duplicate label column in read_csv");
+                }
+                label_index[column] = k;
+            }
+            for (std::size_t j = 0; j < nb_values; ++j)
+            {
+                if (label_index[value_positions[j]] != csv_npos)
+                {
+                    throw std::runtime_error("A column of read_csv cannot hold both labels and values");
+                }
+                value_index[value_positions[j]] = j;
+            }
+
+            // Resolves the labels of each chunk into local identifiers
+            std::size_t nb_threads = get_num_threads();
+            std::vector<const char*> bounds = split_csv_chunks(first, last, nb_threads);
+            std::size_t nb_chunks = bounds.size() - 1;
+            std::vector<xcsv_chunk> chunks(nb_chunks);
+            xthread_pool::instance().run(nb_chunks, nb_threads, [&](std::size_t c)
+            {
+                xcsv_chunk& chunk = chunks[c];
+                chunk.m_dictionaries.resize(nb_labels);
+                chunk.m_labels.resize(nb_labels);
+                for_each_csv_line(bounds[c], bounds[c + 1], [&](const char* line_first, const char* line_last)
+                {
+                    chunk.m_lines.push_back(xcsv_token{ line_first, static_cast<std::size_t>(line_last - line_first) });
+                    std::size_t offset = chunk.m_ids.size();
+                    chunk.m_ids.resize(offset + nb_labels);
+                    std::size_t nb_found = 0;
+                    for_each_csv_field(line_first, line_last, delimiter, [&](std::size_t column, const char* f, const char* l)
+                    {
+                        std::size_t k = column < label_index.size() ? label_index[column] : csv_npos;
+                        if (k != csv_npos)
+                        {
+                            xcsv_token t = make_csv_token(f, l);
+                            auto inserted = chunk.m_dictionaries[k].insert(t, static_cast<std::uint32_t>(chunk.m_labels[k].size()));
+                            if (inserted.second)
+                            {
+                                chunk.m_labels[k].push_back(t);
+                            }
+                            chunk.m_ids[offset + k] = *(inserted.first);
+                            ++nb_found;
+                        }
+                        return nb_found != nb_labels;
+                    });
+                    if (nb_found != nb_labels)
+                    {
+                        throw std::runtime_error("Missing label field in CSV file");
+                    }
+                });
+            });
+
+            // Merges the labels of the chunks in the order of the file
+            std::vector<std::vector<xcsv_token>> labels(nb_labels);
+            std::vector<std::vector<std::vector<std::uint32_t>>> translations(nb_chunks, std::vector<std::vector<std::uint32_t>>(nb_labels));
+            for (std::size_t k = 0; k < nb_labels; ++k)
+            {
+                xcsv_dictionary dictionary;
+                for (std::size_t c = 0; c < nb_chunks; ++c)
+                {
+                    auto& translation = translations[c][k];
+                    for (const auto& t : chunks[c].m_labels[k])
+                    {
+                        auto inserted = dictionary.insert(t, static_cast<std::uint32_t>(labels[k].size()));
+                        if (inserted.second)
+                        {
+                            labels[k].push_back(t);
+                        }
+                        translation.push_back(*(inserted.first));
+                    }
+                    chunks[c].m_dictionaries[k].clear();
+                }
+            }
+
+            // Computes the row of each line in the data, checking that no two
+            // lines have the same labels
+            std::vector<std::size_t> row_strides(nb_labels, std::size_t(1));
+            for (std::size_t k = nb_labels - 1; k != 0; --k)
+            {
+                row_strides[k - 1] = row_strides[k] * labels[k].size();
+            }
+            std::size_t nb_rows = row_strides[0] * labels[0].size();
+            std::vector<std::uint8_t> seen(nb_rows, std::uint8_t(0));
+            for (std::size_t c = 0; c < nb_chunks; ++c)
+            {
+                xcsv_chunk& chunk = chunks[c];
+                std::size_t nb_lines = chunk.m_lines.size();
+                chunk.m_rows.resize(nb_lines);
+                for (std::size_t i = 0; i < nb_lines; ++i)
+                {
+                    std::size_t row = 0;
+                    for (std::size_t k = 0; k < nb_labels; ++k)
+                    {
+                        row += translations[c][k][chunk.m_ids[i * nb_labels + k]] * row_strides[k];
+                    }
+                    if (seen[row] != 0)
+                    {
+                        throw std::runtime_error("Duplicate labels in CSV file");
+                    }
+                    seen[row] = 1;
+                    chunk.m_rows[i] = row;
+                }
+            }
+
+            coordinate_map coordinates;
+            dimension_list dimensions;
+            for (std::size_t k = 0; k < nb_labels; ++k)
+            {
+                add_csv_axis(coordinates, label_columns[k], labels[k]);
+                dimensions.push_back(label_columns[k]);
+            }
+            if (column_dimension != nullptr)
+            {
+                if (std::find(label_columns.cbegin(), label_columns.cend(), *column_dimension) != label_columns.cend())
+                {
+                    throw std::runtime_error("The column dimension of read_wide_csv cannot be a label column");
+                }
+                std::vector<xcsv_token> column_labels;
+                xcsv_dictionary dictionary;
+                for (std::size_t j = 0; j < nb_values; ++j)
+                {
+                    const xcsv_token& t = header[value_positions[j]];
+                    if (!dictionary.insert(t, static_cast<std::uint32_t>(j)).second)
+                    {
+                        throw std::runtime_error("Duplicate column names in CSV file");
+                    }
+                    column_labels.push_back(t);
+                }
+                add_csv_axis(coordinates, *column_dimension, column_labels);
+                dimensions.push_back(*column_dimension);
+            }
+
+            // Parses the values into the data of the variable
+            variable_type res(std::move(coordinates), std::move(dimensions));
+            data_type& data = res.data();
+            T* values = data.value().data();
+            std::fill(values, values + data.value().size(), T());
+            xflag_writer<std::decay_t<decltype(data.has_value())>> flags(data.has_value());
+            xthread_pool::instance().run(nb_chunks, nb_threads, [&](std::size_t c)
+            {
+                const xcsv_chunk& chunk = chunks[c];
+                for (std::size_t i = 0; i < chunk.m_lines.size(); ++i)
+                {
+                    const xcsv_token& line = chunk.m_lines[i];
+                    std::size_t offset = chunk.m_rows[i] * nb_values;
+                    std::size_t nb_found = 0;
+                    for_each_csv_field(line.p_first, line.p_first + line.m_size, delimiter,
+                        [&](std::size_t column, const char* f, const char* l)
+                    {
+                        std::size_t j = column < value_index.size() ? value_index[column] : csv_npos;
+                        if (j != csv_npos)
+                        {
+                            flags.set(offset + j, parse_csv_value(f, l, values[offset + j]));
+                            ++nb_found;
+                        }
+                        return nb_found != nb_values;
+                    });
+                    if (nb_found != nb_values)
+                    {
+                        throw std::runtime_error("Missing value field in CSV file");
+                    }
+                }
+            });
+            flags.finalize();
+            return res;
+        }
+    }
+
+    /**
+     * @brief Reads a CSV file in long format.
+     *
+     * Each line of the file holds the labels of an element in the columns
+     * \c label_columns, and its value in the column \c value_column. The
+     * variable has a dimension per label column, named after the column, whose
+     * labels are those of the column in the order of their first occurrence
+     * in the file; the labels are integers if all of them are integers, strings
+     * otherwise. Elements whose labels do not appear on any line are missing,
+     * and two lines cannot have the same labels.
+     *
+     * The first line of the file holds the names of the columns. Fields are
+     * separated by \c delimiter and cannot be quoted; empty fields and NA, N/A,
+     * NaN or nan values denote missing values. The file is mapped in memory and
+     * parsed by chunks of lines, concurrently if several threads are available,
+     * see set_num_threads.
+     * @param path the path of the file.
+     * @param label_columns the names of the columns holding the labels.
+     * @param value_column the name of the column holding the values.
+     * @param delimiter the character separating the fields.
+     * @tparam T the type of the values.
+     * @sa read_wide_csv
+     */
+    template <class T>
+    inline xvariable<T, xcoordinate<fstring>> read_csv(const std::string& path,
+                                                       const std::vector<fstring>& label_columns,
+                                                       const fstring& value_column,
+                                                       char delimiter)
+    {
+        detail::xcsv_file file(path);
+        const char* first = file.begin();
+        auto header = detail::read_csv_header(first, file.end(), delimiter);
+        std::vector<std::size_t> value_positions(1, detail::find_csv_column(header, value_column));
+        return detail::read_csv_lines<T>(first, file.end(), delimiter, header, label_columns, value_positions, nullptr);
+    }
+
+    /**
+     * @brief Reads a CSV file in wide format.
+     *
+     * Each line of the file holds labels in the columns \c label_columns, and
+     * values in all the other columns. The variable has a dimension per label
+     * column, as in read_csv, followed by the dimension \c column_dimension
+     * whose labels are the names of the other columns.
+     * @param path the path of the file.
+     * @param label_columns the names of the columns holding the labels.
+     * @param column_dimension the name of the dimension of the value columns.
+     * @param delimiter the character separating the fields.
+     * @tparam T the type of the values.
+     * @sa read_csv
+     */
+    template <class T>
+    inline xvariable<T, xcoordinate<fstring>> read_wide_csv(const std::string& path,
+                                                            const std::vector<fstring>& label_columns,
+                                                            const fstring& column_dimension,
+                                                            char delimiter)
+    {
+        detail::xcsv_file file(path);
+        const char* first = file.begin();
+        auto header = detail::read_csv_header(first, file.end(), delimiter);
+        std::vector<bool> is_label(header.size(), false);
+        for (const auto& name : label_columns)
+        {
+            is_label[detail::find_csv_column(header, name)] = true;
+        }
+        std::vector<std::size_t> value_positions;
+        for (std::size_t column = 0; column < header.size(); ++column)
+        {
+            if (!is_label[column])
+            {
+                value_positions.push_back(column);
+            }
+        }
+        return detail::read_csv_lines<T>(first, file.end(), delimiter, header, label_columns, value_positions, &column_dimension);
+    }
+}
+
+#endif
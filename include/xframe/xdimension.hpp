@@ -233,6 +233,7 @@ namespace xf
     template <class... Args>
     inline bool xdimension<L, T>::broadcast(const Args&... dims)
     {
+        XFRAME_TRACE_SCOPE(broadcast_dimensions)
         return this->empty() ? broadcast_empty(dims...) : broadcast_impl(dims...);
     }
 
@@ -240,9 +241,7 @@ namespace xf
     template <class... Args>
     inline bool xdimension<L, T>::broadcast_impl(const self_type& a, const Args&... dims)
     {
-        XFRAME_TRACE_BROADCAST_DIMENSIONS(*this, a);
         bool res = base_type::merge_unsorted(true, a.labels());
-        XFRAME_TRACE_DIMENSIONS_RESULT(*this, res);
         res &= broadcast_impl(dims...);
         return res;
     }
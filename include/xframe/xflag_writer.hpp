@@ -0,0 +1,125 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XFLAG_WRITER_HPP
+#define XFRAME_XFLAG_WRITER_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "xbitmap.hpp"
+#include "xparallel.hpp"
+
+namespace xf
+{
+    namespace detail
+    {
+        /****************
+         * xflag_writer *
+         ****************/
+
+        /**
+         * Writes the validity flags of the data of a variable from several
+         * threads. Arrays of bool are written directly.
+         */
+        template <class FE>
+        class xflag_writer
+        {
+        public:
+
+            explicit xflag_writer(FE& flags);
+
+            void set(std::size_t i, bool value) noexcept;
+            void finalize();
+
+        private:
+
+            bool* p_flags;
+        };
+
+        /**
+         * Validity bitmaps are written as bytes, since a word of the bitmap
+         * may hold the flags of elements written by different threads; the
+         * bytes are packed by finalize once all the flags are written.
+         */
+        template <>
+        class xflag_writer<xbitmap_array>
+        {
+        public:
+
+            explicit xflag_writer(xbitmap_array& flags);
+
+            void set(std::size_t i, bool value) noexcept;
+            void finalize();
+
+        private:
+
+            xbitmap_storage& m_flags;
+            std::vector<std::uint8_t> m_bytes;
+        };
+
+        /*******************************
+         * xflag_writer implementation *
+         *******************************/
+
+        template <class FE>
+        inline xflag_writer<FE>::xflag_writer(FE& flags)
+            : p_flags(flags.data())
+        {
+            std::fill(p_flags, p_flags + flags.size(), false);
+        }
+
+        template <class FE>
+        inline void xflag_writer<FE>::set(std::size_t i, bool value) noexcept
+        {
+            p_flags[i] = value;
+        }
+
+        template <class FE>
+        inline void xflag_writer<FE>::finalize()
+        {
+        }
+
+        inline xflag_writer<xbitmap_array>::xflag_writer(xbitmap_array& flags)
+            : m_flags(flags.storage()), m_bytes(flags.size(), std::uint8_t(0))
+        {
+        }
+
+        inline void xflag_writer<xbitmap_array>::set(std::size_t i, bool value) noexcept
+        {
+            m_bytes[i] = static_cast<std::uint8_t>(value);
+        }
+
+        inline void xflag_writer<xbitmap_array>::finalize()
+        {
+            using word_type = xbitmap_storage::word_type;
+            constexpr std::size_t word_bits = xbitmap_storage::word_bits;
+            std::size_t size = m_bytes.size();
+            word_type* words = m_flags.words();
+            parallel_for_rows(m_flags.word_count(), word_bits, std::size_t(1), [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t w = begin; w < end; ++w)
+                {
+                    word_type word = 0;
+                    std::size_t nb_bits = std::min(word_bits, size - w * word_bits);
+                    for (std::size_t b = 0; b < nb_bits; ++b)
+                    {
+                        word |= word_type(m_bytes[w * word_bits + b]) << b;
+                    }
+                    words[w] = word;
+                }
+            });
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,371 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XFLAT_HASH_MAP_HPP
+#define XFRAME_XFLAT_HASH_MAP_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace xf
+{
+    /******************
+     * xflat_hash_map *
+     ******************/
+
+    /**
+     * @class xflat_hash_map
+     * @brief Open addressing hash map.
+     *
+     * The xflat_hash_map class is a hash map based on open addressing with
+     * Robin Hood linear probing. Keys, values and probe distances are stored
+     * in separate contiguous arrays, so that filling the map does not require
+     * any allocation once it has been reserved and lookups do not chase
+     * pointers. It is the index used by axes built with the \c flat_hash_map_tag.
+     *
+     * Probe distances are stored on a byte. Elements farther than 255 slots
+     * from their home slot, which only happen with degenerate hash functions,
+     * are stored with a saturated distance and found by a plain linear probe,
+     * so that the size of the map is only driven by its load factor.
+     *
+     * Elements cannot be erased individually.
+     *
+     * @tparam K the type of the keys.
+     * @tparam T the type of the mapped values.
+     * @tparam H the hash function.
+     * @tparam E the equality comparison function for keys.
+     */
+    template <class K, class T, class H = std::hash<K>, class E = std::equal_to<K>>
+    class xflat_hash_map
+    {
+    public:
+
+        using key_type = K;
+        using mapped_type = T;
+        using hasher = H;
+        using key_equal = E;
+        using size_type = std::size_t;
+
+        explicit xflat_hash_map(const hasher& hash = hasher(), const key_equal& equal = key_equal());
+
+        bool empty() const noexcept;
+        size_type size() const noexcept;
+        size_type bucket_count() const noexcept;
+
+        void clear() noexcept;
+        void reserve(size_type count);
+
+        std::pair<mapped_type*, bool> insert(const key_type& key, const mapped_type& value);
+        mapped_type& operator[](const key_type& key);
+
+        const mapped_type* find(const key_type& key) const;
+        size_type count(const key_type& key) const;
+        const mapped_type& at(const key_type& key) const;
+
+    private:
+
+        using distance_type = std::uint8_t;
+        static constexpr unsigned max_distance = 255u;
+        static constexpr size_type npos = ~size_type(0);
+
+        size_type bucket(const key_type& key) const;
+        size_type find_index(const key_type& key) const;
+        size_type capacity_for(size_type count) const noexcept;
+        bool must_grow(size_type count) const noexcept;
+        void rehash(size_type capacity);
+        size_type insert_new(key_type key, mapped_type value);
+
+        std::vector<key_type> m_keys;
+        std::vector<mapped_type> m_values;
+        std::vector<distance_type> m_distances;
+        size_type m_size;
+        size_type m_mask;
+        unsigned m_shift;
+        hasher m_hash;
+        key_equal m_equal;
+    };
+
+    /*********************************
+     * xflat_hash_map implementation *
+     *********************************/
+
+    template <class K, class T, class H, class E>
+    constexpr unsigned xflat_hash_map<K, T, H, E>::max_distance;
+
+    template <class K, class T, class H, class E>
+    constexpr typename xflat_hash_map<K, T, H, E>::size_type xflat_hash_map<K, T, H, E>::npos;
+
+    /**
+     * Constructs an empty map. No memory is allocated.
+     * @param hash the hash function.
+     * @param equal the equality comparison function.
+     */
+    template <class K, class T, class H, class E>
+    inline xflat_hash_map<K, T, H, E>::xflat_hash_map(const hasher& hash, const key_equal& equal)
+        : m_keys(), m_values(), m_distances(), m_size(0), m_mask(0), m_shift(0),
+          m_hash(hash), m_equal(equal)
+    {
+    }
+
+    /**
+     * Returns true if the map holds no element.
+     */
+    template <class K, class T, class H, class E>
+    inline bool xflat_hash_map<K, T, H, E>::empty() const noexcept
+    {
+        return m_size == 0;
+    }
+
+    /**
+     * Returns the number of elements in the map.
+     */
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::size() const noexcept -> size_type
+    {
+        return m_size;
+    }
+
+    /**
+     * Returns the number of slots in the map.
+     */
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::bucket_count() const noexcept -> size_type
+    {
+        return m_distances.size();
+    }
+
+    /**
+     * Removes all the elements of the map. The memory is not released, so
+     * that the map can be refilled without any allocation.
+     */
+    template <class K, class T, class H, class E>
+    inline void xflat_hash_map<K, T, H, E>::clear() noexcept
+    {
+        std::fill(m_distances.begin(), m_distances.end(), distance_type(0));
+        m_size = 0;
+    }
+
+    /**
+     * Reserves enough slots for holding \c count elements without
+     * rehashing.
+     * @param count the number of elements.
+     */
+    template <class K, class T, class H, class E>
+    inline void xflat_hash_map<K, T, H, E>::reserve(size_type count)
+    {
+        size_type capacity = capacity_for(count);
+        if (capacity > bucket_count())
+        {
+            rehash(capacity);
+        }
+    }
+
+    /**
+     * Inserts the specified key - value pair if the map does not already
+     * contain the key.
+     * @param key the key of the element to insert.
+     * @param value the value of the element to insert.
+     * @return a pair made of a pointer to the value mapped to \c key and
+     *         of a boolean which is true if the element has been inserted.
+     */
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::insert(const key_type& key, const mapped_type& value)
+        -> std::pair<mapped_type*, bool>
+    {
+        size_type index = find_index(key);
+        if (index != npos)
+        {
+            return std::make_pair(&m_values[index], false);
+        }
+        if (must_grow(m_size + 1))
+        {
+            rehash(std::max(size_type(8), 2 * bucket_count()));
+        }
+        index = insert_new(key, value);
+        return std::make_pair(&m_values[index], true);
+    }
+
+    /**
+     * Returns a reference to the value mapped to \c key, inserting a
+     * value-initialized element if the key does not exist.
+     * @param key the key of the element to find.
+     */
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::operator[](const key_type& key) -> mapped_type&
+    {
+        return *(insert(key, mapped_type()).first);
+    }
+
+    /**
+     * Returns a pointer to the value mapped to \c key, or \c nullptr if
+     * the map does not contain the key.
+     * @param key the key of the element to find.
+     */
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::find(const key_type& key) const -> const mapped_type*
+    {
+        size_type index = find_index(key);
+        return index != npos ? &m_values[index] : nullptr;
+    }
+
+    /**
+     * Returns the number of elements with key \c key, i.e. 0 or 1.
+     * @param key the key of the element to count.
+     */
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::count(const key_type& key) const -> size_type
+    {
+        return find(key) != nullptr ? size_type(1) : size_type(0);
+    }
+
+    /**
+     * Returns the value mapped to \c key. If the map does not contain
+     * this key, an exception is thrown.
+     * @param key the key of the element to find.
+     */
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::at(const key_type& key) const -> const mapped_type&
+    {
+        const mapped_type* value = find(key);
+        if (value == nullptr)
+        {
+            throw std::out_of_range("invalid xflat_hash_map key");
+        }
+        return *value;
+    }
+
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::bucket(const key_type& key) const -> size_type
+    {
+        // Fibonacci hashing spreads the bits of trivial hash functions,
+        // such as the identity used for integers by the standard library.
+        std::uint64_t h = static_cast<std::uint64_t>(m_hash(key));
+        return static_cast<size_type>((h * 0x9E3779B97F4A7C15ull) >> m_shift);
+    }
+
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::find_index(const key_type& key) const -> size_type
+    {
+        if (m_size == 0)
+        {
+            return npos;
+        }
+        size_type index = bucket(key);
+        unsigned distance = 1;
+        while (true)
+        {
+            // The element in this slot would have been displaced by
+            // the key if it were closer to its home slot. Saturated
+            // distances are only known to be at least max_distance.
+            unsigned stored = m_distances[index];
+            if (stored < std::min(distance, max_distance))
+            {
+                return npos;
+            }
+            if ((stored == distance || stored == max_distance) && m_equal(m_keys[index], key))
+            {
+                return index;
+            }
+            index = (index + 1) & m_mask;
+            ++distance;
+        }
+    }
+
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::capacity_for(size_type count) const noexcept -> size_type
+    {
+        size_type capacity = 8;
+        while (capacity * 7 < count * 8)
+        {
+            capacity *= 2;
+        }
+        return capacity;
+    }
+
+    template <class K, class T, class H, class E>
+    inline bool xflat_hash_map<K, T, H, E>::must_grow(size_type count) const noexcept
+    {
+        return count * 8 > bucket_count() * 7;
+    }
+
+    template <class K, class T, class H, class E>
+    inline void xflat_hash_map<K, T, H, E>::rehash(size_type capacity)
+    {
+        std::vector<key_type> keys(capacity);
+        std::vector<mapped_type> values(capacity);
+        std::vector<distance_type> distances(capacity, distance_type(0));
+        keys.swap(m_keys);
+        values.swap(m_values);
+        distances.swap(m_distances);
+
+        m_size = 0;
+        m_mask = capacity - 1;
+        unsigned bits = 0;
+        while ((size_type(1) << bits) < capacity)
+        {
+            ++bits;
+        }
+        m_shift = 64u - bits;
+
+        for (size_type i = 0; i < distances.size(); ++i)
+        {
+            if (distances[i] != 0)
+            {
+                insert_new(std::move(keys[i]), std::move(values[i]));
+            }
+        }
+    }
+
+    // Returns the slot of the inserted key. The map must have
+    // room for the new element.
+    template <class K, class T, class H, class E>
+    inline auto xflat_hash_map<K, T, H, E>::insert_new(key_type key, mapped_type value) -> size_type
+    {
+        size_type index = bucket(key);
+        size_type res = npos;
+        unsigned distance = 1;
+        while (true)
+        {
+            distance_type stored_distance = static_cast<distance_type>(std::min(distance, max_distance));
+            if (m_distances[index] == 0)
+            {
+                m_keys[index] = std::move(key);
+                m_values[index] = std::move(value);
+                m_distances[index] = stored_distance;
+                ++m_size;
+                return res != npos ? res : index;
+            }
+            if (m_distances[index] < stored_distance)
+            {
+                // Robin Hood: the element closer to its home slot
+                // gives its place and goes on probing. Its distance
+                // is not saturated since it is less than max_distance.
+                distance_type displaced_distance = m_distances[index];
+                std::swap(m_keys[index], key);
+                std::swap(m_values[index], value);
+                m_distances[index] = stored_distance;
+                distance = displaced_distance;
+                if (res == npos)
+                {
+                    res = index;
+                }
+            }
+            index = (index + 1) & m_mask;
+            ++distance;
+        }
+    }
+}
+
+#endif
@@ -21,9 +21,20 @@ namespace xf
     using fstring = xtl::xfixed_string<55>;
 }
 
+// Defining XFRAME_ENABLE_STRING_DICTIONARY to 1 makes string labels
+// dictionary-encoded 32-bit codes instead of fixed strings
+#ifndef XFRAME_ENABLE_STRING_DICTIONARY
+#define XFRAME_ENABLE_STRING_DICTIONARY 0
+#endif
+
 #ifndef XFRAME_STRING_LABEL
+#if XFRAME_ENABLE_STRING_DICTIONARY
+#include "xstring_label.hpp"
+#define XFRAME_STRING_LABEL xf::xstring_label
+#else
 #define XFRAME_STRING_LABEL xf::fstring
 #endif
+#endif
 
 #ifndef XFRAME_DEFAULT_LABEL_LIST
 #include <cstddef>
@@ -35,23 +46,48 @@ namespace xf
 #define XFRAME_DEFAULT_JOIN join::inner
 #endif
 
+// Defining XFRAME_ENABLE_BITMAP_MASK to 1 makes the default data container
+// store missing values in a packed validity bitmap instead of an array of bool
+#ifndef XFRAME_ENABLE_BITMAP_MASK
+#define XFRAME_ENABLE_BITMAP_MASK 0
+#endif
+
 #ifndef XFRAME_DEFAULT_DATA_CONTAINER
 #include "xtensor/xarray.hpp"
 #include "xtensor/xoptional_assembly.hpp"
+#if XFRAME_ENABLE_BITMAP_MASK
+#include "xbitmap.hpp"
+#define XFRAME_DEFAULT_DATA_CONTAINER(T) xt::xoptional_assembly<xt::xarray<T>, xf::xbitmap_array>
+#else
 #define XFRAME_DEFAULT_DATA_CONTAINER(T) xt::xoptional_assembly<xt::xarray<T>, xt::xarray<bool>>
 #endif
+#endif
 
 // A higher number leads to an ICE on VS 2015
 #ifndef XFRAME_STATIC_DIMENSION_LIMIT
 #define XFRAME_STATIC_DIMENSION_LIMIT 4
 #endif
 
+// Number of threads used for assigning variables, see xf::set_num_threads
+#ifndef XFRAME_DEFAULT_NUM_THREADS
+#define XFRAME_DEFAULT_NUM_THREADS 1
+#endif
+
+// Maximum number of broadcast coordinates kept in the cache of each
+// coordinate type, see xf::set_broadcast_cache_capacity
+#ifndef XFRAME_BROADCAST_CACHE_CAPACITY
+#define XFRAME_BROADCAST_CACHE_CAPACITY 128
+#endif
+
+// Compiles the instrumentation of the trace, which is enabled at runtime
+// with xf::set_trace_enabled
 #ifndef XFRAME_ENABLE_TRACE
-#define XFRAME_ENABLE_TRACE 0
+#define XFRAME_ENABLE_TRACE 1
 #endif
 
-#ifndef XFRAME_OUT
-#define XFRAME_OUT std::cout
+// Maximum number of events recorded for the Chrome trace
+#ifndef XFRAME_TRACE_BUFFER_CAPACITY
+#define XFRAME_TRACE_BUFFER_CAPACITY 65536
 #endif
 
 #endif
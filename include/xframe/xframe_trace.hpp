@@ -11,45 +11,396 @@
 #ifndef XFRAME_XFRAME_TRACE_HPP
 #define XFRAME_XFRAME_TRACE_HPP
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
 #include <string>
+#include <vector>
 
 #include "xframe_config.hpp"
 
 namespace xf
 {
+    /****************
+     * trace events *
+     ****************/
 
-#if XFRAME_ENABLE_TRACE
+    /**
+     * Operations timed by the trace.
+     */
+    enum class trace_event : std::size_t
+    {
+        broadcast_coordinates = 0,
+        broadcast_dimensions,
+        resize,
+        assign_data,
+        populate_index,
+        reindex
+    };
 
-#define XFRAME_TRACE(expr) XFRAME_OUT << expr << std::endl;
+    constexpr std::size_t trace_event_count = 6;
 
-#define XFRAME_TRACE_BROADCAST_DIMENSIONS(lhs, rhs)             \
-    XFRAME_TRACE("BROADCASTING DIMENSIONS");                    \
-    XFRAME_TRACE("lhs = " << lhs);                              \
-    XFRAME_TRACE("rhs = " << rhs);
+    const char* trace_event_name(trace_event e) noexcept;
 
-#define XFRAME_TRACE_DIMENSIONS_RESULT(res, trivial)            \
-    XFRAME_TRACE("res = " << res);                              \
-    XFRAME_TRACE("trivial broadcasting = " << trivial);
+    /*******************
+     * xtrace_snapshot *
+     *******************/
 
-#define XFRAME_TRACE_BROADCAST_COORDINATES(lhs, rhs)            \
-    XFRAME_TRACE("BROADCASTING COORDINATES");                   \
-    XFRAME_TRACE("lhs:")                                        \
-    XFRAME_OUT << lhs;                                          \
-    XFRAME_TRACE("rhs:")                                        \
-    XFRAME_OUT << rhs;
+    struct xtrace_timer_statistics
+    {
+        std::size_t m_count;
+        std::uint64_t m_total_ns;
+        std::uint64_t m_max_ns;
+    };
 
-#define XFRAME_TRACE_COORDINATES_RESULT(res, trivial)           \
-    XFRAME_TRACE("res:")                                        \
-    XFRAME_OUT << res;                                          \
-    XFRAME_TRACE("trivial broadcasting = (" << trivial.m_same_dimensions << ", " << trivial.m_same_labels << ")");
-#else
-#define XFRAME_TRACE(expr)
-#define XFRAME_TRACE_BROADCAST_DIMENSIONS(lhs, rhs)
-#define XFRAME_TRACE_DIMENSIONS_RESULT(res, trivial)
-#define XFRAME_TRACE_BROADCAST_COORDINATES(lhs, rhs)
-#define XFRAME_TRACE_COORDINATES_RESULT(res, trivial)
-#endif
+    /**
+     * @class xtrace_snapshot
+     * @brief Values of the trace counters at a given time.
+     *
+     * The xtrace_snapshot class holds the number of calls and the time spent
+     * in each traced operation, the number of trivial and non trivial
+     * broadcasts of assigned expressions, and an estimate of the number of
+     * bytes allocated when resizing variables.
+     */
+    struct xtrace_snapshot
+    {
+        std::array<xtrace_timer_statistics, trace_event_count> m_timers;
+        std::size_t m_trivial_broadcasts;
+        std::size_t m_non_trivial_broadcasts;
+        std::size_t m_allocated_bytes;
+        std::size_t m_dropped_events;
+
+        const xtrace_timer_statistics& operator[](trace_event e) const noexcept;
+    };
+
+    bool is_trace_enabled() noexcept;
+    void set_trace_enabled(bool enabled) noexcept;
+
+    xtrace_snapshot trace_snapshot() noexcept;
+    void reset_trace();
+
+    void write_chrome_trace(std::ostream& out);
+
+    /****************
+     * xtrace_timer *
+     ****************/
+
+    /**
+     * @class xtrace_timer
+     * @brief Times an operation until the end of a scope.
+     *
+     * When the trace is enabled, the xtrace_timer class adds the time
+     * elapsed between its construction and its destruction to the
+     * statistics of an operation, and records it as an event of the
+     * Chrome trace. Otherwise, it does nothing.
+     */
+    class xtrace_timer
+    {
+    public:
+
+        explicit xtrace_timer(trace_event e) noexcept;
+        xtrace_timer(trace_event e, bool timed) noexcept;
+        ~xtrace_timer();
+
+        xtrace_timer(const xtrace_timer&) = delete;
+        xtrace_timer& operator=(const xtrace_timer&) = delete;
+
+    private:
+
+        trace_event m_event;
+        std::uint64_t m_start;
+        bool m_enabled;
+    };
+
+    namespace detail
+    {
+        void trace_broadcast(bool trivial) noexcept;
+        void trace_allocation(std::size_t bytes) noexcept;
+    }
+
+    /**************************
+     * trace state (internal) *
+     **************************/
+
+    namespace detail
+    {
+        struct xtrace_timer_state
+        {
+            std::atomic<std::size_t> m_count{0};
+            std::atomic<std::uint64_t> m_total_ns{0};
+            std::atomic<std::uint64_t> m_max_ns{0};
+        };
+
+        struct xtrace_record
+        {
+            trace_event m_event;
+            std::size_t m_thread;
+            std::uint64_t m_start_ns;
+            std::uint64_t m_duration_ns;
+        };
+
+        struct xtrace_state
+        {
+            using clock_type = std::chrono::steady_clock;
+
+            std::atomic<bool> m_enabled{false};
+            std::array<xtrace_timer_state, trace_event_count> m_timers;
+            std::atomic<std::size_t> m_trivial_broadcasts{0};
+            std::atomic<std::size_t> m_non_trivial_broadcasts{0};
+            std::atomic<std::size_t> m_allocated_bytes{0};
+            std::atomic<std::size_t> m_dropped_events{0};
+            std::atomic<std::size_t> m_nb_threads{0};
+            clock_type::time_point m_epoch = clock_type::now();
+            std::mutex m_mutex;
+            std::vector<xtrace_record> m_records;
+        };
+
+        inline xtrace_state& trace_state() noexcept
+        {
+            static xtrace_state state;
+            return state;
+        }
+
+        inline std::uint64_t trace_clock() noexcept
+        {
+            auto& state = trace_state();
+            auto elapsed = xtrace_state::clock_type::now() - state.m_epoch;
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+        }
+
+        // Small integer identifying the current thread in the Chrome trace
+        inline std::size_t trace_thread() noexcept
+        {
+            static thread_local std::size_t id = trace_state().m_nb_threads++;
+            return id;
+        }
+
+        inline void trace_record(trace_event e, std::uint64_t start, std::uint64_t duration) noexcept
+        {
+            auto& state = trace_state();
+            auto& timer = state.m_timers[static_cast<std::size_t>(e)];
+            ++timer.m_count;
+            timer.m_total_ns += duration;
+            std::uint64_t max = timer.m_max_ns.load(std::memory_order_relaxed);
+            while (duration > max && !timer.m_max_ns.compare_exchange_weak(max, duration, std::memory_order_relaxed))
+            {
+            }
 
+            std::lock_guard<std::mutex> lock(state.m_mutex);
+            try
+            {
+                if (state.m_records.size() < XFRAME_TRACE_BUFFER_CAPACITY)
+                {
+                    state.m_records.push_back({ e, trace_thread(), start, duration });
+                    return;
+                }
+            }
+            catch (...)
+            {
+            }
+            ++state.m_dropped_events;
+        }
+
+        inline std::string trace_microseconds(std::uint64_t ns)
+        {
+            return std::to_string(ns / 1000) + "." + std::to_string(ns % 1000 + 1000).substr(1);
+        }
+    }
+
+    /*******************************
+     * trace events implementation *
+     *******************************/
+
+    /**
+     * Returns the name of the operation \c e.
+     */
+    inline const char* trace_event_name(trace_event e) noexcept
+    {
+        static const char* names[trace_event_count] = {
+            "broadcast_coordinates",
+            "broadcast_dimensions",
+            "resize",
+            "assign_data",
+            "populate_index",
+            "reindex"
+        };
+        return names[static_cast<std::size_t>(e)];
+    }
+
+    /**********************************
+     * xtrace_snapshot implementation *
+     **********************************/
+
+    /**
+     * Returns the statistics of the operation \c e.
+     */
+    inline const xtrace_timer_statistics& xtrace_snapshot::operator[](trace_event e) const noexcept
+    {
+        return m_timers[static_cast<std::size_t>(e)];
+    }
+
+    /**
+     * Returns true if the trace is enabled.
+     */
+    inline bool is_trace_enabled() noexcept
+    {
+        return detail::trace_state().m_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Enables or disables the trace. The trace is disabled by default; when
+     * it is disabled, instrumented operations only check this flag. Defining
+     * XFRAME_ENABLE_TRACE to 0 removes the instrumentation at compile time.
+     */
+    inline void set_trace_enabled(bool enabled) noexcept
+    {
+        detail::trace_state().m_enabled = enabled;
+    }
+
+    /**
+     * Returns the values of the trace counters since the start of the program
+     * or the last call to reset_trace.
+     */
+    inline xtrace_snapshot trace_snapshot() noexcept
+    {
+        auto& state = detail::trace_state();
+        xtrace_snapshot res;
+        for (std::size_t i = 0; i < trace_event_count; ++i)
+        {
+            const auto& timer = state.m_timers[i];
+            res.m_timers[i] = { timer.m_count.load(), timer.m_total_ns.load(), timer.m_max_ns.load() };
+        }
+        res.m_trivial_broadcasts = state.m_trivial_broadcasts.load();
+        res.m_non_trivial_broadcasts = state.m_non_trivial_broadcasts.load();
+        res.m_allocated_bytes = state.m_allocated_bytes.load();
+        res.m_dropped_events = state.m_dropped_events.load();
+        return res;
+    }
+
+    /**
+     * Resets the trace counters and removes the recorded events.
+     */
+    inline void reset_trace()
+    {
+        auto& state = detail::trace_state();
+        std::lock_guard<std::mutex> lock(state.m_mutex);
+        for (auto& timer : state.m_timers)
+        {
+            timer.m_count = 0;
+            timer.m_total_ns = 0;
+            timer.m_max_ns = 0;
+        }
+        state.m_trivial_broadcasts = 0;
+        state.m_non_trivial_broadcasts = 0;
+        state.m_allocated_bytes = 0;
+        state.m_dropped_events = 0;
+        state.m_records.clear();
+    }
+
+    /**
+     * Writes the recorded events in the Chrome trace event format, which can
+     * be loaded in chrome://tracing or Perfetto. The broadcast and allocation
+     * counters are written as counter events at the end of the trace. At most
+     * XFRAME_TRACE_BUFFER_CAPACITY events are recorded between two calls to
+     * reset_trace.
+     * @param out the stream to write to.
+     */
+    inline void write_chrome_trace(std::ostream& out)
+    {
+        auto& state = detail::trace_state();
+        std::vector<detail::xtrace_record> records;
+        {
+            std::lock_guard<std::mutex> lock(state.m_mutex);
+            records = state.m_records;
+        }
+        xtrace_snapshot snapshot = trace_snapshot();
+        std::string now = detail::trace_microseconds(detail::trace_clock());
+
+        out << "{\"traceEvents\":[";
+        for (const auto& r : records)
+        {
+            out << "\n{\"name\":\"" << trace_event_name(r.m_event) << "\",\"cat\":\"xframe\",\"ph\":\"X\""
+                << ",\"ts\":" << detail::trace_microseconds(r.m_start_ns)
+                << ",\"dur\":" << detail::trace_microseconds(r.m_duration_ns)
+                << ",\"pid\":0,\"tid\":" << r.m_thread << "},";
+        }
+        out << "\n{\"name\":\"broadcasts\",\"cat\":\"xframe\",\"ph\":\"C\",\"ts\":" << now
+            << ",\"pid\":0,\"args\":{\"trivial\":" << snapshot.m_trivial_broadcasts
+            << ",\"non_trivial\":" << snapshot.m_non_trivial_broadcasts << "}},";
+        out << "\n{\"name\":\"allocated_bytes\",\"cat\":\"xframe\",\"ph\":\"C\",\"ts\":" << now
+            << ",\"pid\":0,\"args\":{\"bytes\":" << snapshot.m_allocated_bytes << "}}";
+        out << "\n],\"displayTimeUnit\":\"ns\"}\n";
+    }
+
+    /*******************************
+     * xtrace_timer implementation *
+     *******************************/
+
+    inline xtrace_timer::xtrace_timer(trace_event e) noexcept
+        : xtrace_timer(e, true)
+    {
+    }
+
+    /**
+     * Builds a timer that only times the operation if \c timed is true,
+     * for operations whose kind is only known when they are performed.
+     */
+    inline xtrace_timer::xtrace_timer(trace_event e, bool timed) noexcept
+        : m_event(e), m_start(0), m_enabled(timed && is_trace_enabled())
+    {
+        if (m_enabled)
+        {
+            m_start = detail::trace_clock();
+        }
+    }
+
+    inline xtrace_timer::~xtrace_timer()
+    {
+        if (m_enabled)
+        {
+            detail::trace_record(m_event, m_start, detail::trace_clock() - m_start);
+        }
+    }
+
+    namespace detail
+    {
+        inline void trace_broadcast(bool trivial) noexcept
+        {
+            if (is_trace_enabled())
+            {
+                ++(trivial ? trace_state().m_trivial_broadcasts : trace_state().m_non_trivial_broadcasts);
+            }
+        }
+
+        inline void trace_allocation(std::size_t bytes) noexcept
+        {
+            if (is_trace_enabled())
+            {
+                trace_state().m_allocated_bytes += bytes;
+            }
+        }
+    }
 }
 
+#define XFRAME_TRACE_CONCAT_IMPL(a, b) a##b
+#define XFRAME_TRACE_CONCAT(a, b) XFRAME_TRACE_CONCAT_IMPL(a, b)
+
+#if XFRAME_ENABLE_TRACE
+#define XFRAME_TRACE_SCOPE(event) \
+    ::xf::xtrace_timer XFRAME_TRACE_CONCAT(xframe_trace_timer_, __LINE__)(::xf::trace_event::event);
+#define XFRAME_TRACE_SCOPE_IF(condition, event) \
+    ::xf::xtrace_timer XFRAME_TRACE_CONCAT(xframe_trace_timer_, __LINE__)(::xf::trace_event::event, condition);
+#define XFRAME_TRACE_BROADCAST(trivial) ::xf::detail::trace_broadcast(trivial);
+#define XFRAME_TRACE_ALLOCATION(bytes) ::xf::detail::trace_allocation(bytes);
+#else
+#define XFRAME_TRACE_SCOPE(event)
+#define XFRAME_TRACE_SCOPE_IF(condition, event)
+#define XFRAME_TRACE_BROADCAST(trivial)
+#define XFRAME_TRACE_ALLOCATION(bytes)
+#endif
+
 #endif
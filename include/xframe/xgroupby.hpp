@@ -0,0 +1,509 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XGROUPBY_HPP
+#define XFRAME_XGROUPBY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xaxis.hpp"
+#include "xflat_hash_map.hpp"
+#include "xframe_expression.hpp"
+#include "xnamed_axis.hpp"
+#include "xparallel.hpp"
+#include "xvariable_reducer.hpp"
+
+namespace xf
+{
+    /**
+     * Order of the groups in the result of an aggregation.
+     */
+    enum class group_order
+    {
+        sorted,
+        first_seen
+    };
+
+    /*********************
+     * xvariable_groupby *
+     *********************/
+
+    /**
+     * @class xvariable_groupby
+     * @brief Groups of the positions of a variable along a dimension.
+     *
+     * The xvariable_groupby class assigns each position of a dimension of a
+     * variable to the group of its key, and aggregates the values of the
+     * variable per group. The result of an aggregation is a variable where
+     * the grouped dimension is replaced with an axis holding the keys of
+     * the groups. Positions whose key is missing do not belong to any group.
+     *
+     * Keys are mapped to groups with a flat hash map in a single pass when
+     * the object is built. Aggregations split the grouped dimension into
+     * blocks aggregated by different threads into partial results, which
+     * are merged at the end.
+     *
+     * @tparam CT the closure type of the grouped variable.
+     * @tparam L the type of the keys.
+     * @sa groupby
+     */
+    template <class CT, class L>
+    class xvariable_groupby
+    {
+    public:
+
+        using variable_type = std::decay_t<CT>;
+        using coordinate_type = typename variable_type::coordinate_type;
+        using name_type = typename coordinate_type::key_type;
+        using key_type = L;
+        using size_type = std::size_t;
+        using axis_type = xaxis<key_type,
+                                typename coordinate_type::axis_type::mapped_type,
+                                typename coordinate_type::axis_type::map_container_tag>;
+
+        template <class K>
+        xvariable_groupby(CT variable, const name_type& dim, const K& keys, group_order order);
+
+        size_type size() const noexcept;
+        const axis_type& groups() const noexcept;
+
+        auto sum(bool skipna = true) const;
+        auto mean(bool skipna = true) const;
+        auto amin(bool skipna = true) const;
+        auto amax(bool skipna = true) const;
+        auto count() const;
+        auto first(bool skipna = true) const;
+        auto last(bool skipna = true) const;
+
+    private:
+
+        template <template <class> class K>
+        auto aggregate(bool skipna) const;
+
+        CT m_variable;
+        size_type m_dimension;
+        std::vector<size_type> m_slots;
+        std::vector<size_type> m_group_sizes;
+        axis_type m_groups;
+    };
+
+    template <class E, class K>
+    auto groupby(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim,
+                 const K& keys, group_order order = group_order::sorted);
+
+    /************************************
+     * xvariable_groupby implementation *
+     ************************************/
+
+    namespace detail
+    {
+        constexpr std::size_t missing_group = std::numeric_limits<std::size_t>::max();
+
+        template <class K, class T = xt::xexpression_tag_t<K>>
+        struct xgroupby_key;
+
+        template <class K>
+        struct xgroupby_key<K, xaxis_expression_tag>
+        {
+            using type = std::decay_t<typename K::value_type>;
+        };
+
+        template <class K>
+        struct xgroupby_key<K, xvariable_expression_tag>
+        {
+            using type = typename K::value_type::value_type;
+        };
+
+        template <class K>
+        using xgroupby_key_t = typename xgroupby_key<K>::type;
+
+        // The functions below call f(i, key) for each position i of the
+        // grouped dimension whose key is not missing.
+
+        template <class K, class V, class N, class F>
+        inline void for_each_group_key(xaxis_expression_tag, const K& keys, const V& /*var*/,
+                                       const N& dim, std::size_t size, F&& f)
+        {
+            using selector_type = typename K::template selector_sequence_type<>;
+            using size_type = typename K::size_type;
+
+            selector_type selector = { std::make_pair(dim, size_type(0)) };
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                selector[0].second = static_cast<size_type>(i);
+                f(i, keys(selector));
+            }
+        }
+
+        template <class K, class T, class MT, class L, class LT, class V, class N, class F>
+        inline void for_each_group_key(xaxis_expression_tag, const xnamed_axis<K, T, MT, L, LT>& keys,
+                                       const V& /*var*/, const N& dim, std::size_t size, F&& f)
+        {
+            using size_type = typename xnamed_axis<K, T, MT, L, LT>::size_type;
+
+            if (keys.name() != dim || keys.axis().size() != size)
+            {
+                throw std::runtime_error(std::string("Key axis does not match the grouped dimension ") + std::string(dim));
+            }
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                f(i, keys.label(static_cast<size_type>(i)));
+            }
+        }
+
+        template <class K, class V, class N, class F>
+        inline void for_each_group_key(xvariable_expression_tag, const K& keys, const V& var,
+                                       const N& dim, std::size_t /*size*/, F&& f)
+        {
+            const auto& key_variable = reducer_operand(keys);
+            if (key_variable.dimension() != 1 || key_variable.dimension_labels()[0] != dim)
+            {
+                throw std::runtime_error("Key variable must be one-dimensional along the grouped dimension");
+            }
+            if (!(key_variable.coordinates()[dim] == var.coordinates()[dim]))
+            {
+                throw std::runtime_error("Key variable is not aligned on the grouped dimension");
+            }
+
+            const auto& data = key_variable.data();
+            for (std::size_t i = 0; i < data.size(); ++i)
+            {
+                auto key = data(i);
+                if (key.has_value())
+                {
+                    f(i, key.value());
+                }
+            }
+        }
+
+        /**
+         * Returns the number of blocks of the grouped dimension aggregated in
+         * parallel. Each block but the first requires a partial result of
+         * result_size elements, which must be merged; the blocks are sized so
+         * that merging does not cost more than aggregating.
+         */
+        inline std::size_t groupby_blocks(std::size_t length, std::size_t size, std::size_t result_size)
+        {
+            std::size_t nb_threads = get_num_threads();
+            if (nb_threads < 2 || length < 2 || result_size == 0 || size < 2 * parallel_grain_size)
+            {
+                return 1;
+            }
+            return std::max(std::min({ nb_threads, length, size / parallel_grain_size, size / result_size }),
+                            std::size_t(1));
+        }
+    }
+
+    /**
+     * Builds the groups of the positions of the dimension \c dim of a variable.
+     * @param variable the grouped variable.
+     * @param dim the name of the grouped dimension.
+     * @param keys an axis expression on the labels of \c dim, or a one-dimensional
+     *             variable along \c dim aligned on \c variable.
+     * @param order the order of the groups.
+     */
+    template <class CT, class L>
+    template <class K>
+    inline xvariable_groupby<CT, L>::xvariable_groupby(CT variable, const name_type& dim, const K& keys, group_order order)
+        : m_variable(std::forward<CT>(variable)), m_dimension(0), m_slots(), m_group_sizes(), m_groups()
+    {
+        const auto& dimension_mapping = m_variable.dimension_mapping();
+        if (!dimension_mapping.contains(dim))
+        {
+            throw std::out_of_range("invalid dimension name in groupby");
+        }
+        m_dimension = dimension_mapping[dim];
+        size_type length = static_cast<size_type>(m_variable.shape()[m_dimension]);
+        m_slots.assign(length, detail::missing_group);
+
+        typename axis_type::label_list labels;
+        xflat_hash_map<key_type, size_type> index;
+        detail::for_each_group_key(xt::xexpression_tag_t<K>(), keys, m_variable, dim, length,
+                                   [this, &labels, &index](size_type i, const key_type& key)
+        {
+            auto inserted = index.insert(key, labels.size());
+            if (inserted.second)
+            {
+                labels.push_back(key);
+            }
+            m_slots[i] = *(inserted.first);
+        });
+
+        if (order == group_order::sorted && !std::is_sorted(labels.cbegin(), labels.cend()))
+        {
+            std::vector<size_type> permutation(labels.size());
+            std::iota(permutation.begin(), permutation.end(), size_type(0));
+            std::sort(permutation.begin(), permutation.end(),
+                      [&labels](size_type lhs, size_type rhs) { return labels[lhs] < labels[rhs]; });
+
+            std::vector<size_type> rank(labels.size());
+            typename axis_type::label_list sorted_labels;
+            sorted_labels.reserve(labels.size());
+            for (size_type i = 0; i < permutation.size(); ++i)
+            {
+                rank[permutation[i]] = i;
+                sorted_labels.push_back(labels[permutation[i]]);
+            }
+            for (auto& slot : m_slots)
+            {
+                slot = slot != detail::missing_group ? rank[slot] : slot;
+            }
+            labels.swap(sorted_labels);
+        }
+
+        m_group_sizes.assign(labels.size(), size_type(0));
+        for (auto slot : m_slots)
+        {
+            if (slot != detail::missing_group)
+            {
+                ++m_group_sizes[slot];
+            }
+        }
+        m_groups = axis_type(std::move(labels));
+    }
+
+    /**
+     * Returns the number of groups.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::size() const noexcept -> size_type
+    {
+        return m_groups.size();
+    }
+
+    /**
+     * Returns the axis of the keys of the groups, which is the axis of
+     * the grouped dimension in the result of the aggregations.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::groups() const noexcept -> const axis_type&
+    {
+        return m_groups;
+    }
+
+    /**
+     * Returns the sum of the values of each group. Missing values are skipped
+     * if \c skipna is true, so that the sum of missing values only is 0;
+     * otherwise an element of the result is missing if any of the aggregated
+     * values is missing.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::sum(bool skipna) const
+    {
+        return aggregate<detail::xsum_kernel>(skipna);
+    }
+
+    /**
+     * Returns the mean of the values of each group. An element of the result
+     * is missing if all the aggregated values are missing.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::mean(bool skipna) const
+    {
+        return aggregate<detail::xmean_kernel>(skipna);
+    }
+
+    /**
+     * Returns the minimum of the values of each group. An element of the result
+     * is missing if all the aggregated values are missing.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::amin(bool skipna) const
+    {
+        return aggregate<detail::xmin_kernel>(skipna);
+    }
+
+    /**
+     * Returns the maximum of the values of each group. An element of the result
+     * is missing if all the aggregated values are missing.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::amax(bool skipna) const
+    {
+        return aggregate<detail::xmax_kernel>(skipna);
+    }
+
+    /**
+     * Returns the number of non-missing values of each group.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::count() const
+    {
+        return aggregate<detail::xcount_kernel>(true);
+    }
+
+    /**
+     * Returns the first non-missing value of each group, in the order of the
+     * grouped dimension. If \c skipna is false, an element of the result is
+     * missing if any of the values of the group is missing.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::first(bool skipna) const
+    {
+        return aggregate<detail::xfirst_kernel>(skipna);
+    }
+
+    /**
+     * Returns the last non-missing value of each group, in the order of the
+     * grouped dimension. If \c skipna is false, an element of the result is
+     * missing if any of the values of the group is missing.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_groupby<CT, L>::last(bool skipna) const
+    {
+        return aggregate<detail::xlast_kernel>(skipna);
+    }
+
+    template <class CT, class L>
+    template <template <class> class K>
+    inline auto xvariable_groupby<CT, L>::aggregate(bool skipna) const
+    {
+        using coordinate_map = typename coordinate_type::map_type;
+        using dimension_list = typename variable_type::dimension_list;
+        using buffers_type = detail::xreducer_buffers<typename variable_type::data_type>;
+        using kernel_type = K<typename buffers_type::value_type>;
+        using result_type = typename kernel_type::result_type;
+
+        std::vector<size_type> shape(m_variable.shape().cbegin(), m_variable.shape().cend());
+        size_type outer_size = std::accumulate(shape.cbegin(), shape.cbegin() + m_dimension,
+                                               size_type(1), std::multiplies<size_type>());
+        size_type inner_size = std::accumulate(shape.cbegin() + m_dimension + 1, shape.cend(),
+                                               size_type(1), std::multiplies<size_type>());
+        size_type length = shape[m_dimension];
+        size_type nb_groups = m_groups.size();
+
+        std::vector<size_type> result_shape = shape;
+        result_shape[m_dimension] = nb_groups;
+        xt::xarray<result_type> values = xt::xarray<result_type>::from_shape(result_shape);
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape(result_shape);
+        kernel_type kernel(values.size());
+        {
+            const auto& v = buffers_type::values(m_variable.data());
+            const auto& f = buffers_type::flags(m_variable.data());
+            const auto* vp = v.data();
+            const std::uint8_t* fp = reinterpret_cast<const std::uint8_t*>(f.data());
+
+            auto aggregate_block = [&](kernel_type& k, size_type begin, size_type end)
+            {
+                for (size_type o = 0; o < outer_size; ++o)
+                {
+                    for (size_type i = begin; i < end; ++i)
+                    {
+                        size_type slot = m_slots[i];
+                        if (slot != detail::missing_group)
+                        {
+                            size_type offset = (o * length + i) * inner_size;
+                            k.accumulate((o * nb_groups + slot) * inner_size, vp + offset, fp + offset, inner_size);
+                        }
+                    }
+                }
+            };
+
+            size_type nb_blocks = detail::groupby_blocks(length, outer_size * length * inner_size, values.size());
+            if (nb_blocks < 2)
+            {
+                aggregate_block(kernel, size_type(0), length);
+            }
+            else
+            {
+                size_type block_size = (length + nb_blocks - 1) / nb_blocks;
+                nb_blocks = (length + block_size - 1) / block_size;
+                std::vector<kernel_type> partials(nb_blocks - 1, kernel_type(values.size()));
+                xthread_pool::instance().run(nb_blocks, get_num_threads(), [&](size_type b)
+                {
+                    size_type begin = b * block_size;
+                    aggregate_block(b == 0 ? kernel : partials[b - 1], begin, std::min(begin + block_size, length));
+                });
+                // Partial results are merged in the order of the blocks, which
+                // first and last depend on.
+                for (const auto& partial : partials)
+                {
+                    kernel.merge(partial);
+                }
+            }
+        }
+
+        for (size_type o = 0; o < values.size(); ++o)
+        {
+            size_type slot = (o / inner_size) % nb_groups;
+            values.data()[o] = kernel.result(o);
+            flags.data()[o] = kernel.has_result(o) && (skipna || kernel.count(o) == m_group_sizes[slot]);
+        }
+
+        coordinate_map result_coordinates;
+        dimension_list result_dimensions;
+        for (size_type d = 0; d < shape.size(); ++d)
+        {
+            const auto& name = m_variable.dimension_labels()[d];
+            if (d == m_dimension)
+            {
+                result_coordinates.emplace(name, m_groups);
+            }
+            else
+            {
+                result_coordinates.emplace(name, m_variable.coordinates()[name]);
+            }
+            result_dimensions.push_back(name);
+        }
+
+        using data_type = xt::xoptional_assembly<xt::xarray<result_type>, xt::xarray<bool>>;
+        return variable(data_type(std::move(values), std::move(flags)),
+                        std::move(result_coordinates),
+                        std::move(result_dimensions));
+    }
+
+    /**
+     * @brief Groups the positions of a dimension by key.
+     *
+     * Returns an object whose methods aggregate the values of \c e per group,
+     * e.g. `groupby(v, "time", v.axis<int>("time") / 60).mean()`. The keys are
+     * either given by an axis expression evaluated on the labels of \c dim, or
+     * by a one-dimensional variable along \c dim, aligned on \c e, whose missing
+     * values denote positions that do not belong to any group. The type of
+     * the keys must be one of the label types of the coordinates of \c e.
+     *
+     * Expressions that are not containers are evaluated first; containers are
+     * referenced by the returned object and must outlive it.
+     * @param e the variable expression to group.
+     * @param dim the name of the grouped dimension.
+     * @param keys the keys of the positions of \c dim.
+     * @param order the order of the groups in the result of the aggregations,
+     *              sorted by key or in the order of their first position.
+     */
+    template <class E, class K>
+    inline auto groupby(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim,
+                        const K& keys, group_order order)
+    {
+        using closure_type = decltype(detail::reducer_operand(e));
+        using groupby_type = xvariable_groupby<closure_type, detail::xgroupby_key_t<K>>;
+        return groupby_type(detail::reducer_operand(e), dim, keys, order);
+    }
+}
+
+#endif
@@ -55,7 +55,7 @@ namespace xf
 
         const name_type& name() const & noexcept;
         const axis_variant_type& axis() const & noexcept;
-        const value_type& label(size_type i) const & noexcept;
+        value_type label(size_type i) const & noexcept;
 
     private:
 
@@ -118,9 +118,9 @@ namespace xf
      * @return the label at the given position of the underlying xaxis.
      */
     template <class K, class T, class MT, class L, class LT>
-    inline auto xnamed_axis<K, T, MT, L, LT>::label(size_type i) const & noexcept -> const LT&
+    inline auto xnamed_axis<K, T, MT, L, LT>::label(size_type i) const & noexcept -> value_type
     {
-        return get_labels<LT>(m_axis)[i];
+        return xtl::get<LT>(m_axis.label(i));
     }
 
     /******************
@@ -0,0 +1,344 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XPARALLEL_HPP
+#define XFRAME_XPARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "xframe_config.hpp"
+
+namespace xf
+{
+    /*****************
+     * thread number *
+     *****************/
+
+    std::size_t get_num_threads() noexcept;
+    void set_num_threads(std::size_t n) noexcept;
+
+    /**
+     * @class xnum_threads_scope
+     * @brief Overrides the number of threads in a scope.
+     *
+     * The xnum_threads_scope class sets the number of threads used by the
+     * assignments performed by the current thread until it is destroyed.
+     */
+    class xnum_threads_scope
+    {
+    public:
+
+        explicit xnum_threads_scope(std::size_t n) noexcept;
+        ~xnum_threads_scope();
+
+        xnum_threads_scope(const xnum_threads_scope&) = delete;
+        xnum_threads_scope& operator=(const xnum_threads_scope&) = delete;
+
+    private:
+
+        std::size_t m_previous;
+    };
+
+    /****************
+     * xthread_pool *
+     ****************/
+
+    /**
+     * @class xthread_pool
+     * @brief Pool of worker threads used by parallel assignments.
+     *
+     * Workers are started on demand and live until the end of the program.
+     * The calling thread takes part in the execution of the tasks. Calls to
+     * run from a task, or while another thread is running tasks, execute
+     * sequentially.
+     */
+    class xthread_pool
+    {
+    public:
+
+        using size_type = std::size_t;
+        using task_type = std::function<void(size_type)>;
+
+        static xthread_pool& instance();
+
+        ~xthread_pool();
+
+        xthread_pool(const xthread_pool&) = delete;
+        xthread_pool& operator=(const xthread_pool&) = delete;
+
+        void run(size_type nb_tasks, size_type nb_threads, const task_type& task);
+
+    private:
+
+        xthread_pool() = default;
+
+        void reserve(size_type nb_workers);
+        void work();
+        void execute();
+
+        static bool& is_worker() noexcept;
+
+        std::vector<std::thread> m_workers;
+        std::mutex m_run_mutex;
+        std::mutex m_mutex;
+        std::condition_variable m_start;
+        std::condition_variable m_done;
+        const task_type* p_task = nullptr;
+        std::vector<std::exception_ptr> m_errors;
+        std::atomic<size_type> m_nb_tasks{0};
+        std::atomic<size_type> m_next{0};
+        std::atomic<size_type> m_remaining{0};
+        size_type m_generation = 0;
+        size_type m_active = 0;
+        bool m_stop = false;
+    };
+
+    namespace detail
+    {
+        template <class F>
+        void parallel_for_rows(std::size_t nb_rows, std::size_t row_size, std::size_t alignment, F&& f);
+    }
+
+    /********************************
+     * thread number implementation *
+     ********************************/
+
+    namespace detail
+    {
+        inline std::atomic<std::size_t>& global_num_threads() noexcept
+        {
+            static std::atomic<std::size_t> n(XFRAME_DEFAULT_NUM_THREADS);
+            return n;
+        }
+
+        inline std::size_t& local_num_threads() noexcept
+        {
+            static thread_local std::size_t n = 0;
+            return n;
+        }
+    }
+
+    /**
+     * Returns the number of threads used for assigning variables. The value
+     * set by an xnum_threads_scope in the current thread takes precedence over
+     * the global value set with set_num_threads.
+     */
+    inline std::size_t get_num_threads() noexcept
+    {
+        std::size_t local = detail::local_num_threads();
+        return local != 0 ? local : detail::global_num_threads().load();
+    }
+
+    /**
+     * Sets the number of threads used for assigning variables. A value of 0
+     * selects the number of hardware threads.
+     */
+    inline void set_num_threads(std::size_t n) noexcept
+    {
+        if (n == 0)
+        {
+            n = std::max(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+        }
+        detail::global_num_threads() = n;
+    }
+
+    inline xnum_threads_scope::xnum_threads_scope(std::size_t n) noexcept
+        : m_previous(detail::local_num_threads())
+    {
+        detail::local_num_threads() = n != 0 ? n : std::max(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+    }
+
+    inline xnum_threads_scope::~xnum_threads_scope()
+    {
+        detail::local_num_threads() = m_previous;
+    }
+
+    /*******************************
+     * xthread_pool implementation *
+     *******************************/
+
+    inline xthread_pool& xthread_pool::instance()
+    {
+        static xthread_pool pool;
+        return pool;
+    }
+
+    inline xthread_pool::~xthread_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_start.notify_all();
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+    }
+
+    /**
+     * Runs task(i) for i in [0, nb_tasks) on at most nb_threads threads and
+     * waits for their completion. If tasks throw, the exception of the task
+     * with the lowest index is rethrown.
+     */
+    inline void xthread_pool::run(size_type nb_tasks, size_type nb_threads, const task_type& task)
+    {
+        std::unique_lock<std::mutex> run_lock(m_run_mutex, std::defer_lock);
+        if (nb_tasks < 2 || nb_threads < 2 || is_worker() || !run_lock.try_lock())
+        {
+            for (size_type i = 0; i < nb_tasks; ++i)
+            {
+                task(i);
+            }
+            return;
+        }
+
+        reserve(std::min(nb_tasks, nb_threads) - 1);
+        {
+            // Workers still running the previous tasks must not see the
+            // counters of the new ones
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]() { return m_active == 0; });
+            p_task = &task;
+            m_errors.assign(nb_tasks, nullptr);
+            m_remaining = nb_tasks;
+            m_nb_tasks = nb_tasks;
+            m_next = 0;
+            ++m_generation;
+        }
+        m_start.notify_all();
+        execute();
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_done.wait(lock, [this]() { return m_remaining == 0; });
+            m_nb_tasks = 0;
+            p_task = nullptr;
+        }
+
+        auto error = std::find_if(m_errors.begin(), m_errors.end(), [](const std::exception_ptr& e) { return e != nullptr; });
+        if (error != m_errors.end())
+        {
+            std::rethrow_exception(*error);
+        }
+    }
+
+    inline void xthread_pool::reserve(size_type nb_workers)
+    {
+        while (m_workers.size() < nb_workers)
+        {
+            m_workers.emplace_back([this]() { work(); });
+        }
+    }
+
+    inline void xthread_pool::work()
+    {
+        is_worker() = true;
+        size_type generation = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_start.wait(lock, [this, &generation]() { return m_stop || m_generation != generation; });
+            if (m_stop)
+            {
+                return;
+            }
+            generation = m_generation;
+            ++m_active;
+            lock.unlock();
+            execute();
+            lock.lock();
+            if (--m_active == 0)
+            {
+                m_done.notify_all();
+            }
+        }
+    }
+
+    inline void xthread_pool::execute()
+    {
+        size_type i;
+        while ((i = m_next++) < m_nb_tasks)
+        {
+            try
+            {
+                (*p_task)(i);
+            }
+            catch (...)
+            {
+                m_errors[i] = std::current_exception();
+            }
+            if (--m_remaining == 0)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_done.notify_all();
+            }
+        }
+    }
+
+    inline bool& xthread_pool::is_worker() noexcept
+    {
+        static thread_local bool res = false;
+        return res;
+    }
+
+    namespace detail
+    {
+        constexpr std::size_t parallel_grain_size = std::size_t(1) << 15;
+
+        /**
+         * Splits [0, nb_rows) into contiguous blocks and calls f(begin, end) on
+         * each block, using the number of threads returned by get_num_threads.
+         * Block boundaries are multiples of the number of rows spanning a
+         * multiple of alignment elements, so that blocks never share a word of
+         * packed data; an alignment of 0 disables the splitting. The result of
+         * f must not depend on the partition.
+         */
+        template <class F>
+        inline void parallel_for_rows(std::size_t nb_rows, std::size_t row_size, std::size_t alignment, F&& f)
+        {
+            std::size_t nb_threads = get_num_threads();
+            std::size_t size = nb_rows * row_size;
+            if (alignment == 0 || nb_threads < 2 || nb_rows < 2 || size < 2 * parallel_grain_size)
+            {
+                f(std::size_t(0), nb_rows);
+                return;
+            }
+
+            std::size_t a = alignment, b = row_size % alignment;
+            while (b != 0)
+            {
+                std::size_t r = a % b;
+                a = b;
+                b = r;
+            }
+            std::size_t unit = alignment / a;
+            std::size_t nb_units = (nb_rows + unit - 1) / unit;
+            std::size_t nb_blocks = std::min({ nb_threads, nb_units, size / parallel_grain_size });
+            std::size_t units_per_block = (nb_units + nb_blocks - 1) / nb_blocks;
+            std::size_t rows_per_block = units_per_block * unit;
+            nb_blocks = (nb_rows + rows_per_block - 1) / rows_per_block;
+
+            xthread_pool::instance().run(nb_blocks, nb_threads, [&f, nb_rows, rows_per_block](std::size_t i) {
+                std::size_t begin = i * rows_per_block;
+                f(begin, std::min(begin + rows_per_block, nb_rows));
+            });
+        }
+    }
+}
+
+#endif
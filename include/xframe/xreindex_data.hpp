@@ -11,6 +11,9 @@
 #ifndef XREINDEX_DATA_HPP
 #define XREINDEX_DATA_HPP
 
+#include <algorithm>
+#include <cstdint>
+
 #include "xtensor/xexpression.hpp"
 #include "xtensor/xiterable.hpp"
 #include "xtensor/xlayout.hpp"
@@ -19,6 +22,9 @@ namespace xf
 {
     template <class RV>
     class xreindex_data;
+
+    template <class RV>
+    class xreindex_stepper;
 }
 
 namespace xt
@@ -28,7 +34,7 @@ namespace xt
     {
         using xexpression_type = std::decay_t<RV>;
         using inner_shape_type = typename xexpression_type::shape_type;
-        using const_stepper = xindexed_stepper<xf::xreindex_data<RV>, true>;
+        using const_stepper = xf::xreindex_stepper<RV>;
         using stepper = const_stepper;
     };
 }
@@ -105,6 +111,67 @@ namespace xf
         const xexpression_type& m_e;
     };
 
+    /********************
+     * xreindex_stepper *
+     ********************/
+
+    /**
+     * @class xreindex_stepper
+     * @brief Stepper on the data of an xreindex_view.
+     *
+     * The xreindex_stepper keeps track of the position of the view and of
+     * the corresponding position in the underlying expression. Stepping
+     * along a dimension reads a single entry of the gather index of this
+     * dimension and updates the number of dimensions where the current
+     * label is missing; dereferencing does not involve any label lookup.
+     *
+     * @tparam RV the closure type of the reindex view.
+     */
+    template <class RV>
+    class xreindex_stepper
+    {
+    public:
+
+        using self_type = xreindex_stepper<RV>;
+        using view_type = std::decay_t<RV>;
+        using xexpression_type = xreindex_data<RV>;
+
+        using value_type = typename view_type::value_type;
+        using reference = typename view_type::const_reference;
+        using pointer = typename view_type::const_pointer;
+        using size_type = typename view_type::size_type;
+        using difference_type = typename view_type::difference_type;
+        using shape_type = typename view_type::shape_type;
+
+        xreindex_stepper(const view_type* v, size_type offset, bool end = false,
+                         xt::layout_type l = XTENSOR_DEFAULT_TRAVERSAL);
+
+        reference operator*() const;
+
+        void step(size_type dim, size_type n = 1);
+        void step_back(size_type dim, size_type n = 1);
+        void reset(size_type dim);
+        void reset_back(size_type dim);
+
+        void to_begin();
+        void to_end(xt::layout_type l);
+
+    private:
+
+        using index_type = typename view_type::template index_type<>;
+        using subindex_type = typename view_type::xexpression_type::template index_type<>;
+
+        bool is_missing(size_type dim, size_type pos) const noexcept;
+        void move_to(size_type dim, size_type pos);
+        void update_subindex();
+
+        const view_type* p_view;
+        index_type m_index;
+        subindex_type m_subindex;
+        size_type m_offset;
+        size_type m_nb_missing;
+    };
+
     /********************************
      * xreindex_data implementation *
      ********************************/
@@ -201,23 +268,157 @@ namespace xf
 
     template <class RV>
     template <class S>
-    inline bool xreindex_data<RV>::has_linear_assign(const S& strides) const noexcept
+    inline bool xreindex_data<RV>::has_linear_assign(const S& /*strides*/) const noexcept
     {
         return false;
     }
 
     template <class RV>
     template <class S>
-    inline auto xreindex_data<RV>::stepper_begin(const S& /*shape*/) const noexcept -> const_stepper
+    inline auto xreindex_data<RV>::stepper_begin(const S& shape) const noexcept -> const_stepper
     {
-        return const_stepper(this, size_type(0));
+        size_type offset = shape.size() - dimension();
+        return const_stepper(&m_e, offset);
     }
 
     template <class RV>
     template <class S>
-    inline auto xreindex_data<RV>::stepper_end(const S& /*shape*/, xt::layout_type /*l*/) const noexcept -> const_stepper
+    inline auto xreindex_data<RV>::stepper_end(const S& shape, xt::layout_type l) const noexcept -> const_stepper
+    {
+        size_type offset = shape.size() - dimension();
+        return const_stepper(&m_e, offset, true, l);
+    }
+
+    /***********************************
+     * xreindex_stepper implementation *
+     ***********************************/
+
+    template <class RV>
+    inline xreindex_stepper<RV>::xreindex_stepper(const view_type* v, size_type offset, bool end, xt::layout_type l)
+        : p_view(v),
+          m_index(xtl::make_sequence<index_type>(v->dimension(), size_type(0))),
+          m_subindex(xtl::make_sequence<subindex_type>(v->dimension(), size_type(0))),
+          m_offset(offset),
+          m_nb_missing(0)
+    {
+        if (end)
+        {
+            to_end(l);
+        }
+        else
+        {
+            update_subindex();
+        }
+    }
+
+    template <class RV>
+    inline auto xreindex_stepper<RV>::operator*() const -> reference
+    {
+        return m_nb_missing != 0 ? view_type::missing() : p_view->expression().element(m_subindex);
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::step(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            move_to(d, m_index[d] + n);
+        }
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::step_back(size_type dim, size_type n)
+    {
+        if (dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            move_to(d, m_index[d] - n);
+        }
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::reset(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            move_to(dim - m_offset, size_type(0));
+        }
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::reset_back(size_type dim)
+    {
+        if (dim >= m_offset)
+        {
+            size_type d = dim - m_offset;
+            move_to(d, static_cast<size_type>(p_view->shape()[d]) - 1);
+        }
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::to_begin()
+    {
+        std::fill(m_index.begin(), m_index.end(), size_type(0));
+        update_subindex();
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::to_end(xt::layout_type l)
+    {
+        const auto& shape = p_view->shape();
+        std::transform(shape.cbegin(), shape.cend(), m_index.begin(),
+                       [](const auto& v) { return static_cast<size_type>(v) - 1; });
+        if (!m_index.empty())
+        {
+            size_type l_dim = (l == xt::layout_type::row_major) ? m_index.size() - 1 : size_type(0);
+            m_index[l_dim] = static_cast<size_type>(shape[l_dim]);
+        }
+        update_subindex();
+    }
+
+    // Positions out of the bounds of the view, which are reached by the end
+    // stepper and while stepping back, are treated as missing.
+    template <class RV>
+    inline bool xreindex_stepper<RV>::is_missing(size_type dim, size_type pos) const noexcept
+    {
+        const auto& gather = p_view->gather_index(dim);
+        return pos >= gather.size() || gather[pos] < 0;
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::move_to(size_type dim, size_type pos)
+    {
+        if (is_missing(dim, m_index[dim]))
+        {
+            --m_nb_missing;
+        }
+        m_index[dim] = pos;
+        if (is_missing(dim, pos))
+        {
+            ++m_nb_missing;
+        }
+        else
+        {
+            m_subindex[dim] = static_cast<size_type>(p_view->gather_index(dim)[pos]);
+        }
+    }
+
+    template <class RV>
+    inline void xreindex_stepper<RV>::update_subindex()
     {
-        return const_stepper(this, size(), true);
+        m_nb_missing = 0;
+        for (size_type d = 0; d < m_index.size(); ++d)
+        {
+            if (is_missing(d, m_index[d]))
+            {
+                ++m_nb_missing;
+            }
+            else
+            {
+                m_subindex[d] = static_cast<size_type>(p_view->gather_index(d)[m_index[d]]);
+            }
+        }
     }
 }
 
@@ -11,6 +11,14 @@
 #ifndef XREINDEX_VIEW_HPP
 #define XREINDEX_VIEW_HPP
 
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
 #include "xtensor/xexpression.hpp"
 
 #include "xcoordinate_chain.hpp"
@@ -19,11 +27,44 @@
 
 namespace xf
 {
+    /***************
+     * fill_method *
+     ***************/
+
+    /**
+     * Method used for filling the labels of a reindexed axis which do not
+     * belong to the original axis. Methods other than none require sorted
+     * axes.
+     */
+    enum class fill_method
+    {
+        /** The labels are missing. */
+        none,
+        /** The labels take the value of the previous label of the original axis. */
+        pad,
+        /** The labels take the value of the next label of the original axis. */
+        backfill,
+        /** The labels take the value of the nearest label of the original axis. */
+        nearest
+    };
 
     /*****************
      * xreindex_view *
      *****************/
 
+    /**
+     * @class xreindex_view
+     * @brief View of a variable expression on new coordinates.
+     *
+     * The labels of the reindexed axes are resolved when the view is built:
+     * each dimension holds a gather index mapping the positions of the view
+     * to the positions in the underlying expression, -1 meaning that the
+     * label is missing. Accessing an element does not require any label
+     * lookup. When both axes are sorted, the gather index is computed with
+     * a single sweep over the axes, which also implements the fill methods.
+     *
+     * @tparam CT the closure type of the underlying expression.
+     */
     template <class CT>
     class xreindex_view : public xt::xexpression<xreindex_view<CT>>
     {
@@ -49,6 +90,7 @@ namespace xf
         using coordinate_map = typename coordinate_type::map_type;
 
         using expression_tag = xvariable_expression_tag;
+        using gather_index_type = std::vector<std::int64_t>;
 
         template <std::size_t N = dynamic()>
         using selector_traits = xselector_traits<coordinate_type, dimension_type, N>;
@@ -67,16 +109,31 @@ namespace xf
         template <std::size_t N = dynamic()>
         using locator_sequence_type = typename selector_traits<N>::locator_sequence_type;
 
+        // Prepared selectors are resolved against the coordinates of the
+        // underlying expression; reindexed labels are handled on lookup failure.
+        template <std::size_t N = dynamic()>
+        using subselector_traits = xselector_traits<subcoordinate_type, dimension_type, N>;
+        template <std::size_t N = dynamic()>
+        using prepared_selector_type = typename subselector_traits<N>::prepared_selector_type;
+        template <std::size_t N = dynamic()>
+        using name_sequence_type = typename subselector_traits<N>::name_sequence_type;
+        template <std::size_t N = dynamic()>
+        using label_sequence_type = typename subselector_traits<N>::label_sequence_type;
+        template <std::size_t N = dynamic()>
+        using label_batch_type = typename subselector_traits<N>::label_batch_type;
+
         static const_reference missing();
 
         xreindex_view(self_type&& rhs);
         xreindex_view(const self_type& rhs);
 
         template <class E>
-        xreindex_view(E&& e, const coordinate_map& new_coord);
+        xreindex_view(E&& e, const coordinate_map& new_coord, fill_method method = fill_method::none,
+                      double tolerance = std::numeric_limits<double>::infinity());
 
         template <class E>
-        xreindex_view(E&& e, coordinate_map&& new_coord);
+        xreindex_view(E&& e, coordinate_map&& new_coord, fill_method method = fill_method::none,
+                      double tolerance = std::numeric_limits<double>::infinity());
 
         size_type size() const noexcept;
         size_type dimension() const noexcept;
@@ -91,6 +148,9 @@ namespace xf
         const shape_type& shape() const noexcept;
         const data_type& data() const noexcept;
 
+        const xexpression_type& expression() const noexcept;
+        const gather_index_type& gather_index(size_type dim) const noexcept;
+
         template <class... Args>
         const_reference operator()(Args... args) const;
 
@@ -115,6 +175,20 @@ namespace xf
         template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N = dynamic()>
         const_reference select(selector_sequence_type<N>&& selector) const;
 
+        template <std::size_t N = dynamic()>
+        prepared_selector_type<N> prepare_selector(const name_sequence_type<N>& names) const;
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N>
+        const_reference select(const xprepared_selector<subcoordinate_type, dimension_type, N>& selector,
+                               const label_sequence_type<N>& labels) const;
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N = dynamic()>
+        xt::xarray<value_type> select_batch(const name_sequence_type<N>& names, const label_batch_type<N>& labels) const;
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N>
+        xt::xarray<value_type> select_batch(const xprepared_selector<subcoordinate_type, dimension_type, N>& selector,
+                                            const label_batch_type<N>& labels) const;
+
         template <std::size_t N = dynamic()>
         const_reference iselect(const iselector_sequence_type<N>& selector) const;
 
@@ -124,6 +198,7 @@ namespace xf
     private:
 
         void init_shape();
+        void init_gather_indices(fill_method method, double tolerance);
 
         template <std::size_t N, class IDX>
         const_reference element_impl(IDX&& index) const;
@@ -131,12 +206,16 @@ namespace xf
         template <std::size_t N, class L>
         const_reference locate_element_impl(L&& locator) const;
 
-        template <class S>
-        const_reference select_impl(S&& selector) const;
-
         template <class Join, class S>
         const_reference select_join(S&& selector) const;
 
+        template <class Join, std::size_t N>
+        const_reference select_missing(const xprepared_selector<subcoordinate_type, dimension_type, N>& selector,
+                                       const label_sequence_type<N>& labels) const;
+
+        template <class K, class L>
+        bool resolve_label(const K& name, L& label) const;
+
         template <std::size_t N, class S>
         const_reference iselect_impl(S&& selector) const;
 
@@ -147,6 +226,7 @@ namespace xf
         coordinate_type m_coordinate;
         const dimension_type& m_dimension_mapping;
         shape_type m_shape;
+        std::vector<gather_index_type> m_gather_indices;
         data_type m_data;
     };
 
@@ -158,10 +238,14 @@ namespace xf
      *************************/
 
     template <class E>
-    auto reindex(E&& e, const typename std::decay_t<E>::coordinate_map& new_coord);
+    auto reindex(E&& e, const typename std::decay_t<E>::coordinate_map& new_coord,
+                 fill_method method = fill_method::none,
+                 double tolerance = std::numeric_limits<double>::infinity());
 
     template <class E>
-    auto reindex(E&& e, typename std::decay_t<E>::coordinate_map&& new_coord);
+    auto reindex(E&& e, typename std::decay_t<E>::coordinate_map&& new_coord,
+                 fill_method method = fill_method::none,
+                 double tolerance = std::numeric_limits<double>::infinity());
 
     template <class E1, class E2>
     auto reindex_like(E1&& e1, const E2& e2);
@@ -169,6 +253,120 @@ namespace xf
     template <class Join, class E1, class... E>
     auto align(E1&& e1, E&&... e);
 
+    /*******************************
+     * gather index of sorted axes *
+     *******************************/
+
+    namespace detail
+    {
+        // Integral labels are subtracted before the conversion to double, so
+        // that the distance between large labels such as timestamps in
+        // nanoseconds is exact
+        template <class T>
+        inline std::enable_if_t<std::is_integral<T>::value, double>
+        label_distance_impl(const T& lhs, const T& rhs)
+        {
+            using unsigned_type = std::make_unsigned_t<T>;
+            unsigned_type distance = lhs < rhs ?
+                static_cast<unsigned_type>(static_cast<unsigned_type>(rhs) - static_cast<unsigned_type>(lhs)) :
+                static_cast<unsigned_type>(static_cast<unsigned_type>(lhs) - static_cast<unsigned_type>(rhs));
+            return static_cast<double>(distance);
+        }
+
+        template <class T>
+        inline std::enable_if_t<std::is_floating_point<T>::value, double>
+        label_distance_impl(const T& lhs, const T& rhs)
+        {
+            return std::abs(static_cast<double>(lhs - rhs));
+        }
+
+        template <class T>
+        inline std::enable_if_t<!std::is_arithmetic<T>::value, double>
+        label_distance_impl(const T&, const T&)
+        {
+            throw std::runtime_error("Nearest fill method and tolerance require arithmetic labels");
+        }
+
+        template <class K>
+        inline double label_distance(const K& lhs, const K& rhs)
+        {
+            return xtl::visit([&rhs](const auto& l)
+            {
+                return label_distance_impl(l, xtl::get<std::decay_t<decltype(l)>>(rhs));
+            }, lhs);
+        }
+
+        /**
+         * Fills gather with the position in the sorted axis \c sub_axis of each
+         * label of the sorted axis \c new_axis, or with the position of the
+         * label it is filled from according to \c method. Both axes are swept
+         * once.
+         */
+        template <class A, class G>
+        inline void build_sorted_gather_index(const A& new_axis, const A& sub_axis,
+                                              fill_method method, double tolerance, G& gather)
+        {
+            using label_type = typename A::key_type;
+            std::size_t size = new_axis.size();
+            std::size_t sub_size = sub_axis.size();
+            bool check_tolerance = tolerance < std::numeric_limits<double>::infinity();
+            gather.resize(size);
+
+            std::size_t j = 0;
+            label_type sub_label = sub_size != 0 ? sub_axis.label(0) : label_type();
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                label_type label = new_axis.label(i);
+                while (j < sub_size && sub_label < label)
+                {
+                    ++j;
+                    if (j < sub_size)
+                    {
+                        sub_label = sub_axis.label(j);
+                    }
+                }
+                // sub_axis[j - 1] < label <= sub_axis[j]
+                if (j < sub_size && sub_label == label)
+                {
+                    gather[i] = static_cast<std::int64_t>(j);
+                    continue;
+                }
+
+                std::int64_t previous = j != 0 ? static_cast<std::int64_t>(j - 1) : std::int64_t(-1);
+                std::int64_t next = j < sub_size ? static_cast<std::int64_t>(j) : std::int64_t(-1);
+                std::int64_t pos = -1;
+                switch (method)
+                {
+                case fill_method::pad:
+                    pos = previous;
+                    break;
+                case fill_method::backfill:
+                    pos = next;
+                    break;
+                case fill_method::nearest:
+                    if (previous < 0 || next < 0)
+                    {
+                        pos = previous < 0 ? next : previous;
+                    }
+                    else
+                    {
+                        double previous_distance = label_distance(label, sub_axis.label(static_cast<std::size_t>(previous)));
+                        pos = previous_distance < label_distance(label, sub_label) ? previous : next;
+                    }
+                    break;
+                default:
+                    break;
+                }
+                if (pos >= 0 && check_tolerance &&
+                    label_distance(label, sub_axis.label(static_cast<std::size_t>(pos))) > tolerance)
+                {
+                    pos = -1;
+                }
+                gather[i] = pos;
+            }
+        }
+    }
+
     /********************************
      * xreindex_view implementation *
      ********************************/
@@ -178,6 +376,7 @@ namespace xf
         : m_e(std::forward<decltype(rhs.m_e)>(rhs.m_e)),
           m_coordinate(std::move(rhs.m_coordinate)),
           m_dimension_mapping(m_e.dimension_mapping()),
+          m_gather_indices(std::move(rhs.m_gather_indices)),
           m_data(*this)
     {
         init_shape();
@@ -188,31 +387,46 @@ namespace xf
         : m_e(rhs.m_e),
           m_coordinate(rhs.m_coordinate),
           m_dimension_mapping(m_e.dimension_mapping()),
+          m_gather_indices(rhs.m_gather_indices),
           m_data(*this)
     {
         init_shape();
     }
 
+    /**
+     * Builds a view of \c e on the coordinates \c new_coord.
+     * @param e the underlying expression.
+     * @param new_coord the new axes, mapped to the names of their dimensions.
+     * @param method the method used for filling the labels of the new axes
+     *               which do not belong to the axes of \c e.
+     * @param tolerance the maximum distance between a filled label and the
+     *                  label it is filled from; labels further away are missing.
+     * @throw std::runtime_error if \c method is not fill_method::none and an
+     *        axis of \c new_coord or the corresponding axis of \c e is not
+     *        sorted.
+     */
     template <class CT>
     template <class E>
-    inline xreindex_view<CT>::xreindex_view(E&& e, const coordinate_map& new_coord)
+    inline xreindex_view<CT>::xreindex_view(E&& e, const coordinate_map& new_coord, fill_method method, double tolerance)
         : m_e(std::forward<E>(e)),
           m_coordinate(reindex(m_e.coordinates(), new_coord)),
           m_dimension_mapping(m_e.dimension_mapping()),
           m_data(*this)
     {
         init_shape();
+        init_gather_indices(method, tolerance);
     }
 
     template <class CT>
     template <class E>
-    inline xreindex_view<CT>::xreindex_view(E&& e, coordinate_map&& new_coord)
+    inline xreindex_view<CT>::xreindex_view(E&& e, coordinate_map&& new_coord, fill_method method, double tolerance)
         : m_e(std::forward<E>(e)),
           m_coordinate(reindex(m_e.coordinates(), std::move(new_coord))),
           m_dimension_mapping(m_e.dimension_mapping()),
           m_data(*this)
     {
         init_shape();
+        init_gather_indices(method, tolerance);
     }
 
     template <class CT>
@@ -286,6 +500,27 @@ namespace xf
         return m_data;
     }
 
+    /**
+     * Returns the underlying expression of the view.
+     */
+    template <class CT>
+    inline auto xreindex_view<CT>::expression() const noexcept -> const xexpression_type&
+    {
+        return m_e;
+    }
+
+    /**
+     * Returns the gather index of the dimension \c dim, i.e. the position in
+     * the underlying expression of each position of the view along this
+     * dimension, or -1 if the corresponding label is missing.
+     * @param dim the index of the dimension.
+     */
+    template <class CT>
+    inline auto xreindex_view<CT>::gather_index(size_type dim) const noexcept -> const gather_index_type&
+    {
+        return m_gather_indices[dim];
+    }
+
     template <class CT>
     template <class... Args>
     inline auto xreindex_view<CT>::operator()(Args... args) const -> const_reference
@@ -346,6 +581,44 @@ namespace xf
         return select_join<Join>(std::move(selector));
     }
 
+    template <class CT>
+    template <std::size_t N>
+    inline auto xreindex_view<CT>::prepare_selector(const name_sequence_type<N>& names) const -> prepared_selector_type<N>
+    {
+        return prepared_selector_type<N>(m_e.coordinates(), m_dimension_mapping, names);
+    }
+
+    template <class CT>
+    template <class Join, std::size_t N>
+    inline auto xreindex_view<CT>::select(const xprepared_selector<subcoordinate_type, dimension_type, N>& selector,
+                                          const label_sequence_type<N>& labels) const -> const_reference
+    {
+        auto outer_index = selector.get_outer_index(labels);
+        return outer_index.second ? m_e.element(outer_index.first) : select_missing<Join>(selector, labels);
+    }
+
+    template <class CT>
+    template <class Join, std::size_t N>
+    inline auto xreindex_view<CT>::select_batch(const name_sequence_type<N>& names, const label_batch_type<N>& labels) const
+        -> xt::xarray<value_type>
+    {
+        return select_batch<Join>(prepare_selector<N>(names), labels);
+    }
+
+    template <class CT>
+    template <class Join, std::size_t N>
+    inline auto xreindex_view<CT>::select_batch(const xprepared_selector<subcoordinate_type, dimension_type, N>& selector,
+                                                const label_batch_type<N>& labels) const -> xt::xarray<value_type>
+    {
+        return selector.template gather<value_type>(labels, [this](const auto& idx)
+        {
+            return m_e.element(idx);
+        }, /*missing*/ [this, &selector](const auto& point)
+        {
+            return this->template select<Join>(selector, point);
+        });
+    }
+
     template <class CT>
     template <std::size_t N>
     inline auto xreindex_view<CT>::iselect(const iselector_sequence_type<N>& selector) const -> const_reference
@@ -372,77 +645,148 @@ namespace xf
     }
 
     template <class CT>
-    template <std::size_t N, class IDX>
-    inline auto xreindex_view<CT>::element_impl(IDX&& index) const -> const_reference
+    inline void xreindex_view<CT>::init_gather_indices(fill_method method, double tolerance)
     {
-        bool contained = true;
-        for(std::size_t i = 0; i < index.size(); ++i)
+        size_type dim = dimension();
+        const auto& reindex_map = m_coordinate.reindex_map();
+        const auto& sub_coordinate = m_coordinate.initial_coordinates();
+        m_gather_indices.resize(dim);
+        for (size_type i = 0; i < dim; ++i)
         {
-            auto dim_name = m_dimension_mapping.label(i);
-            auto iter = m_coordinate.reindex_map().find(dim_name);
-            if(iter != m_coordinate.reindex_map().end())
+            const auto& dim_name = dimension_labels()[i];
+            gather_index_type& gather = m_gather_indices[i];
+            gather.resize(static_cast<std::size_t>(m_shape[i]));
+            auto iter = reindex_map.find(dim_name);
+            if (iter == reindex_map.end())
             {
-                auto label = (iter->second).label(index[i]);
-                auto subiter = m_coordinate.initial_coordinates().find(dim_name);
-                auto subindex = (subiter->second).find(label);
-                if(subindex == (subiter->second).end())
+                std::iota(gather.begin(), gather.end(), std::int64_t(0));
+            }
+            else
+            {
+                const auto& new_axis = iter->second;
+                const auto& sub_axis = sub_coordinate.find(dim_name)->second;
+                if (new_axis.is_sorted() && sub_axis.is_sorted())
                 {
-                    contained = false;
-                    break;
+                    detail::build_sorted_gather_index(new_axis, sub_axis, method, tolerance, gather);
+                }
+                else if (method != fill_method::none)
+                {
+                    throw std::runtime_error("Fill methods require sorted axes");
                 }
                 else
                 {
-                    index[i] = subindex->second;
+                    for (std::size_t j = 0; j < gather.size(); ++j)
+                    {
+                        auto subindex = sub_axis.find(new_axis.label(j));
+                        gather[j] = subindex != sub_axis.end() ? static_cast<std::int64_t>(subindex->second) : std::int64_t(-1);
+                    }
                 }
             }
         }
-        return contained ? m_e.template element<N>(std::forward<IDX>(index)) : missing();
     }
 
     template <class CT>
-    template <std::size_t N, class L>
-    inline auto xreindex_view<CT>::locate_element_impl(L&& locator) const -> const_reference
+    template <std::size_t N, class IDX>
+    inline auto xreindex_view<CT>::element_impl(IDX&& index) const -> const_reference
     {
-        for(std::size_t i = 0; i < locator.size(); ++i)
+        std::decay_t<IDX> subindex(std::forward<IDX>(index));
+        for (std::size_t i = 0; i < subindex.size(); ++i)
         {
-            auto dim_name = m_dimension_mapping.label(i);
-            bool contained = m_coordinate.is_reindexed(dim_name, locator[i]);
-            bool sub_contained = m_coordinate.initial_coordinates().contains(dim_name, locator[i]);
-            if(contained && !sub_contained)
+            std::int64_t pos = m_gather_indices[i][subindex[i]];
+            if (pos < 0)
             {
                 return missing();
             }
+            subindex[i] = static_cast<typename std::decay_t<IDX>::value_type>(pos);
         }
-        return m_e.template locate_element<N>(std::forward<L>(locator));
+        return m_e.template element<N>(std::move(subindex));
     }
 
     template <class CT>
-    template <class S>
-    inline auto xreindex_view<CT>::select_impl(S&& selector) const -> const_reference
+    template <std::size_t N, class L>
+    inline auto xreindex_view<CT>::locate_element_impl(L&& locator) const -> const_reference
     {
-        for(const auto& c: selector)
+        std::decay_t<L> sublocator(std::forward<L>(locator));
+        for(std::size_t i = 0; i < sublocator.size(); ++i)
         {
-            bool contained = m_coordinate.is_reindexed(c.first, c.second);
-            bool sub_contained = m_e.coordinates().contains(c.first, c.second);
-            if(contained && !sub_contained)
+            if(!resolve_label(m_dimension_mapping.label(i), sublocator[i]))
             {
                 return missing();
             }
         }
-        return m_e.select(std::forward<S>(selector));
+        return m_e.template locate_element<N>(std::move(sublocator));
     }
 
     template <class CT>
     template <class Join, class S>
     inline auto xreindex_view<CT>::select_join(S&& selector) const -> const_reference
     {
-        return xtl::mpl::static_if<Join::id() == join::inner::id()>([&](auto self)
+        std::decay_t<S> subselector(std::forward<S>(selector));
+        for(auto& c: subselector)
         {
-            return self(*this).select_impl(std::forward<S>(selector));
-        }, /*else*/ [&](auto self)
+            if(!resolve_label(c.first, c.second))
+            {
+                return missing();
+            }
+        }
+        return m_e.template select<Join>(std::move(subselector));
+    }
+
+    template <class CT>
+    template <class Join, std::size_t N>
+    inline auto xreindex_view<CT>::select_missing(const xprepared_selector<subcoordinate_type, dimension_type, N>& selector,
+                                                  const label_sequence_type<N>& labels) const -> const_reference
+    {
+        const auto& names = selector.names();
+        label_sequence_type<N> sublabels(labels);
+        for (std::size_t i = 0; i < names.size(); ++i)
         {
-            return self(*this).m_e.template select<join::outer>(std::forward<S>(selector));
-        });
+            if (!resolve_label(names[i], sublabels[i]))
+            {
+                return missing();
+            }
+        }
+        auto outer_index = selector.get_outer_index(sublabels);
+        if (outer_index.second)
+        {
+            return m_e.element(outer_index.first);
+        }
+        if (Join::id() == join::inner::id())
+        {
+            // At least one label belongs neither to the reindexed axes nor to the
+            // underlying ones: this throws the same exception as the inner select.
+            return m_e.element(selector.get_index(sublabels));
+        }
+        return missing();
+    }
+
+    /**
+     * Replaces a label of a reindexed axis with the label of the underlying
+     * axis it is gathered from. Labels which do not belong to a reindexed axis
+     * are left unchanged. Returns false if the label is missing.
+     */
+    template <class CT>
+    template <class K, class L>
+    inline bool xreindex_view<CT>::resolve_label(const K& name, L& label) const
+    {
+        const auto& reindex_map = m_coordinate.reindex_map();
+        auto iter = reindex_map.find(name);
+        if (iter != reindex_map.end())
+        {
+            auto pos = (iter->second).find(label);
+            if (pos != (iter->second).end())
+            {
+                const auto& gather = m_gather_indices[m_dimension_mapping[name]];
+                std::int64_t subpos = gather[static_cast<std::size_t>(pos->second)];
+                if (subpos < 0)
+                {
+                    return false;
+                }
+                auto sublabel = m_coordinate.initial_coordinates()[name].label(static_cast<size_type>(subpos));
+                xtl::visit([&label](const auto& l) { label = l; }, sublabel);
+            }
+        }
+        return true;
     }
 
     template <class CT>
@@ -457,30 +801,18 @@ namespace xf
     template <std::size_t N, class S>
     inline auto xreindex_view<CT>::build_iselect_index(S&& selector) const -> std::pair<index_type<N>, bool>
     {
+        using index_value_type = typename index_type<N>::value_type;
         auto res = std::make_pair(xtl::make_sequence<index_type<N>>(dimension(), size_type(0)), true);
-        auto reindex_end = m_coordinate.reindex_map().end();
         for(const auto& c: selector)
         {
-            auto iter = m_coordinate.reindex_map().find(c.first);
-            if(iter != reindex_end)
-            {
-                auto label = (iter->second).label(c.second);
-                auto subiter = m_coordinate.initial_coordinates().find(c.first);
-                auto subindex = (subiter->second).find(label);
-                if(subindex == (subiter->second).end())
-                {
-                    res.second = false;
-                    break;
-                }
-                else
-                {
-                    res.first[m_dimension_mapping[c.first]] = subindex->second;
-                }
-            }
-            else
+            auto dim = m_dimension_mapping[c.first];
+            std::int64_t pos = m_gather_indices[dim][c.second];
+            if(pos < 0)
             {
-                res.first[m_dimension_mapping[c.first]] = c.second;
+                res.second = false;
+                break;
             }
+            res.first[dim] = static_cast<index_value_type>(pos);
         }
         return res;
     }
@@ -489,18 +821,37 @@ namespace xf
      * reindex_view builders implementation *
      ****************************************/
 
+    /**
+     * Builds a view of \c e on new coordinates. Labels of the new axes which
+     * do not belong to the axes of \c e are filled according to \c method:
+     * they are missing by default; \c pad and \c backfill take the value
+     * of the previous and next label of the original axis; \c nearest takes
+     * the value of the closest label, the next one in case of a tie. Filled
+     * labels further than \c tolerance from the label they are filled from are
+     * missing. \c nearest and a finite tolerance require arithmetic labels.
+     * @param e the variable expression to reindex.
+     * @param new_coord the new axes, mapped to the names of their dimensions.
+     * @param method the fill method.
+     * @param tolerance the maximum distance between a filled label and the
+     *                  label it is filled from.
+     * @throw std::runtime_error if \c method is not fill_method::none and an
+     *        axis of \c new_coord or the corresponding axis of \c e is not
+     *        sorted.
+     */
     template <class E>
-    inline auto reindex(E&& e, const typename std::decay_t<E>::coordinate_map& new_coord)
+    inline auto reindex(E&& e, const typename std::decay_t<E>::coordinate_map& new_coord,
+                        fill_method method, double tolerance)
     {
         using view_type = xreindex_view<xtl::closure_type_t<E>>;
-        return view_type(std::forward<E>(e), new_coord);
+        return view_type(std::forward<E>(e), new_coord, method, tolerance);
     }
 
     template <class E>
-    inline auto reindex(E&& e, typename std::decay_t<E>::coordinate_map&& new_coord)
+    inline auto reindex(E&& e, typename std::decay_t<E>::coordinate_map&& new_coord,
+                        fill_method method, double tolerance)
     {
         using view_type = xreindex_view<xtl::closure_type_t<E>>;
-        return view_type(std::forward<E>(e), std::move(new_coord));
+        return view_type(std::forward<E>(e), std::move(new_coord), method, tolerance);
     }
 
     namespace detail
@@ -0,0 +1,397 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XRESAMPLE_HPP
+#define XFRAME_XRESAMPLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xaxis_arange.hpp"
+#include "xaxis_variant.hpp"
+#include "xparallel.hpp"
+#include "xvariable_reducer.hpp"
+
+namespace xf
+{
+    /***********************
+     * xvariable_resampler *
+     ***********************/
+
+    /**
+     * @class xvariable_resampler
+     * @brief Buckets of regular width along a sorted dimension.
+     *
+     * The xvariable_resampler class splits a dimension with sorted integral
+     * labels, such as timestamps, into buckets [start + k * width,
+     * start + (k + 1) * width), where start is the greatest multiple of width
+     * less than or equal to the first label. The methods aggregate the values
+     * of each bucket; in the result, the dimension holds an xaxis_arange of the
+     * start labels of the buckets. Elements of empty buckets are missing.
+     *
+     * Since the labels are sorted, each bucket is a contiguous run of positions,
+     * and the runs are found in a single sweep over the labels. When the
+     * dimension is the innermost one, a run is reduced as a contiguous buffer.
+     *
+     * @tparam CT the closure type of the variable.
+     * @tparam L the integral type of the width of the buckets.
+     * @sa resample
+     */
+    template <class CT, class L>
+    class xvariable_resampler
+    {
+    public:
+
+        using variable_type = std::decay_t<CT>;
+        using coordinate_type = typename variable_type::coordinate_type;
+        using name_type = typename coordinate_type::key_type;
+        using width_type = L;
+        using size_type = std::size_t;
+        using axis_type = typename coordinate_type::axis_type;
+
+        static_assert(std::is_integral<width_type>::value, "resampling width must be integral");
+
+        xvariable_resampler(CT variable, const name_type& dim, width_type width);
+
+        size_type size() const noexcept;
+        const axis_type& buckets() const noexcept;
+
+        auto sum(bool skipna = true) const;
+        auto mean(bool skipna = true) const;
+        auto amin(bool skipna = true) const;
+        auto amax(bool skipna = true) const;
+        auto count() const;
+        auto first(bool skipna = true) const;
+        auto last(bool skipna = true) const;
+
+    private:
+
+        template <template <class> class K>
+        auto aggregate(bool skipna) const;
+
+        CT m_variable;
+        size_type m_dimension;
+        std::vector<size_type> m_bounds;
+        axis_type m_buckets;
+    };
+
+    template <class E, class L>
+    auto resample(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim, L width);
+
+    /**************************************
+     * xvariable_resampler implementation *
+     **************************************/
+
+    namespace detail
+    {
+        template <class L>
+        inline L floor_multiple(L value, L width) noexcept
+        {
+            L q = value / width;
+            return (q - L(value % width != 0 && value < 0)) * width;
+        }
+
+        /**
+         * Fills bounds with the first position of each bucket of the sorted
+         * axis \c axis, whose labels are of type K, and returns the range
+         * axis of the start labels of the buckets. \c width is converted to K.
+         */
+        template <class K, class A, class L>
+        inline std::enable_if_t<std::is_integral<K>::value, A>
+        resample_buckets(const A& axis, L width, std::vector<std::size_t>& bounds)
+        {
+            using size_type = std::size_t;
+            K label_width = static_cast<K>(width);
+            if (static_cast<L>(label_width) != width)
+            {
+                throw std::runtime_error("Resampling width does not fit in the type of the labels");
+            }
+
+            // Labels are read one by one so that range axes
+            // do not build their label list
+            auto label = [&axis](size_type i) { return xtl::get<K>(axis.label(i)); };
+            size_type size = axis.size();
+
+            // bounds[k] is the first position of the k-th bucket
+            K start = floor_multiple(label(0), label_width);
+            K stop = start + label_width;
+            for (size_type i = 0; i < size; ++i)
+            {
+                K l = label(i);
+                while (l >= stop)
+                {
+                    bounds.push_back(i);
+                    stop += label_width;
+                }
+            }
+            bounds.push_back(size);
+            return A(xaxis_arange<K, typename A::mapped_type>(start, label_width, bounds.size() - 1));
+        }
+
+        template <class K, class A, class L>
+        inline std::enable_if_t<!std::is_integral<K>::value, A>
+        resample_buckets(const A&, L, std::vector<std::size_t>&)
+        {
+            throw std::runtime_error("Resampling requires integral labels");
+        }
+    }
+
+    /**
+     * Builds the buckets of the dimension \c dim of a variable.
+     * @param variable the variable.
+     * @param dim the name of the dimension, whose labels must be sorted.
+     * @param width the width of the buckets.
+     */
+    template <class CT, class L>
+    inline xvariable_resampler<CT, L>::xvariable_resampler(CT variable, const name_type& dim, width_type width)
+        : m_variable(std::forward<CT>(variable)), m_dimension(0), m_bounds(), m_buckets()
+    {
+        const auto& dimension_mapping = m_variable.dimension_mapping();
+        if (!dimension_mapping.contains(dim))
+        {
+            throw std::out_of_range("invalid dimension name in resample");
+        }
+        if (!(width > width_type(0)))
+        {
+            throw std::runtime_error("Resampling width must be positive");
+        }
+        const auto& axis = m_variable.coordinates()[dim];
+        if (!axis.is_sorted())
+        {
+            throw std::runtime_error("Resampling requires sorted labels");
+        }
+        m_dimension = dimension_mapping[dim];
+
+        m_bounds.push_back(size_type(0));
+        if (axis.empty())
+        {
+            m_buckets = axis;
+            return;
+        }
+
+        // The buckets are built with the type of the labels
+        // of the axis, whatever the type of width
+        m_buckets = xtl::visit([this, &axis, width](const auto& first)
+        {
+            using key_type = std::decay_t<decltype(first)>;
+            return detail::resample_buckets<key_type>(axis, width, m_bounds);
+        }, axis.label(0));
+    }
+
+    /**
+     * Returns the number of buckets.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::size() const noexcept -> size_type
+    {
+        return m_bounds.size() - 1;
+    }
+
+    /**
+     * Returns the axis of the start labels of the buckets.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::buckets() const noexcept -> const axis_type&
+    {
+        return m_buckets;
+    }
+
+    /**
+     * Returns the sum of the values of each bucket. Missing values are skipped
+     * if \c skipna is true; otherwise an element of the result is missing if
+     * any of the aggregated values is missing.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::sum(bool skipna) const
+    {
+        return aggregate<detail::xsum_kernel>(skipna);
+    }
+
+    /**
+     * Returns the mean of the values of each bucket.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::mean(bool skipna) const
+    {
+        return aggregate<detail::xmean_kernel>(skipna);
+    }
+
+    /**
+     * Returns the minimum of the values of each bucket.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::amin(bool skipna) const
+    {
+        return aggregate<detail::xmin_kernel>(skipna);
+    }
+
+    /**
+     * Returns the maximum of the values of each bucket.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::amax(bool skipna) const
+    {
+        return aggregate<detail::xmax_kernel>(skipna);
+    }
+
+    /**
+     * Returns the number of non-missing values of each bucket.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::count() const
+    {
+        return aggregate<detail::xcount_kernel>(true);
+    }
+
+    /**
+     * Returns the first non-missing value of each bucket.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::first(bool skipna) const
+    {
+        return aggregate<detail::xfirst_kernel>(skipna);
+    }
+
+    /**
+     * Returns the last non-missing value of each bucket.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class CT, class L>
+    inline auto xvariable_resampler<CT, L>::last(bool skipna) const
+    {
+        return aggregate<detail::xlast_kernel>(skipna);
+    }
+
+    template <class CT, class L>
+    template <template <class> class K>
+    inline auto xvariable_resampler<CT, L>::aggregate(bool skipna) const
+    {
+        using coordinate_map = typename coordinate_type::map_type;
+        using dimension_list = typename variable_type::dimension_list;
+        using buffers_type = detail::xreducer_buffers<typename variable_type::data_type>;
+        using kernel_type = K<typename buffers_type::value_type>;
+        using result_type = typename kernel_type::result_type;
+
+        std::vector<size_type> shape(m_variable.shape().cbegin(), m_variable.shape().cend());
+        size_type outer_size = std::accumulate(shape.cbegin(), shape.cbegin() + m_dimension,
+                                               size_type(1), std::multiplies<size_type>());
+        size_type inner_size = std::accumulate(shape.cbegin() + m_dimension + 1, shape.cend(),
+                                               size_type(1), std::multiplies<size_type>());
+        size_type length = shape[m_dimension];
+        size_type nb_buckets = size();
+
+        std::vector<size_type> result_shape = shape;
+        result_shape[m_dimension] = nb_buckets;
+        xt::xarray<result_type> values = xt::xarray<result_type>::from_shape(result_shape);
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape(result_shape);
+        kernel_type kernel(values.size());
+        {
+            const auto& v = buffers_type::values(m_variable.data());
+            const auto& f = buffers_type::flags(m_variable.data());
+            const auto* vp = v.data();
+            const std::uint8_t* fp = reinterpret_cast<const std::uint8_t*>(f.data());
+
+            // Each row of the result, i.e. a bucket for a given position of the
+            // outer dimensions, is written by a single thread.
+            size_type nb_rows = outer_size * nb_buckets;
+            size_type row_size = nb_buckets != 0 ? std::max(length * inner_size / nb_buckets, size_type(1)) : size_type(1);
+            detail::parallel_for_rows(nb_rows, row_size, size_type(1), [&](size_type begin, size_type end)
+            {
+                for (size_type r = begin; r < end; ++r)
+                {
+                    size_type o = r / nb_buckets;
+                    size_type k = r % nb_buckets;
+                    size_type run_begin = m_bounds[k];
+                    size_type run_end = m_bounds[k + 1];
+                    if (inner_size == 1)
+                    {
+                        size_type offset = o * length + run_begin;
+                        kernel.reduce(r, vp + offset, fp + offset, run_end - run_begin);
+                    }
+                    else
+                    {
+                        for (size_type i = run_begin; i < run_end; ++i)
+                        {
+                            size_type offset = (o * length + i) * inner_size;
+                            kernel.accumulate(r * inner_size, vp + offset, fp + offset, inner_size);
+                        }
+                    }
+                }
+            });
+        }
+
+        for (size_type o = 0; o < values.size(); ++o)
+        {
+            size_type k = (o / inner_size) % nb_buckets;
+            size_type bucket_size = m_bounds[k + 1] - m_bounds[k];
+            values.data()[o] = kernel.result(o);
+            flags.data()[o] = bucket_size != 0 && kernel.has_result(o) && (skipna || kernel.count(o) == bucket_size);
+        }
+
+        coordinate_map result_coordinates;
+        dimension_list result_dimensions;
+        for (size_type d = 0; d < shape.size(); ++d)
+        {
+            const auto& name = m_variable.dimension_labels()[d];
+            if (d == m_dimension)
+            {
+                result_coordinates.emplace(name, m_buckets);
+            }
+            else
+            {
+                result_coordinates.emplace(name, m_variable.coordinates()[name]);
+            }
+            result_dimensions.push_back(name);
+        }
+
+        using data_type = xt::xoptional_assembly<xt::xarray<result_type>, xt::xarray<bool>>;
+        return variable(data_type(std::move(values), std::move(flags)),
+                        std::move(result_coordinates),
+                        std::move(result_dimensions));
+    }
+
+    /**
+     * @brief Resamples a sorted dimension into buckets of regular width.
+     *
+     * Returns an object whose methods aggregate the values of \c e per bucket
+     * of \c width along the dimension \c dim, e.g. `resample(v, "time", 60).last()`.
+     * The labels of \c dim must be sorted and integral; \c width is converted
+     * to their type.
+     *
+     * Expressions that are not containers are evaluated first; containers are
+     * referenced by the returned object and must outlive it.
+     * @param e the variable expression to resample.
+     * @param dim the name of the dimension.
+     * @param width the width of the buckets.
+     */
+    template <class E, class L>
+    inline auto resample(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim, L width)
+    {
+        using closure_type = decltype(detail::reducer_operand(e));
+        return xvariable_resampler<closure_type, L>(detail::reducer_operand(e), dim, width);
+    }
+}
+
+#endif
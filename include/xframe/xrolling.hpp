@@ -0,0 +1,731 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XROLLING_HPP
+#define XFRAME_XROLLING_HPP
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xparallel.hpp"
+#include "xvariable_reducer.hpp"
+
+namespace xf
+{
+    /*********************
+     * xvariable_rolling *
+     *********************/
+
+    /**
+     * @class xvariable_rolling
+     * @brief Rolling windows of a variable along a dimension.
+     *
+     * The xvariable_rolling class computes statistics over trailing windows
+     * of a dimension of a variable: the element of the result at position i
+     * of the dimension aggregates the non-missing values at positions
+     * [i - window + 1, i]. An element is missing if the window holds fewer
+     * than min_periods non-missing values. The result has the coordinates
+     * of the variable.
+     *
+     * Windows are updated incrementally when they slide, so that the cost of
+     * an operation does not depend on the size of the windows. The lines of
+     * the variable along the dimension are processed in parallel.
+     *
+     * @tparam CT the closure type of the variable.
+     * @sa rolling
+     */
+    template <class CT>
+    class xvariable_rolling
+    {
+    public:
+
+        using variable_type = std::decay_t<CT>;
+        using coordinate_type = typename variable_type::coordinate_type;
+        using dimension_type = typename variable_type::dimension_type;
+        using name_type = typename coordinate_type::key_type;
+        using size_type = std::size_t;
+
+        xvariable_rolling(CT variable, const name_type& dim, size_type window, size_type min_periods);
+
+        size_type window() const noexcept;
+        size_type min_periods() const noexcept;
+
+        auto sum() const;
+        auto mean() const;
+        auto variance() const;
+        auto stddev() const;
+        auto amin() const;
+        auto amax() const;
+        auto count() const;
+
+    private:
+
+        template <template <class> class K>
+        auto roll() const;
+
+        CT m_variable;
+        size_type m_dimension;
+        size_type m_window;
+        size_type m_min_periods;
+    };
+
+    template <class E>
+    auto rolling(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim,
+                 std::size_t window);
+
+    template <class E>
+    auto rolling(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim,
+                 std::size_t window, std::size_t min_periods);
+
+    /*******************
+     * rolling kernels *
+     *******************/
+
+    namespace detail
+    {
+        /**
+         * Base class of the rolling kernels, counting the non-missing values
+         * of the current window.
+         *
+         * A rolling kernel holds the state of a single window: add is called
+         * with the values entering the window and remove with the values
+         * leaving it, in the order of the dimension. Missing values are never
+         * passed to the kernel.
+         */
+        class xrolling_counter
+        {
+        public:
+
+            std::size_t count() const noexcept;
+
+        protected:
+
+            std::size_t m_count = 0;
+        };
+
+        template <class T>
+        class xrolling_sum_kernel : public xrolling_counter
+        {
+        public:
+
+            using result_type = T;
+
+            explicit xrolling_sum_kernel(std::size_t window);
+
+            void reset() noexcept;
+            void add(std::size_t i, const T& x) noexcept;
+            void remove(std::size_t i, const T& x) noexcept;
+
+            bool has_result() const noexcept;
+            result_type result() const noexcept;
+
+        private:
+
+            T m_sum;
+        };
+
+        template <class T>
+        class xrolling_mean_kernel : public xrolling_counter
+        {
+        public:
+
+            using result_type = std::common_type_t<T, double>;
+
+            explicit xrolling_mean_kernel(std::size_t window);
+
+            void reset() noexcept;
+            void add(std::size_t i, const T& x) noexcept;
+            void remove(std::size_t i, const T& x) noexcept;
+
+            bool has_result() const noexcept;
+            result_type result() const noexcept;
+
+        private:
+
+            result_type m_sum;
+        };
+
+        /**
+         * Variance kernel, based on the online updates of Welford for adding
+         * and removing a value.
+         */
+        template <class T, bool SQRT>
+        class xrolling_variance_kernel : public xrolling_counter
+        {
+        public:
+
+            using result_type = std::common_type_t<T, double>;
+
+            explicit xrolling_variance_kernel(std::size_t window);
+
+            void reset() noexcept;
+            void add(std::size_t i, const T& x) noexcept;
+            void remove(std::size_t i, const T& x) noexcept;
+
+            bool has_result() const noexcept;
+            result_type result() const noexcept;
+
+        private:
+
+            result_type m_mean;
+            result_type m_m2;
+        };
+
+        /**
+         * Extremum kernel, based on a monotonic queue of the positions and
+         * values of the window that may become its extremum. The queue is a
+         * ring buffer of the size of the window.
+         */
+        template <class T, class C>
+        class xrolling_extremum_kernel : public xrolling_counter
+        {
+        public:
+
+            using result_type = T;
+
+            explicit xrolling_extremum_kernel(std::size_t window);
+
+            void reset() noexcept;
+            void add(std::size_t i, const T& x) noexcept;
+            void remove(std::size_t i, const T& x) noexcept;
+
+            bool has_result() const noexcept;
+            result_type result() const noexcept;
+
+        private:
+
+            std::vector<std::pair<std::size_t, T>> m_queue;
+            std::size_t m_front;
+            std::size_t m_size;
+        };
+
+        template <class T>
+        class xrolling_count_kernel : public xrolling_counter
+        {
+        public:
+
+            using result_type = std::size_t;
+
+            explicit xrolling_count_kernel(std::size_t window);
+
+            void reset() noexcept;
+            void add(std::size_t i, const T& x) noexcept;
+            void remove(std::size_t i, const T& x) noexcept;
+
+            bool has_result() const noexcept;
+            result_type result() const noexcept;
+        };
+    }
+
+    /**********************************
+     * rolling kernels implementation *
+     **********************************/
+
+    namespace detail
+    {
+        inline std::size_t xrolling_counter::count() const noexcept
+        {
+            return m_count;
+        }
+
+        /**************************************
+         * xrolling_sum_kernel implementation *
+         **************************************/
+
+        template <class T>
+        inline xrolling_sum_kernel<T>::xrolling_sum_kernel(std::size_t)
+            : m_sum(T(0))
+        {
+        }
+
+        template <class T>
+        inline void xrolling_sum_kernel<T>::reset() noexcept
+        {
+            m_count = 0;
+            m_sum = T(0);
+        }
+
+        template <class T>
+        inline void xrolling_sum_kernel<T>::add(std::size_t, const T& x) noexcept
+        {
+            ++m_count;
+            m_sum += x;
+        }
+
+        template <class T>
+        inline void xrolling_sum_kernel<T>::remove(std::size_t, const T& x) noexcept
+        {
+            --m_count;
+            // Resetting empty windows avoids accumulating rounding errors
+            m_sum = m_count != 0 ? m_sum - x : T(0);
+        }
+
+        template <class T>
+        inline bool xrolling_sum_kernel<T>::has_result() const noexcept
+        {
+            return true;
+        }
+
+        template <class T>
+        inline auto xrolling_sum_kernel<T>::result() const noexcept -> result_type
+        {
+            return m_sum;
+        }
+
+        /***************************************
+         * xrolling_mean_kernel implementation *
+         ***************************************/
+
+        template <class T>
+        inline xrolling_mean_kernel<T>::xrolling_mean_kernel(std::size_t)
+            : m_sum(result_type(0))
+        {
+        }
+
+        template <class T>
+        inline void xrolling_mean_kernel<T>::reset() noexcept
+        {
+            m_count = 0;
+            m_sum = result_type(0);
+        }
+
+        template <class T>
+        inline void xrolling_mean_kernel<T>::add(std::size_t, const T& x) noexcept
+        {
+            ++m_count;
+            m_sum += static_cast<result_type>(x);
+        }
+
+        template <class T>
+        inline void xrolling_mean_kernel<T>::remove(std::size_t, const T& x) noexcept
+        {
+            --m_count;
+            m_sum = m_count != 0 ? m_sum - static_cast<result_type>(x) : result_type(0);
+        }
+
+        template <class T>
+        inline bool xrolling_mean_kernel<T>::has_result() const noexcept
+        {
+            return m_count != 0;
+        }
+
+        template <class T>
+        inline auto xrolling_mean_kernel<T>::result() const noexcept -> result_type
+        {
+            return m_count != 0 ? m_sum / static_cast<result_type>(m_count) : result_type(0);
+        }
+
+        /*******************************************
+         * xrolling_variance_kernel implementation *
+         *******************************************/
+
+        template <class T, bool SQRT>
+        inline xrolling_variance_kernel<T, SQRT>::xrolling_variance_kernel(std::size_t)
+            : m_mean(result_type(0)), m_m2(result_type(0))
+        {
+        }
+
+        template <class T, bool SQRT>
+        inline void xrolling_variance_kernel<T, SQRT>::reset() noexcept
+        {
+            m_count = 0;
+            m_mean = result_type(0);
+            m_m2 = result_type(0);
+        }
+
+        template <class T, bool SQRT>
+        inline void xrolling_variance_kernel<T, SQRT>::add(std::size_t, const T& x) noexcept
+        {
+            ++m_count;
+            result_type y = static_cast<result_type>(x);
+            result_type delta = y - m_mean;
+            m_mean += delta / static_cast<result_type>(m_count);
+            m_m2 += delta * (y - m_mean);
+        }
+
+        template <class T, bool SQRT>
+        inline void xrolling_variance_kernel<T, SQRT>::remove(std::size_t, const T& x) noexcept
+        {
+            --m_count;
+            if (m_count == 0)
+            {
+                m_mean = result_type(0);
+                m_m2 = result_type(0);
+                return;
+            }
+            result_type y = static_cast<result_type>(x);
+            result_type delta = y - m_mean;
+            m_mean -= delta / static_cast<result_type>(m_count);
+            m_m2 -= delta * (y - m_mean);
+        }
+
+        template <class T, bool SQRT>
+        inline bool xrolling_variance_kernel<T, SQRT>::has_result() const noexcept
+        {
+            return m_count != 0;
+        }
+
+        template <class T, bool SQRT>
+        inline auto xrolling_variance_kernel<T, SQRT>::result() const noexcept -> result_type
+        {
+            // Removing values may leave a slightly negative m2
+            result_type m2 = m_m2 > result_type(0) ? m_m2 : result_type(0);
+            result_type var = m_count != 0 ? m2 / static_cast<result_type>(m_count) : result_type(0);
+            return SQRT ? std::sqrt(var) : var;
+        }
+
+        /*******************************************
+         * xrolling_extremum_kernel implementation *
+         *******************************************/
+
+        template <class T, class C>
+        inline xrolling_extremum_kernel<T, C>::xrolling_extremum_kernel(std::size_t window)
+            : m_queue(window), m_front(0), m_size(0)
+        {
+        }
+
+        template <class T, class C>
+        inline void xrolling_extremum_kernel<T, C>::reset() noexcept
+        {
+            m_count = 0;
+            m_front = 0;
+            m_size = 0;
+        }
+
+        template <class T, class C>
+        inline void xrolling_extremum_kernel<T, C>::add(std::size_t i, const T& x) noexcept
+        {
+            ++m_count;
+            std::size_t capacity = m_queue.size();
+            // Values that are not better than x can no longer be the extremum
+            while (m_size != 0 && !C::better(m_queue[(m_front + m_size - 1) % capacity].second, x))
+            {
+                --m_size;
+            }
+            m_queue[(m_front + m_size) % capacity] = std::make_pair(i, x);
+            ++m_size;
+        }
+
+        template <class T, class C>
+        inline void xrolling_extremum_kernel<T, C>::remove(std::size_t i, const T&) noexcept
+        {
+            --m_count;
+            if (m_size != 0 && m_queue[m_front].first == i)
+            {
+                m_front = (m_front + 1) % m_queue.size();
+                --m_size;
+            }
+        }
+
+        template <class T, class C>
+        inline bool xrolling_extremum_kernel<T, C>::has_result() const noexcept
+        {
+            return m_size != 0;
+        }
+
+        template <class T, class C>
+        inline auto xrolling_extremum_kernel<T, C>::result() const noexcept -> result_type
+        {
+            return m_size != 0 ? m_queue[m_front].second : T();
+        }
+
+        /****************************************
+         * xrolling_count_kernel implementation *
+         ****************************************/
+
+        template <class T>
+        inline xrolling_count_kernel<T>::xrolling_count_kernel(std::size_t)
+        {
+        }
+
+        template <class T>
+        inline void xrolling_count_kernel<T>::reset() noexcept
+        {
+            m_count = 0;
+        }
+
+        template <class T>
+        inline void xrolling_count_kernel<T>::add(std::size_t, const T&) noexcept
+        {
+            ++m_count;
+        }
+
+        template <class T>
+        inline void xrolling_count_kernel<T>::remove(std::size_t, const T&) noexcept
+        {
+            --m_count;
+        }
+
+        template <class T>
+        inline bool xrolling_count_kernel<T>::has_result() const noexcept
+        {
+            return true;
+        }
+
+        template <class T>
+        inline auto xrolling_count_kernel<T>::result() const noexcept -> result_type
+        {
+            return m_count;
+        }
+
+        template <class T>
+        using xrolling_min_kernel = xrolling_extremum_kernel<T, xless_than>;
+
+        template <class T>
+        using xrolling_max_kernel = xrolling_extremum_kernel<T, xgreater_than>;
+
+        template <class T>
+        using xrolling_var_kernel = xrolling_variance_kernel<T, false>;
+
+        template <class T>
+        using xrolling_std_kernel = xrolling_variance_kernel<T, true>;
+
+        /**
+         * Rolls the kernel over a line of n values and flags separated by
+         * stride elements, and writes the results with the same stride.
+         */
+        template <class K, class T, class R>
+        inline void roll_line(K& kernel, const T* v, const std::uint8_t* f, std::size_t stride, std::size_t n,
+                              std::size_t window, std::size_t min_periods, R* r, bool* rf)
+        {
+            kernel.reset();
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                if (i >= window)
+                {
+                    std::size_t j = (i - window) * stride;
+                    if (f[j])
+                    {
+                        kernel.remove(i - window, v[j]);
+                    }
+                }
+                std::size_t j = i * stride;
+                if (f[j])
+                {
+                    kernel.add(i, v[j]);
+                }
+                r[j] = kernel.result();
+                rf[j] = kernel.has_result() && kernel.count() >= min_periods;
+            }
+        }
+    }
+
+    /************************************
+     * xvariable_rolling implementation *
+     ************************************/
+
+    /**
+     * Builds the rolling windows of the dimension \c dim of a variable.
+     * @param variable the variable.
+     * @param dim the name of the dimension.
+     * @param window the number of positions of the windows.
+     * @param min_periods the minimum number of non-missing values in a window
+     *                    for the result to be defined.
+     */
+    template <class CT>
+    inline xvariable_rolling<CT>::xvariable_rolling(CT variable, const name_type& dim, size_type window, size_type min_periods)
+        : m_variable(std::forward<CT>(variable)), m_dimension(0), m_window(window), m_min_periods(min_periods)
+    {
+        const auto& dimension_mapping = m_variable.dimension_mapping();
+        if (!dimension_mapping.contains(dim))
+        {
+            throw std::out_of_range("invalid dimension name in rolling");
+        }
+        if (window == 0)
+        {
+            throw std::runtime_error("Rolling window must not be empty");
+        }
+        m_dimension = dimension_mapping[dim];
+    }
+
+    /**
+     * Returns the number of positions of the windows.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::window() const noexcept -> size_type
+    {
+        return m_window;
+    }
+
+    /**
+     * Returns the minimum number of non-missing values in a window for
+     * the result to be defined.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::min_periods() const noexcept -> size_type
+    {
+        return m_min_periods;
+    }
+
+    /**
+     * Returns the rolling sum of the values.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::sum() const
+    {
+        return roll<detail::xrolling_sum_kernel>();
+    }
+
+    /**
+     * Returns the rolling mean of the values.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::mean() const
+    {
+        return roll<detail::xrolling_mean_kernel>();
+    }
+
+    /**
+     * Returns the rolling population variance of the values.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::variance() const
+    {
+        return roll<detail::xrolling_var_kernel>();
+    }
+
+    /**
+     * Returns the rolling population standard deviation of the values.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::stddev() const
+    {
+        return roll<detail::xrolling_std_kernel>();
+    }
+
+    /**
+     * Returns the rolling minimum of the values.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::amin() const
+    {
+        return roll<detail::xrolling_min_kernel>();
+    }
+
+    /**
+     * Returns the rolling maximum of the values.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::amax() const
+    {
+        return roll<detail::xrolling_max_kernel>();
+    }
+
+    /**
+     * Returns the number of non-missing values of the windows.
+     */
+    template <class CT>
+    inline auto xvariable_rolling<CT>::count() const
+    {
+        return roll<detail::xrolling_count_kernel>();
+    }
+
+    template <class CT>
+    template <template <class> class K>
+    inline auto xvariable_rolling<CT>::roll() const
+    {
+        using buffers_type = detail::xreducer_buffers<typename variable_type::data_type>;
+        using kernel_type = K<typename buffers_type::value_type>;
+        using result_type = typename kernel_type::result_type;
+
+        std::vector<size_type> shape(m_variable.shape().cbegin(), m_variable.shape().cend());
+        size_type inner_size = std::accumulate(shape.cbegin() + m_dimension + 1, shape.cend(),
+                                               size_type(1), std::multiplies<size_type>());
+        size_type length = shape[m_dimension];
+        size_type nb_lines = length != 0 ? size_type(std::accumulate(shape.cbegin(), shape.cend(), size_type(1),
+                                                                     std::multiplies<size_type>()) / length)
+                                         : size_type(0);
+
+        xt::xarray<result_type> values = xt::xarray<result_type>::from_shape(shape);
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape(shape);
+        {
+            const auto& v = buffers_type::values(m_variable.data());
+            const auto& f = buffers_type::flags(m_variable.data());
+            const auto* vp = v.data();
+            const std::uint8_t* fp = reinterpret_cast<const std::uint8_t*>(f.data());
+            result_type* rp = values.data();
+            bool* rfp = flags.data();
+            size_type window = m_window;
+            size_type min_periods = m_min_periods;
+
+            // Lines along the dimension are independent, consecutive lines
+            // start at consecutive elements when the dimension is not the
+            // innermost one.
+            detail::parallel_for_rows(nb_lines, length, size_type(1), [&](size_type begin, size_type end)
+            {
+                kernel_type kernel(window);
+                for (size_type l = begin; l < end; ++l)
+                {
+                    size_type offset = (l / inner_size) * length * inner_size + l % inner_size;
+                    detail::roll_line(kernel, vp + offset, fp + offset, inner_size, length,
+                                      window, min_periods, rp + offset, rfp + offset);
+                }
+            });
+        }
+
+        using data_type = xt::xoptional_assembly<xt::xarray<result_type>, xt::xarray<bool>>;
+        return variable(data_type(std::move(values), std::move(flags)),
+                        coordinate_type(m_variable.coordinates()),
+                        dimension_type(m_variable.dimension_mapping()));
+    }
+
+    /**
+     * @brief Rolling windows along a dimension.
+     *
+     * Returns an object whose methods compute statistics over the trailing
+     * windows of \c window positions of the dimension \c dim of \c e, e.g.
+     * `rolling(v, "time", 20).mean()`. An element of the result is missing
+     * unless all the values of its window are non-missing.
+     *
+     * Expressions that are not containers are evaluated first; containers are
+     * referenced by the returned object and must outlive it.
+     * @param e the variable expression.
+     * @param dim the name of the dimension.
+     * @param window the number of positions of the windows.
+     */
+    template <class E>
+    inline auto rolling(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim,
+                        std::size_t window)
+    {
+        return rolling(e, dim, window, window);
+    }
+
+    /**
+     * @brief Rolling windows along a dimension.
+     *
+     * Returns an object whose methods compute statistics over the trailing
+     * windows of \c window positions of the dimension \c dim of \c e. An
+     * element of the result is missing if its window holds fewer than
+     * \c min_periods non-missing values.
+     * @param e the variable expression.
+     * @param dim the name of the dimension.
+     * @param window the number of positions of the windows.
+     * @param min_periods the minimum number of non-missing values in a window.
+     */
+    template <class E>
+    inline auto rolling(const E& e, const typename std::decay_t<E>::coordinate_type::key_type& dim,
+                        std::size_t window, std::size_t min_periods)
+    {
+        using closure_type = decltype(detail::reducer_operand(e));
+        return xvariable_rolling<closure_type>(detail::reducer_operand(e), dim, window, min_periods);
+    }
+}
+
+#endif
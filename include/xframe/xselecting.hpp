@@ -11,7 +11,11 @@
 #ifndef XFRAME_XSELECTING_HPP
 #define XFRAME_XSELECTING_HPP
 
+#include <algorithm>
 #include <limits>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
 
 #include "xtl/xmasked_value.hpp"
 #include "xtl/xsequence.hpp"
@@ -42,6 +46,19 @@ namespace xf
             }
         };
 
+        // Flags that are not addressable, such as the bits
+        // of a validity bitmap, are returned by value
+        template <class T, class B>
+        struct static_missing_impl<xtl::xoptional<const T&, B>>
+        {
+            using return_type = xtl::xoptional<const T&, B>;
+            static inline return_type get()
+            {
+                static T val = T(0);
+                return return_type(val, B(false));
+            }
+        };
+
         template <class T, class B>
         struct static_missing_impl<xtl::xmasked_value<T, B>>
         {
@@ -157,6 +174,118 @@ namespace xf
         sequence_type m_coord;
     };
 
+    /**********************
+     * xprepared_selector *
+     **********************/
+
+    /**
+     * @class xprepared_selector
+     * @brief Selector resolved against coordinates and dimension mapping.
+     *
+     * The xprepared_selector class resolves a list of dimension names once,
+     * i.e. it looks up their positions in the dimension mapping and the
+     * axes they are mapped to in the coordinates. Selecting an element with
+     * a prepared selector only requires the labels, and does not perform
+     * any lookup of dimension names. This is useful when the same dimensions
+     * are selected many times, for instance in a loop.
+     *
+     * A prepared selector holds references to the axes of the coordinates it
+     * has been prepared with; it must not outlive them, and must only be used
+     * with the expression it has been prepared from.
+     *
+     * @tparam C the type of the coordinates.
+     * @tparam D the type of the dimension mapping.
+     * @tparam N the number of dimension names.
+     */
+    template <class C, class D, std::size_t N>
+    class xprepared_selector
+    {
+    public:
+
+        static_assert(is_coordinate<C>::value, "first parameter of xprepared_selector must be xcoordinate");
+        static_assert(is_dimension<D>::value, "second parameter of xprepared_selector must be xdimension");
+
+        using coordinate_type = C;
+        using key_type = typename coordinate_type::key_type;
+        using label_list = typename coordinate_type::label_list;
+        using mapped_type = mpl::cast_t<label_list, xtl::variant>;
+        using axis_type = typename coordinate_type::mapped_type;
+        using size_type = typename coordinate_type::index_type;
+        using index_type = detail::xselector_sequence_t<size_type, N>;
+        using outer_index_type = std::pair<index_type, bool>;
+        using dimension_type = D;
+        using name_sequence_type = detail::xselector_sequence_t<key_type, N>;
+        using label_sequence_type = detail::xselector_sequence_t<mapped_type, N>;
+        using label_batch_type = detail::xselector_sequence_t<std::vector<mapped_type>, N>;
+
+        xprepared_selector(const coordinate_type& coord, const dimension_type& dim, const name_sequence_type& names);
+        xprepared_selector(const coordinate_type& coord, const dimension_type& dim, name_sequence_type&& names);
+
+        size_type size() const noexcept;
+        const name_sequence_type& names() const noexcept;
+
+        index_type get_index(const label_sequence_type& labels) const;
+        outer_index_type get_outer_index(const label_sequence_type& labels) const;
+
+        template <class R, class F, class M>
+        xt::xarray<R> gather(const label_batch_type& labels, F&& f, M&& m) const;
+
+    private:
+
+        using position_sequence_type = detail::xselector_sequence_t<size_type, N>;
+        using axis_sequence_type = detail::xselector_sequence_t<const axis_type*, N>;
+        using batch_index_type = std::vector<size_type>;
+
+        void resolve(const coordinate_type& coord, const dimension_type& dim);
+        size_type batch_size(const label_batch_type& labels) const;
+        void resolve_batch(std::size_t i, const std::vector<mapped_type>& labels, batch_index_type& index,
+                           std::vector<bool>& found, std::vector<std::size_t>& order) const;
+
+        name_sequence_type m_names;
+        position_sequence_type m_positions;
+        axis_sequence_type m_axes;
+        size_type m_dimension;
+    };
+
+    namespace detail
+    {
+        /**
+         * Binds labels to a prepared selector so that it can be used
+         * wherever a selector is expected. The coordinates and the dimension
+         * mapping passed to get_index are ignored since the prepared selector
+         * has already been resolved against them.
+         */
+        template <class S>
+        class xprepared_selector_binding
+        {
+        public:
+
+            using selector_type = S;
+            using index_type = typename selector_type::index_type;
+            using outer_index_type = typename selector_type::outer_index_type;
+            using label_sequence_type = typename selector_type::label_sequence_type;
+
+            xprepared_selector_binding(const selector_type& selector, const label_sequence_type& labels);
+
+            template <class C, class D>
+            index_type get_index(const C& coord, const D& dim) const;
+
+            template <class C, class D>
+            outer_index_type get_outer_index(const C& coord, const D& dim) const;
+
+        private:
+
+            const selector_type& m_selector;
+            const label_sequence_type& m_labels;
+        };
+
+        template <class S>
+        inline xprepared_selector_binding<S> bind_labels(const S& selector, const typename S::label_sequence_type& labels)
+        {
+            return xprepared_selector_binding<S>(selector, labels);
+        }
+    }
+
     /********************
      * xselector_traits *
      ********************/
@@ -175,6 +304,10 @@ namespace xf
         using iselector_sequence_type = typename iselector_type::sequence_type;
         using locator_type = xlocator<coordinate_type, dimension_type, N>;
         using locator_sequence_type = typename locator_type::sequence_type;
+        using prepared_selector_type = xprepared_selector<coordinate_type, dimension_type, N>;
+        using name_sequence_type = typename prepared_selector_type::name_sequence_type;
+        using label_sequence_type = typename prepared_selector_type::label_sequence_type;
+        using label_batch_type = typename prepared_selector_type::label_batch_type;
 
         static constexpr std::size_t static_dimension = N;
     };
@@ -296,6 +429,273 @@ namespace xf
         return res;
     }
 
+    /*************************************
+     * xprepared_selector implementation *
+     *************************************/
+
+    /**
+     * Builds a prepared selector for the specified dimension names. Names that
+     * do not belong to the dimension mapping are ignored, as in xselector.
+     * @param coord the coordinates to resolve the axes from.
+     * @param dim the dimension mapping to resolve the positions from.
+     * @param names the dimension names that will be selected.
+     */
+    template <class C, class D, std::size_t N>
+    inline xprepared_selector<C, D, N>::xprepared_selector(const coordinate_type& coord, const dimension_type& dim,
+                                                           const name_sequence_type& names)
+        : m_names(names)
+    {
+        resolve(coord, dim);
+    }
+
+    template <class C, class D, std::size_t N>
+    inline xprepared_selector<C, D, N>::xprepared_selector(const coordinate_type& coord, const dimension_type& dim,
+                                                           name_sequence_type&& names)
+        : m_names(std::move(names))
+    {
+        resolve(coord, dim);
+    }
+
+    /**
+     * Returns the number of dimension names of the selector, i.e. the
+     * number of labels expected by get_index.
+     */
+    template <class C, class D, std::size_t N>
+    inline auto xprepared_selector<C, D, N>::size() const noexcept -> size_type
+    {
+        return m_names.size();
+    }
+
+    /**
+     * Returns the dimension names of the selector.
+     */
+    template <class C, class D, std::size_t N>
+    inline auto xprepared_selector<C, D, N>::names() const noexcept -> const name_sequence_type&
+    {
+        return m_names;
+    }
+
+    /**
+     * Returns the index of the element at the specified labels. The i-th
+     * label is looked up in the axis of the i-th dimension name. If a label
+     * cannot be found, an exception is thrown.
+     * @param labels the labels of the element, in the order of the names.
+     */
+    template <class C, class D, std::size_t N>
+    inline auto xprepared_selector<C, D, N>::get_index(const label_sequence_type& labels) const
+        -> index_type
+    {
+        index_type res = xtl::make_sequence<index_type>(m_dimension, size_type(0));
+        for (std::size_t i = 0; i < m_names.size(); ++i)
+        {
+            if (m_axes[i] != nullptr)
+            {
+                res[m_positions[i]] = (*m_axes[i])[labels[i]];
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Returns the index of the element at the specified labels, and a
+     * boolean that is false if one of the labels cannot be found.
+     * @param labels the labels of the element, in the order of the names.
+     */
+    template <class C, class D, std::size_t N>
+    inline auto xprepared_selector<C, D, N>::get_outer_index(const label_sequence_type& labels) const
+        -> outer_index_type
+    {
+        outer_index_type res(xtl::make_sequence<index_type>(m_dimension, size_type(0)), true);
+        for (std::size_t i = 0; i < m_names.size(); ++i)
+        {
+            if (m_axes[i] != nullptr)
+            {
+                const axis_type& axis = *m_axes[i];
+                auto iter = axis.find(labels[i]);
+                if (iter != axis.end())
+                {
+                    res.first[m_positions[i]] = iter->second;
+                }
+                else
+                {
+                    res.second = false;
+                    break;
+                }
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Gathers the elements at many label tuples. The labels are given as one
+     * vector per dimension name, the k-th tuple being made of the k-th label
+     * of each vector. Each axis is resolved batch-wise: the labels are sorted
+     * so that duplicated labels are looked up once. The resulting indices are
+     * then sorted so that the elements are accessed in memory order, and
+     * duplicated tuples are accessed once.
+     * @param labels the labels of the elements, one vector per dimension name.
+     * @param f the function called with the index of an element, returning
+     * this element.
+     * @param m the function called with the labels of an element that could
+     * not be found. It returns a missing value or throws.
+     * @return a one-dimensional array holding the elements, in the order of
+     * the label tuples.
+     * @tparam R the value type of the returned array.
+     */
+    template <class C, class D, std::size_t N>
+    template <class R, class F, class M>
+    inline xt::xarray<R> xprepared_selector<C, D, N>::gather(const label_batch_type& labels, F&& f, M&& m) const
+    {
+        size_type size = batch_size(labels);
+        batch_index_type index(size * m_dimension, size_type(0));
+        std::vector<bool> found(size, true);
+        std::vector<std::size_t> order(size);
+        for (std::size_t i = 0; i < m_names.size(); ++i)
+        {
+            if (m_axes[i] != nullptr)
+            {
+                resolve_batch(i, labels[i], index, found, order);
+            }
+        }
+
+        auto row = [&index, this](std::size_t k) { return index.cbegin() + static_cast<std::ptrdiff_t>(k * m_dimension); };
+        auto same_row = [&row, this](std::size_t k1, std::size_t k2) { return std::equal(row(k1), row(k1) + m_dimension, row(k2)); };
+
+        // Tuples that could not be found come first, then the other ones
+        // in lexicographic order of their indices.
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::sort(order.begin(), order.end(), [&](std::size_t k1, std::size_t k2)
+        {
+            if (found[k1] != found[k2])
+            {
+                return !found[k1];
+            }
+            return std::lexicographical_compare(row(k1), row(k1) + m_dimension, row(k2), row(k2) + m_dimension);
+        });
+
+        xt::xarray<R> res = xt::xarray<R>::from_shape({size});
+        index_type idx = xtl::make_sequence<index_type>(m_dimension, size_type(0));
+        label_sequence_type point = xtl::make_sequence<label_sequence_type>(m_names.size(), mapped_type());
+        std::size_t i = 0;
+        while (i != order.size())
+        {
+            std::size_t k = order[i++];
+            if (!found[k])
+            {
+                for (std::size_t j = 0; j < m_names.size(); ++j)
+                {
+                    point[j] = labels[j][k];
+                }
+                res(k) = m(point);
+            }
+            else
+            {
+                std::copy(row(k), row(k) + m_dimension, idx.begin());
+                R value = f(idx);
+                res(k) = value;
+                while (i != order.size() && same_row(order[i], k))
+                {
+                    res(order[i++]) = value;
+                }
+            }
+        }
+        return res;
+    }
+
+    template <class C, class D, std::size_t N>
+    inline void xprepared_selector<C, D, N>::resolve(const coordinate_type& coord, const dimension_type& dim)
+    {
+        m_positions = xtl::make_sequence<position_sequence_type>(m_names.size(), size_type(0));
+        m_axes = xtl::make_sequence<axis_sequence_type>(m_names.size(), nullptr);
+        m_dimension = dim.size();
+        for (std::size_t i = 0; i < m_names.size(); ++i)
+        {
+            auto iter = dim.find(m_names[i]);
+            if (iter != dim.end())
+            {
+                m_positions[i] = iter->second;
+                m_axes[i] = &coord[m_names[i]];
+            }
+        }
+    }
+
+    template <class C, class D, std::size_t N>
+    inline auto xprepared_selector<C, D, N>::batch_size(const label_batch_type& labels) const -> size_type
+    {
+        if (labels.size() != m_names.size())
+        {
+            throw std::runtime_error("gather: expected one label vector per dimension name");
+        }
+        size_type size = labels.size() != 0 ? labels[0].size() : size_type(0);
+        for (const auto& l : labels)
+        {
+            if (l.size() != size)
+            {
+                throw std::runtime_error("gather: label vectors must have the same size");
+            }
+        }
+        return size;
+    }
+
+    template <class C, class D, std::size_t N>
+    inline void xprepared_selector<C, D, N>::resolve_batch(std::size_t i, const std::vector<mapped_type>& labels,
+                                                           batch_index_type& index, std::vector<bool>& found,
+                                                           std::vector<std::size_t>& order) const
+    {
+        const axis_type& axis = *m_axes[i];
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::sort(order.begin(), order.end(), [&labels](std::size_t k1, std::size_t k2) { return labels[k1] < labels[k2]; });
+
+        std::size_t j = 0;
+        while (j != order.size())
+        {
+            const mapped_type& label = labels[order[j]];
+            auto iter = axis.find(label);
+            bool contained = iter != axis.end();
+            size_type position = contained ? static_cast<size_type>(iter->second) : size_type(0);
+            do
+            {
+                std::size_t k = order[j++];
+                index[k * m_dimension + m_positions[i]] = position;
+                if (!contained)
+                {
+                    found[k] = false;
+                }
+            }
+            while (j != order.size() && labels[order[j]] == label);
+        }
+    }
+
+    /*********************************************
+     * xprepared_selector_binding implementation *
+     *********************************************/
+
+    namespace detail
+    {
+        template <class S>
+        inline xprepared_selector_binding<S>::xprepared_selector_binding(const selector_type& selector,
+                                                                         const label_sequence_type& labels)
+            : m_selector(selector), m_labels(labels)
+        {
+        }
+
+        template <class S>
+        template <class C, class D>
+        inline auto xprepared_selector_binding<S>::get_index(const C& /*coord*/, const D& /*dim*/) const
+            -> index_type
+        {
+            return m_selector.get_index(m_labels);
+        }
+
+        template <class S>
+        template <class C, class D>
+        inline auto xprepared_selector_binding<S>::get_outer_index(const C& /*coord*/, const D& /*dim*/) const
+            -> outer_index_type
+        {
+            return m_selector.get_outer_index(m_labels);
+        }
+    }
+
 }
 
 #endif
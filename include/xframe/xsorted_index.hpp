@@ -0,0 +1,149 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XSORTED_INDEX_HPP
+#define XFRAME_XSORTED_INDEX_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <numeric>
+#include <vector>
+
+namespace xf
+{
+    /*****************
+     * xsorted_index *
+     *****************/
+
+    /**
+     * @class xsorted_index
+     * @brief Label index based on binary search.
+     *
+     * The xsorted_index class is the index used by axes built with the
+     * \c sorted_vector_tag. It does not hold any copy of the labels: lookups
+     * are binary searches in the list of labels of the axis. When this list is
+     * not sorted, the index holds the permutation that sorts it.
+     *
+     * @tparam K the type of the labels.
+     * @tparam T the integer type used to represent positions.
+     */
+    template <class K, class T>
+    class xsorted_index
+    {
+    public:
+
+        using key_type = K;
+        using mapped_type = T;
+        using size_type = std::size_t;
+        using permutation_type = std::vector<mapped_type>;
+
+        xsorted_index() = default;
+
+        template <class LL>
+        void build(const LL& labels, bool is_sorted);
+
+        void clear() noexcept;
+
+        bool is_identity() const noexcept;
+        const permutation_type& permutation() const noexcept;
+
+        template <class LL>
+        size_type find(const LL& labels, const key_type& key) const;
+
+    private:
+
+        permutation_type m_permutation;
+        bool m_identity = true;
+    };
+
+    /********************************
+     * xsorted_index implementation *
+     ********************************/
+
+    /**
+     * Builds the index of the specified list of labels. If the list is sorted,
+     * no memory is allocated.
+     * @param labels the list of labels.
+     * @param is_sorted a boolean indicating whether the list is sorted.
+     */
+    template <class K, class T>
+    template <class LL>
+    inline void xsorted_index<K, T>::build(const LL& labels, bool is_sorted)
+    {
+        if (is_sorted)
+        {
+            clear();
+        }
+        else
+        {
+            m_permutation.resize(labels.size());
+            std::iota(m_permutation.begin(), m_permutation.end(), mapped_type(0));
+            std::stable_sort(m_permutation.begin(), m_permutation.end(),
+                [&labels](mapped_type lhs, mapped_type rhs) { return labels[lhs] < labels[rhs]; });
+            m_identity = false;
+        }
+    }
+
+    /**
+     * Releases the permutation, the index then assumes the labels are sorted.
+     */
+    template <class K, class T>
+    inline void xsorted_index<K, T>::clear() noexcept
+    {
+        permutation_type().swap(m_permutation);
+        m_identity = true;
+    }
+
+    /**
+     * Returns true if the index does not hold any permutation.
+     */
+    template <class K, class T>
+    inline bool xsorted_index<K, T>::is_identity() const noexcept
+    {
+        return m_identity;
+    }
+
+    /**
+     * Returns the permutation that sorts the labels. This permutation
+     * is empty if the labels are already sorted.
+     */
+    template <class K, class T>
+    inline auto xsorted_index<K, T>::permutation() const noexcept -> const permutation_type&
+    {
+        return m_permutation;
+    }
+
+    /**
+     * Returns the position of the specified label in the list of labels, or
+     * the size of the list if the label could not be found.
+     * @param labels the list of labels the index was built from.
+     * @param key the label to search for.
+     */
+    template <class K, class T>
+    template <class LL>
+    inline auto xsorted_index<K, T>::find(const LL& labels, const key_type& key) const -> size_type
+    {
+        if (m_identity)
+        {
+            auto iter = std::lower_bound(labels.cbegin(), labels.cend(), key);
+            return (iter != labels.cend() && !(key < *iter)) ?
+                static_cast<size_type>(iter - labels.cbegin()) : labels.size();
+        }
+        else
+        {
+            auto iter = std::lower_bound(m_permutation.cbegin(), m_permutation.cend(), key,
+                [&labels](mapped_type pos, const key_type& k) { return labels[pos] < k; });
+            return (iter != m_permutation.cend() && !(key < labels[*iter])) ?
+                static_cast<size_type>(*iter) : labels.size();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,481 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XSTRING_LABEL_HPP
+#define XFRAME_XSTRING_LABEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "xflat_hash_map.hpp"
+
+namespace xf
+{
+    /**********************
+     * xstring_dictionary *
+     **********************/
+
+    /**
+     * @class xstring_dictionary
+     * @brief Process-wide dictionary of strings.
+     *
+     * The xstring_dictionary class interns strings: each distinct string is
+     * stored once in an append-only arena and is identified by a 32-bit code.
+     * Strings are never removed, so codes and pointers to the characters
+     * remain valid until the end of the program.
+     *
+     * Inserting strings is thread-safe; reading a string from a code that
+     * has been returned by \c insert does not require any synchronization.
+     */
+    class xstring_dictionary
+    {
+    public:
+
+        using code_type = std::uint32_t;
+        using size_type = std::size_t;
+
+        static xstring_dictionary& instance();
+
+        xstring_dictionary(const xstring_dictionary&) = delete;
+        xstring_dictionary& operator=(const xstring_dictionary&) = delete;
+
+        code_type insert(const char* str, size_type size);
+
+        const char* data(code_type code) const noexcept;
+        size_type size(code_type code) const noexcept;
+
+        size_type size() const noexcept;
+        size_type arena_size() const noexcept;
+
+    private:
+
+        struct entry
+        {
+            const char* m_data;
+            size_type m_size;
+        };
+
+        struct key
+        {
+            const char* m_data = nullptr;
+            size_type m_size = 0;
+        };
+
+        struct key_hash
+        {
+            std::size_t operator()(const key& k) const noexcept;
+        };
+
+        struct key_equal
+        {
+            bool operator()(const key& lhs, const key& rhs) const noexcept;
+        };
+
+        static constexpr size_type page_bits = 16;
+        static constexpr size_type page_size = size_type(1) << page_bits;
+        static constexpr size_type page_count = size_type(1) << (32 - page_bits);
+        static constexpr size_type block_size = size_type(1) << 16;
+
+        xstring_dictionary();
+
+        const entry& get(code_type code) const noexcept;
+        const char* store(const char* str, size_type size);
+
+        std::unique_ptr<std::atomic<entry*>[]> m_pages;
+        std::vector<std::unique_ptr<entry[]>> m_page_storage;
+        std::vector<std::unique_ptr<char[]>> m_blocks;
+        char* m_block_cursor;
+        size_type m_block_left;
+        size_type m_arena_size;
+        xflat_hash_map<key, code_type, key_hash, key_equal> m_codes;
+        std::atomic<size_type> m_size;
+        mutable std::mutex m_mutex;
+    };
+
+    /*****************
+     * xstring_label *
+     *****************/
+
+    /**
+     * @class xstring_label
+     * @brief Dictionary-encoded string label.
+     *
+     * The xstring_label class is a string label that only holds the 32-bit
+     * code of the string in the xstring_dictionary. Copying, hashing and
+     * testing labels for equality operate on the code only; ordering compares
+     * the characters of the strings.
+     *
+     * Using xstring_label instead of \c xf::fstring for string labels reduces
+     * the memory footprint of axes, of their index and of the variant keys
+     * built by selectors. It can be made the default string label by defining
+     * \c XFRAME_ENABLE_STRING_DICTIONARY to 1 before including xframe.
+     */
+    class xstring_label
+    {
+    public:
+
+        using code_type = xstring_dictionary::code_type;
+        using size_type = std::size_t;
+
+        xstring_label() noexcept;
+        xstring_label(const char* str);
+        xstring_label(const char* str, size_type size);
+        xstring_label(const std::string& str);
+
+        code_type code() const noexcept;
+
+        const char* data() const noexcept;
+        const char* c_str() const noexcept;
+        size_type size() const noexcept;
+        bool empty() const noexcept;
+
+        std::string str() const;
+
+        int compare(const xstring_label& rhs) const noexcept;
+
+    private:
+
+        code_type m_code;
+    };
+
+    bool operator==(const xstring_label& lhs, const xstring_label& rhs) noexcept;
+    bool operator!=(const xstring_label& lhs, const xstring_label& rhs) noexcept;
+    bool operator<(const xstring_label& lhs, const xstring_label& rhs) noexcept;
+    bool operator<=(const xstring_label& lhs, const xstring_label& rhs) noexcept;
+    bool operator>(const xstring_label& lhs, const xstring_label& rhs) noexcept;
+    bool operator>=(const xstring_label& lhs, const xstring_label& rhs) noexcept;
+
+    std::ostream& operator<<(std::ostream& out, const xstring_label& label);
+
+    /*************************************
+     * xstring_dictionary implementation *
+     *************************************/
+
+    /**
+     * Returns the dictionary shared by all the string labels.
+     */
+    inline xstring_dictionary& xstring_dictionary::instance()
+    {
+        static xstring_dictionary dictionary;
+        return dictionary;
+    }
+
+    inline xstring_dictionary::xstring_dictionary()
+        : m_pages(new std::atomic<entry*>[page_count]), m_page_storage(), m_blocks(),
+          m_block_cursor(nullptr), m_block_left(0), m_arena_size(0), m_codes(), m_size(0), m_mutex()
+    {
+        for (size_type i = 0; i < page_count; ++i)
+        {
+            m_pages[i].store(nullptr, std::memory_order_relaxed);
+        }
+        // The empty string is the code of default constructed labels
+        insert("", 0);
+    }
+
+    /**
+     * Inserts the specified string if it is not already in the dictionary
+     * and returns its code.
+     * @param str the characters of the string.
+     * @param size the number of characters.
+     */
+    inline auto xstring_dictionary::insert(const char* str, size_type size) -> code_type
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        const code_type* found = m_codes.find(key{str, size});
+        if (found != nullptr)
+        {
+            return *found;
+        }
+
+        size_type code = m_size.load(std::memory_order_relaxed);
+        if (code == page_count * page_size)
+        {
+            throw std::length_error("xstring_dictionary is full");
+        }
+        size_type page = code >> page_bits;
+        entry* entries = m_pages[page].load(std::memory_order_relaxed);
+        if (entries == nullptr)
+        {
+            m_page_storage.emplace_back(new entry[page_size]);
+            entries = m_page_storage.back().get();
+            m_pages[page].store(entries, std::memory_order_release);
+        }
+
+        const char* data = store(str, size);
+        entries[code & (page_size - 1)] = entry{data, size};
+        m_codes.insert(key{data, size}, static_cast<code_type>(code));
+        m_size.store(code + 1, std::memory_order_release);
+        return static_cast<code_type>(code);
+    }
+
+    /**
+     * Returns a pointer to the null-terminated characters of the string
+     * with the specified code.
+     * @param code the code of the string.
+     */
+    inline const char* xstring_dictionary::data(code_type code) const noexcept
+    {
+        return get(code).m_data;
+    }
+
+    /**
+     * Returns the number of characters of the string with the specified code.
+     * @param code the code of the string.
+     */
+    inline auto xstring_dictionary::size(code_type code) const noexcept -> size_type
+    {
+        return get(code).m_size;
+    }
+
+    /**
+     * Returns the number of strings in the dictionary.
+     */
+    inline auto xstring_dictionary::size() const noexcept -> size_type
+    {
+        return m_size.load(std::memory_order_acquire);
+    }
+
+    /**
+     * Returns the number of bytes allocated for storing the characters
+     * of the strings.
+     */
+    inline auto xstring_dictionary::arena_size() const noexcept -> size_type
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return m_arena_size;
+    }
+
+    inline auto xstring_dictionary::get(code_type code) const noexcept -> const entry&
+    {
+        return m_pages[code >> page_bits].load(std::memory_order_acquire)[code & (page_size - 1)];
+    }
+
+    inline const char* xstring_dictionary::store(const char* str, size_type size)
+    {
+        size_type required = size + 1;
+        char* res = nullptr;
+        if (required > block_size / 4)
+        {
+            // Large strings get their own block so that the
+            // current block is not wasted
+            m_blocks.emplace_back(new char[required]);
+            res = m_blocks.back().get();
+            m_arena_size += required;
+        }
+        else
+        {
+            if (required > m_block_left)
+            {
+                m_blocks.emplace_back(new char[block_size]);
+                m_block_cursor = m_blocks.back().get();
+                m_block_left = block_size;
+                m_arena_size += block_size;
+            }
+            res = m_block_cursor;
+            m_block_cursor += required;
+            m_block_left -= required;
+        }
+        std::copy(str, str + size, res);
+        res[size] = '\0';
+        return res;
+    }
+
+    inline std::size_t xstring_dictionary::key_hash::operator()(const key& k) const noexcept
+    {
+        // FNV-1a
+        std::uint64_t h = 14695981039346656037ull;
+        for (size_type i = 0; i < k.m_size; ++i)
+        {
+            h ^= static_cast<unsigned char>(k.m_data[i]);
+            h *= 1099511628211ull;
+        }
+        return static_cast<std::size_t>(h);
+    }
+
+    inline bool xstring_dictionary::key_equal::operator()(const key& lhs, const key& rhs) const noexcept
+    {
+        return lhs.m_size == rhs.m_size && std::memcmp(lhs.m_data, rhs.m_data, lhs.m_size) == 0;
+    }
+
+    /********************************
+     * xstring_label implementation *
+     ********************************/
+
+    /**
+     * @name Constructors
+     */
+    //@{
+    /**
+     * Constructs an empty label.
+     */
+    inline xstring_label::xstring_label() noexcept
+        : m_code(0)
+    {
+    }
+
+    /**
+     * Constructs a label from a null-terminated string. The string is inserted
+     * in the dictionary if it does not already contain it.
+     * @param str the string.
+     */
+    inline xstring_label::xstring_label(const char* str)
+        : xstring_label(str, std::strlen(str))
+    {
+    }
+
+    /**
+     * Constructs a label from a sequence of characters. The string is inserted
+     * in the dictionary if it does not already contain it.
+     * @param str the first character of the string.
+     * @param size the number of characters.
+     */
+    inline xstring_label::xstring_label(const char* str, size_type size)
+        : m_code(xstring_dictionary::instance().insert(str, size))
+    {
+    }
+
+    /**
+     * Constructs a label from a string. The string is inserted
+     * in the dictionary if it does not already contain it.
+     * @param str the string.
+     */
+    inline xstring_label::xstring_label(const std::string& str)
+        : xstring_label(str.data(), str.size())
+    {
+    }
+    //@}
+
+    /**
+     * Returns the code of the label in the dictionary.
+     */
+    inline auto xstring_label::code() const noexcept -> code_type
+    {
+        return m_code;
+    }
+
+    /**
+     * Returns a pointer to the null-terminated characters of the label.
+     */
+    inline const char* xstring_label::data() const noexcept
+    {
+        return xstring_dictionary::instance().data(m_code);
+    }
+
+    /**
+     * Returns a pointer to the null-terminated characters of the label.
+     */
+    inline const char* xstring_label::c_str() const noexcept
+    {
+        return data();
+    }
+
+    /**
+     * Returns the number of characters of the label.
+     */
+    inline auto xstring_label::size() const noexcept -> size_type
+    {
+        return xstring_dictionary::instance().size(m_code);
+    }
+
+    /**
+     * Returns true if the label is the empty string.
+     */
+    inline bool xstring_label::empty() const noexcept
+    {
+        return m_code == 0;
+    }
+
+    /**
+     * Returns a copy of the label as an std::string.
+     */
+    inline std::string xstring_label::str() const
+    {
+        return std::string(data(), size());
+    }
+
+    /**
+     * Compares the characters of this label and of \c rhs lexicographically.
+     * @param rhs the label to compare with.
+     * @return a negative value, zero or a positive value if this label is
+     *         respectively less than, equal to or greater than \c rhs.
+     */
+    inline int xstring_label::compare(const xstring_label& rhs) const noexcept
+    {
+        if (m_code == rhs.m_code)
+        {
+            return 0;
+        }
+        const xstring_dictionary& dict = xstring_dictionary::instance();
+        size_type lsize = dict.size(m_code);
+        size_type rsize = dict.size(rhs.m_code);
+        int res = std::memcmp(dict.data(m_code), dict.data(rhs.m_code), std::min(lsize, rsize));
+        return res != 0 ? res : (lsize < rsize ? -1 : (rsize < lsize ? 1 : 0));
+    }
+
+    inline bool operator==(const xstring_label& lhs, const xstring_label& rhs) noexcept
+    {
+        return lhs.code() == rhs.code();
+    }
+
+    inline bool operator!=(const xstring_label& lhs, const xstring_label& rhs) noexcept
+    {
+        return lhs.code() != rhs.code();
+    }
+
+    inline bool operator<(const xstring_label& lhs, const xstring_label& rhs) noexcept
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    inline bool operator<=(const xstring_label& lhs, const xstring_label& rhs) noexcept
+    {
+        return lhs.compare(rhs) <= 0;
+    }
+
+    inline bool operator>(const xstring_label& lhs, const xstring_label& rhs) noexcept
+    {
+        return lhs.compare(rhs) > 0;
+    }
+
+    inline bool operator>=(const xstring_label& lhs, const xstring_label& rhs) noexcept
+    {
+        return lhs.compare(rhs) >= 0;
+    }
+
+    inline std::ostream& operator<<(std::ostream& out, const xstring_label& label)
+    {
+        out.write(label.data(), static_cast<std::streamsize>(label.size()));
+        return out;
+    }
+}
+
+namespace std
+{
+    template <>
+    struct hash<xf::xstring_label>
+    {
+        std::size_t operator()(const xf::xstring_label& label) const noexcept
+        {
+            return std::hash<xf::xstring_label::code_type>()(label.code());
+        }
+    };
+}
+
+#endif
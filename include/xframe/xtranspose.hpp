@@ -0,0 +1,111 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XTRANSPOSE_HPP
+#define XFRAME_XTRANSPOSE_HPP
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xflag_writer.hpp"
+#include "xvariable_assign.hpp"
+#include "xvariable_reducer.hpp"
+
+namespace xf
+{
+    template <class E>
+    using xtranspose_dimension_list = std::vector<typename std::decay_t<E>::coordinate_type::key_type>;
+
+    template <class E>
+    auto transpose(const E& e, const xtranspose_dimension_list<E>& dims);
+
+    /****************************
+     * transpose implementation *
+     ****************************/
+
+    /**
+     * @brief Reorders the dimensions of a variable.
+     *
+     * Returns a variable holding the values of \c e with its dimensions in the
+     * order of \c dims, which must be a permutation of the dimensions of \c e,
+     * e.g. `transpose(v, {"b", "a", "c"})`. The coordinates are unchanged.
+     *
+     * Contrary to a view, the data is copied, so that operations with other
+     * variables whose dimensions are in the order of \c dims walk both operands
+     * contiguously. The copy proceeds by tiles that fit in cache and is split
+     * across the threads set with set_num_threads. Expressions that are not
+     * containers are evaluated first. The result holds its data in the same
+     * type of container as the variable, e.g. a validity bitmap.
+     * @param e the variable expression to transpose.
+     * @param dims the names of the dimensions of the result, in order.
+     */
+    template <class E>
+    inline auto transpose(const E& e, const xtranspose_dimension_list<E>& dims)
+    {
+        const auto& var = detail::reducer_operand(e);
+        using variable_type = std::decay_t<decltype(var)>;
+        using coordinate_type = typename variable_type::coordinate_type;
+        using dimension_type = typename variable_type::dimension_type;
+        using data_type = std::decay_t<typename variable_type::data_type>;
+        using shape_type = typename data_type::shape_type;
+        using flag_type = std::decay_t<decltype(std::declval<data_type&>().has_value())>;
+
+        const auto& dimension_mapping = var.dimension_mapping();
+        if (dims.size() != dimension_mapping.size())
+        {
+            throw std::runtime_error("Transposed dimensions must be a permutation of the dimensions of the variable");
+        }
+
+        const auto& data = var.data();
+        std::vector<bool> used(dims.size(), false);
+        std::vector<std::size_t> shape;
+        std::vector<std::size_t> strides;
+        for (const auto& name : dims)
+        {
+            if (!dimension_mapping.contains(name))
+            {
+                throw std::out_of_range("invalid dimension name in transpose");
+            }
+            std::size_t dim = static_cast<std::size_t>(dimension_mapping[name]);
+            if (used[dim])
+            {
+                throw std::runtime_error("Transposed dimensions must be a permutation of the dimensions of the variable");
+            }
+            used[dim] = true;
+            shape.push_back(static_cast<std::size_t>(data.shape()[dim]));
+            strides.push_back(static_cast<std::size_t>(data.strides()[dim]));
+        }
+
+        data_type res(shape_type(shape.cbegin(), shape.cend()));
+        {
+            auto* vp = res.value().data();
+            detail::xflag_writer<flag_type> flags(res.has_value());
+            const auto& storage = data.storage();
+            detail::permuted_copy(shape, strides, [vp, &flags, &storage](std::size_t dst, std::size_t src)
+            {
+                auto v = storage[src];
+                vp[dst] = v.value();
+                flags.set(dst, v.has_value());
+            });
+            flags.finalize();
+        }
+
+        return variable(std::move(res),
+                        coordinate_type(var.coordinates()),
+                        dimension_type(dims.cbegin(), dims.cend()));
+    }
+}
+
+#endif
@@ -11,9 +11,876 @@
 #ifndef XFRAME_XVARIABLE_ASSIGN_HPP
 #define XFRAME_XVARIABLE_ASSIGN_HPP
 
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+#include "xtl/xoptional.hpp"
+#include "xtensor/xarray.hpp"
 #include "xtensor/xassign.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+#include "xtensor/xview.hpp"
+#include "xbitmap.hpp"
 #include "xcoordinate.hpp"
 #include "xframe_expression.hpp"
+#include "xparallel.hpp"
+#include "xvariable_meta.hpp"
+
+namespace xf
+{
+    template <class CCT, class ECT>
+    class xvariable_container;
+
+    template <class F, class R, class... CT>
+    class xvariable_function;
+
+    template <class CT>
+    class xreindex_view;
+
+    namespace detail
+    {
+        /****************************
+         * gather index computation *
+         ****************************/
+
+        constexpr std::size_t gather_npos = std::numeric_limits<std::size_t>::max();
+
+        /**
+         * Fills res with the offset in the source data of each label of the target
+         * axis, i.e. position * stride. Labels that are not part of the source axis
+         * are mapped to gather_npos.
+         */
+        template <class A1, class A2>
+        inline void build_gather_offsets(const A1& target, const A2& source,
+                                         std::size_t stride, std::vector<std::size_t>& res)
+        {
+            std::size_t size = target.size();
+            res.resize(size);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                auto iter = source.find(target.label(i));
+                res[i] = iter != source.end() ? static_cast<std::size_t>(iter->second) * stride : gather_npos;
+            }
+        }
+
+        template <class A>
+        inline bool is_same_axis(const A& lhs, const A& rhs)
+        {
+            return lhs == rhs;
+        }
+
+        template <class A1, class A2>
+        inline bool is_same_axis(const A1&, const A2&)
+        {
+            return false;
+        }
+
+        /**
+         * Fills res with the offset in the source data of each label of the target
+         * axis when the source is viewed through a reindexed axis: the labels are
+         * resolved in the reindexed axis, then translated through its gather index.
+         * The lookup is skipped when the target axis is the reindexed axis.
+         */
+        template <class A1, class A2, class G>
+        inline void build_reindex_gather_offsets(const A1& target, const A2& axis, const G& gather,
+                                                 std::size_t stride, std::vector<std::size_t>& res)
+        {
+            std::size_t size = target.size();
+            res.resize(size);
+            bool same_axis = is_same_axis(target, axis);
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                std::int64_t pos = -1;
+                if (same_axis)
+                {
+                    pos = gather[i];
+                }
+                else
+                {
+                    auto iter = axis.find(target.label(i));
+                    pos = iter != axis.end() ? gather[static_cast<std::size_t>(iter->second)] : std::int64_t(-1);
+                }
+                res[i] = pos >= 0 ? static_cast<std::size_t>(pos) * stride : gather_npos;
+            }
+        }
+
+        /********************
+         * reordered copies *
+         ********************/
+
+        constexpr std::size_t reorder_tile_size = 32;
+        constexpr std::size_t reorder_cache_line_size = 64;
+        constexpr std::size_t reorder_min_bytes = std::size_t(1) << 20;
+
+        /**
+         * Calls copy(dst, src) for each element of a row-major destination of
+         * the given shape, where dst is the offset of the element in the
+         * destination and src its offset in a source whose strides along the
+         * dimensions of the destination are src_strides. When the source is
+         * contiguous along another dimension than the last one, these two
+         * dimensions are copied by square tiles, so that the reads and the
+         * writes of a tile stay in cache. Rows of tiles are copied concurrently
+         * if several threads are available.
+         */
+        template <class F>
+        inline void permuted_copy(const std::vector<std::size_t>& shape,
+                                  const std::vector<std::size_t>& src_strides, F&& copy)
+        {
+            std::size_t dimension = shape.size();
+            if (std::find(shape.cbegin(), shape.cend(), std::size_t(0)) != shape.cend())
+            {
+                return;
+            }
+            if (dimension == 0)
+            {
+                copy(std::size_t(0), std::size_t(0));
+                return;
+            }
+
+            std::vector<std::size_t> dst_strides(dimension, std::size_t(1));
+            for (std::size_t d = dimension - 1; d != 0; --d)
+            {
+                dst_strides[d - 1] = dst_strides[d] * shape[d];
+            }
+
+            // b is the innermost dimension of the destination, a the other
+            // dimension along which the source is the most contiguous. Both
+            // skip the dimensions of extent 1, whose stride is 0 in xtensor
+            std::size_t b = dimension - 1;
+            while (b != 0 && shape[b] == 1)
+            {
+                --b;
+            }
+            std::size_t a = b;
+            for (std::size_t d = 0; d < b; ++d)
+            {
+                if (shape[d] != 1 && (a == b || src_strides[d] < src_strides[a]))
+                {
+                    a = d;
+                }
+            }
+            bool tiled = a != b && src_strides[a] < src_strides[b];
+            std::size_t length_a = a != b ? shape[a] : std::size_t(1);
+            std::size_t src_a = a != b ? src_strides[a] : std::size_t(0);
+            std::size_t dst_a = a != b ? dst_strides[a] : std::size_t(0);
+            std::size_t tile_a = tiled ? reorder_tile_size : std::size_t(1);
+            std::size_t tile_b = tiled ? reorder_tile_size : shape[b];
+            std::size_t nb_tiles_a = (length_a + tile_a - 1) / tile_a;
+
+            std::vector<std::size_t> outer;
+            std::size_t outer_size = 1;
+            for (std::size_t d = 0; d < b; ++d)
+            {
+                if (d != a)
+                {
+                    outer.push_back(d);
+                    outer_size *= shape[d];
+                }
+            }
+
+            parallel_for_rows(outer_size * nb_tiles_a, tile_a * shape[b], std::size_t(1), [&](std::size_t begin, std::size_t end)
+            {
+                for (std::size_t r = begin; r < end; ++r)
+                {
+                    std::size_t o = r / nb_tiles_a;
+                    std::size_t a_begin = (r % nb_tiles_a) * tile_a;
+                    std::size_t a_end = std::min(a_begin + tile_a, length_a);
+                    std::size_t dst_base = 0;
+                    std::size_t src_base = 0;
+                    for (auto it = outer.crbegin(); it != outer.crend(); ++it)
+                    {
+                        std::size_t i = o % shape[*it];
+                        o /= shape[*it];
+                        dst_base += i * dst_strides[*it];
+                        src_base += i * src_strides[*it];
+                    }
+                    for (std::size_t b_begin = 0; b_begin < shape[b]; b_begin += tile_b)
+                    {
+                        std::size_t b_end = std::min(b_begin + tile_b, shape[b]);
+                        for (std::size_t i = a_begin; i < a_end; ++i)
+                        {
+                            std::size_t dst = dst_base + i * dst_a + b_begin;
+                            std::size_t src = src_base + i * src_a + b_begin * src_strides[b];
+                            for (std::size_t j = b_begin; j < b_end; ++j, ++dst, src += src_strides[b])
+                            {
+                                copy(dst, src);
+                            }
+                        }
+                    }
+                }
+            });
+        }
+
+        /**
+         * Estimates whether gathering size elements along a dimension of the
+         * given stride in a source of source_size elements is slower than
+         * gathering them from a copy of the source reordered along the target.
+         * Strided reads load a cache line per element once the source does not
+         * fit in cache, while the copy reads and writes each element once.
+         */
+        inline bool is_reorder_cheaper(std::size_t size, std::size_t source_size,
+                                       std::size_t stride, std::size_t value_size) noexcept
+        {
+            if (stride < 2 || source_size * value_size < reorder_min_bytes)
+            {
+                return false;
+            }
+            std::size_t line_elements = std::max(reorder_cache_line_size / value_size, std::size_t(1));
+            std::size_t strided_cost = size * std::min(stride, line_elements);
+            std::size_t reordered_cost = 2 * source_size + size;
+            return strided_cost > reordered_cost;
+        }
+
+        /**************
+         * xgatherers *
+         **************/
+
+        template <class E, class T>
+        struct xgatherer_type;
+
+        template <class E, class T>
+        using xgatherer_t = typename xgatherer_type<std::decay_t<E>, T>::type;
+
+        /**
+         * Generic gatherer, relies on the select method of the expression. It is
+         * used for expressions whose data cannot be accessed by offset (views, ...).
+         */
+        template <class E, class T>
+        class xselect_gatherer
+        {
+        public:
+
+            using value_type = typename E::value_type;
+            using size_type = std::size_t;
+            using selector_sequence_type = typename T::template selector_sequence_type<>;
+
+            xselect_gatherer(const E& e, const T& target);
+
+            template <class I>
+            void set_row(const I& index);
+
+            value_type operator()(size_type i);
+
+        private:
+
+            const E& m_e;
+            const T& m_target;
+            selector_sequence_type m_selector;
+        };
+
+        /**
+         * Gatherer for variables holding their data. Each label of the target
+         * coordinates is resolved once into an offset in the data of the variable.
+         * When the dimensions of the variable are not in the order of the target
+         * and strided reads are estimated to be slower than a copy, the data is
+         * first copied in the order of the target; copies of the gatherer share
+         * the reordered data.
+         */
+        template <class E, class T>
+        class xcontainer_gatherer
+        {
+        public:
+
+            using value_type = typename E::value_type;
+            using size_type = std::size_t;
+
+            xcontainer_gatherer(const E& e, const T& target);
+
+            template <class V>
+            xcontainer_gatherer(const E& e, const T& target, const V& view);
+
+            template <class I>
+            void set_row(const I& index);
+
+            value_type operator()(size_type i) const;
+
+        private:
+
+            using reordered_type = xt::xoptional_assembly<xt::xarray<typename value_type::value_type>, xt::xarray<bool>>;
+
+            std::vector<size_type> reorder_data(const T& target);
+
+            template <class S, class F>
+            void init_offsets(const T& target, const S& strides, F&& build_offsets);
+
+            value_type element(size_type offset) const;
+
+            const E& m_e;
+            std::shared_ptr<const reordered_type> m_reordered;
+            std::vector<std::vector<size_type>> m_offsets;
+            std::vector<size_type> m_inner_offsets;
+            size_type m_row_offset;
+            bool m_row_missing;
+        };
+
+        /**
+         * Gatherer for reindex views on variables holding their data. The offsets
+         * of the underlying variable are computed through the gather indices of
+         * the view, missing labels are filled with missing values.
+         */
+        template <class E, class T>
+        class xreindex_gatherer : public xcontainer_gatherer<typename E::xexpression_type, T>
+        {
+        public:
+
+            using base_type = xcontainer_gatherer<typename E::xexpression_type, T>;
+
+            xreindex_gatherer(const E& e, const T& target);
+        };
+
+        template <class E, class T>
+        class xscalar_gatherer
+        {
+        public:
+
+            using value_type = typename E::value_type;
+            using size_type = std::size_t;
+
+            xscalar_gatherer(const E& e, const T& target);
+
+            template <class I>
+            void set_row(const I&) noexcept {}
+
+            const value_type& operator()(size_type) const noexcept { return m_value; }
+
+        private:
+
+            value_type m_value;
+        };
+
+        template <class E, class T>
+        class xfunction_gatherer;
+
+        template <class F, class R, class... CT, class T>
+        class xfunction_gatherer<xvariable_function<F, R, CT...>, T>
+        {
+        public:
+
+            using expression_type = xvariable_function<F, R, CT...>;
+            using functor_type = typename expression_type::functor_type;
+            using value_type = R;
+            using size_type = std::size_t;
+
+            xfunction_gatherer(const expression_type& e, const T& target);
+
+            template <class I>
+            void set_row(const I& index);
+
+            value_type operator()(size_type i);
+
+        private:
+
+            template <std::size_t... I>
+            xfunction_gatherer(std::index_sequence<I...>, const expression_type& e, const T& target);
+
+            template <std::size_t... I>
+            value_type access_impl(std::index_sequence<I...>, size_type i);
+
+            using gatherer_tuple = std::tuple<xgatherer_t<xvariable_closure_t<CT>, T>...>;
+
+            gatherer_tuple m_gatherers;
+            const functor_type& m_f;
+        };
+
+        template <class E, class T>
+        struct xgatherer_type
+        {
+            using type = xselect_gatherer<E, T>;
+        };
+
+        template <class CCT, class ECT, class T>
+        struct xgatherer_type<xvariable_container<CCT, ECT>, T>
+        {
+            using type = xcontainer_gatherer<xvariable_container<CCT, ECT>, T>;
+        };
+
+        template <class CT, class T>
+        struct xgatherer_type<xvariable_scalar<CT>, T>
+        {
+            using type = xscalar_gatherer<xvariable_scalar<CT>, T>;
+        };
+
+        template <class F, class R, class... CT, class T>
+        struct xgatherer_type<xvariable_function<F, R, CT...>, T>
+        {
+            using type = xfunction_gatherer<xvariable_function<F, R, CT...>, T>;
+        };
+
+        template <class E>
+        struct is_variable_container : std::false_type
+        {
+        };
+
+        template <class CCT, class ECT>
+        struct is_variable_container<xvariable_container<CCT, ECT>> : std::true_type
+        {
+        };
+
+        template <class E>
+        struct is_reindex_view : std::false_type
+        {
+        };
+
+        template <class CT>
+        struct is_reindex_view<xreindex_view<CT>> : std::true_type
+        {
+        };
+
+        template <class CT, class T>
+        struct xgatherer_type<xreindex_view<CT>, T>
+        {
+            using type = std::conditional_t<is_variable_container<std::decay_t<CT>>::value,
+                                            xreindex_gatherer<xreindex_view<CT>, T>,
+                                            xselect_gatherer<xreindex_view<CT>, T>>;
+        };
+
+        /**
+         * Checks whether E should be assigned with a gatherer even when it has
+         * the same labels as the assigned variable, i.e. when the gatherer is
+         * faster than the steppers of its data.
+         */
+        template <class E>
+        struct xgather_assignable : std::false_type
+        {
+        };
+
+        template <class CT>
+        struct xgather_assignable<xreindex_view<CT>> : is_variable_container<std::decay_t<CT>>
+        {
+        };
+
+        /***********************************
+         * xselect_gatherer implementation *
+         ***********************************/
+
+        template <class E, class T>
+        inline xselect_gatherer<E, T>::xselect_gatherer(const E& e, const T& target)
+            : m_e(e), m_target(target),
+              m_selector(target.dimension_mapping().labels().size())
+        {
+        }
+
+        template <class E, class T>
+        template <class I>
+        inline void xselect_gatherer<E, T>::set_row(const I& index)
+        {
+            const auto& dim_label = m_target.dimension_mapping().labels();
+            const auto& coords = m_target.coordinates();
+            for (size_type i = 0; i < index.size(); ++i)
+            {
+                m_selector[i] = std::make_pair(dim_label[i], coords[dim_label[i]].label(index[i]));
+            }
+        }
+
+        template <class E, class T>
+        inline auto xselect_gatherer<E, T>::operator()(size_type i) -> value_type
+        {
+            if (!m_selector.empty())
+            {
+                const auto& dim_label = m_target.dimension_mapping().labels();
+                size_type last = m_selector.size() - 1;
+                m_selector[last] = std::make_pair(dim_label[last], m_target.coordinates()[dim_label[last]].label(i));
+            }
+            return m_e.select(m_selector);
+        }
+
+        /**************************************
+         * xcontainer_gatherer implementation *
+         **************************************/
+
+        template <class E, class T>
+        inline xcontainer_gatherer<E, T>::xcontainer_gatherer(const E& e, const T& target)
+            : m_e(e), m_reordered(), m_offsets(), m_inner_offsets(), m_row_offset(0), m_row_missing(false)
+        {
+            const auto& coords = target.coordinates();
+            init_offsets(target, reorder_data(target), [this, &coords](const auto& name, size_type, size_type stride, auto& offsets)
+            {
+                build_gather_offsets(coords[name], m_e.coordinates()[name], stride, offsets);
+            });
+        }
+
+        /**
+         * Builds a gatherer on the variable e viewed through the reindex view
+         * \c view.
+         */
+        template <class E, class T>
+        template <class V>
+        inline xcontainer_gatherer<E, T>::xcontainer_gatherer(const E& e, const T& target, const V& view)
+            : m_e(e), m_reordered(), m_offsets(), m_inner_offsets(), m_row_offset(0), m_row_missing(false)
+        {
+            const auto& coords = target.coordinates();
+            init_offsets(target, m_e.data().strides(), [&view, &coords](const auto& name, size_type dim, size_type stride, auto& offsets)
+            {
+                build_reindex_gather_offsets(coords[name], view.coordinates()[name],
+                                             view.gather_index(dim), stride, offsets);
+            });
+        }
+
+        /**
+         * Copies the data of the variable in the order of the dimensions of the
+         * target when its stride along the innermost dimension of the target
+         * makes the gathering slower than the copy, see is_reorder_cheaper.
+         * Returns the strides of the data to gather from, indexed by the
+         * dimensions of the variable.
+         */
+        template <class E, class T>
+        inline std::vector<std::size_t> xcontainer_gatherer<E, T>::reorder_data(const T& target)
+        {
+            const auto& data = m_e.data();
+            const auto& dim_label = target.dimension_mapping().labels();
+            const auto& dims = m_e.dimension_mapping();
+            std::vector<size_type> strides(data.strides().cbegin(), data.strides().cend());
+            if (dim_label.empty() || !dims.contains(dim_label.back()))
+            {
+                return strides;
+            }
+            size_type inner_stride = strides[static_cast<size_type>(dims[dim_label.back()])];
+            if (!is_reorder_cheaper(target.data().size(), data.size(), inner_stride,
+                                    sizeof(typename value_type::value_type)))
+            {
+                return strides;
+            }
+
+            std::vector<size_type> order;
+            std::vector<size_type> shape;
+            std::vector<size_type> source_strides;
+            for (const auto& name : dim_label)
+            {
+                auto iter = dims.find(name);
+                if (iter != dims.end())
+                {
+                    size_type dim = static_cast<size_type>(iter->second);
+                    order.push_back(dim);
+                    shape.push_back(static_cast<size_type>(data.shape()[dim]));
+                    source_strides.push_back(strides[dim]);
+                }
+            }
+
+            using value_buffer = xt::xarray<typename value_type::value_type>;
+            using flag_buffer = xt::xarray<bool>;
+            auto reordered = std::make_shared<reordered_type>(value_buffer::from_shape(shape), flag_buffer::from_shape(shape));
+            auto* values = reordered->value().data();
+            auto* flags = reordered->has_value().data();
+            const auto& storage = data.storage();
+            permuted_copy(shape, source_strides, [values, flags, &storage](size_type dst, size_type src)
+            {
+                auto v = storage[src];
+                values[dst] = v.value();
+                flags[dst] = v.has_value();
+            });
+
+            const auto& reordered_strides = reordered->value().strides();
+            for (size_type k = 0; k < order.size(); ++k)
+            {
+                strides[order[k]] = static_cast<size_type>(reordered_strides[k]);
+            }
+            m_reordered = std::move(reordered);
+            return strides;
+        }
+
+        template <class E, class T>
+        template <class S, class F>
+        inline void xcontainer_gatherer<E, T>::init_offsets(const T& target, const S& strides, F&& build_offsets)
+        {
+            const auto& dim_label = target.dimension_mapping().labels();
+            const auto& dims = m_e.dimension_mapping();
+            size_type dimension = dim_label.size();
+            m_offsets.resize(dimension != 0 ? dimension - 1 : 0);
+            for (size_type i = 0; i < dimension; ++i)
+            {
+                auto iter = dims.find(dim_label[i]);
+                if (iter != dims.end())
+                {
+                    auto& offsets = i + 1 == dimension ? m_inner_offsets : m_offsets[i];
+                    size_type dim = static_cast<size_type>(iter->second);
+                    build_offsets(dim_label[i], dim, static_cast<size_type>(strides[dim]), offsets);
+                }
+            }
+        }
+
+        template <class E, class T>
+        template <class I>
+        inline void xcontainer_gatherer<E, T>::set_row(const I& index)
+        {
+            m_row_offset = 0;
+            m_row_missing = false;
+            for (size_type i = 0; i < m_offsets.size(); ++i)
+            {
+                const auto& offsets = m_offsets[i];
+                if (!offsets.empty())
+                {
+                    size_type offset = offsets[index[i]];
+                    if (offset == gather_npos)
+                    {
+                        m_row_missing = true;
+                        return;
+                    }
+                    m_row_offset += offset;
+                }
+            }
+        }
+
+        template <class E, class T>
+        inline auto xcontainer_gatherer<E, T>::operator()(size_type i) const -> value_type
+        {
+            if (m_row_missing)
+            {
+                return m_e.missing();
+            }
+            if (m_inner_offsets.empty())
+            {
+                return element(m_row_offset);
+            }
+            size_type offset = m_inner_offsets[i];
+            return offset != gather_npos ? element(m_row_offset + offset) : value_type(m_e.missing());
+        }
+
+        template <class E, class T>
+        inline auto xcontainer_gatherer<E, T>::element(size_type offset) const -> value_type
+        {
+            return m_reordered ? value_type(m_reordered->storage()[offset]) : value_type(m_e.data().storage()[offset]);
+        }
+
+        /************************************
+         * xreindex_gatherer implementation *
+         ************************************/
+
+        template <class E, class T>
+        inline xreindex_gatherer<E, T>::xreindex_gatherer(const E& e, const T& target)
+            : base_type(e.expression(), target, e)
+        {
+        }
+
+        /***********************************
+         * xscalar_gatherer implementation *
+         ***********************************/
+
+        template <class E, class T>
+        inline xscalar_gatherer<E, T>::xscalar_gatherer(const E& e, const T&)
+            : m_value(e())
+        {
+        }
+
+        /*************************************
+         * xfunction_gatherer implementation *
+         *************************************/
+
+        template <class F, class R, class... CT, class T>
+        inline xfunction_gatherer<xvariable_function<F, R, CT...>, T>::xfunction_gatherer(const expression_type& e, const T& target)
+            : xfunction_gatherer(std::make_index_sequence<sizeof...(CT)>(), e, target)
+        {
+        }
+
+        template <class F, class R, class... CT, class T>
+        template <std::size_t... I>
+        inline xfunction_gatherer<xvariable_function<F, R, CT...>, T>::xfunction_gatherer(std::index_sequence<I...>,
+                                                                                         const expression_type& e,
+                                                                                         const T& target)
+            : m_gatherers(std::tuple_element_t<I, gatherer_tuple>(std::get<I>(e.arguments()), target)...),
+              m_f(e.functor())
+        {
+        }
+
+        template <class F, class R, class... CT, class T>
+        template <class I>
+        inline void xfunction_gatherer<xvariable_function<F, R, CT...>, T>::set_row(const I& index)
+        {
+            xt::for_each([&index](auto& g) { g.set_row(index); }, m_gatherers);
+        }
+
+        template <class F, class R, class... CT, class T>
+        inline auto xfunction_gatherer<xvariable_function<F, R, CT...>, T>::operator()(size_type i) -> value_type
+        {
+            return access_impl(std::make_index_sequence<sizeof...(CT)>(), i);
+        }
+
+        template <class F, class R, class... CT, class T>
+        template <std::size_t... I>
+        inline auto xfunction_gatherer<xvariable_function<F, R, CT...>, T>::access_impl(std::index_sequence<I...>,
+                                                                                        size_type i) -> value_type
+        {
+            return m_f(std::get<I>(m_gatherers)(i)...);
+        }
+
+        /**************************
+         * bitmap flag assignment *
+         **************************/
+
+        /**
+         * Checks whether the flags of an expression can be computed as the
+         * intersection of the validity bitmaps of its leaves.
+         */
+        template <class E>
+        struct xbitmap_operand : std::false_type
+        {
+        };
+
+        template <class CCT, class ECT>
+        struct xbitmap_operand<xvariable_container<CCT, ECT>>
+            : is_bitmap_optional_assembly<std::decay_t<ECT>>
+        {
+        };
+
+        template <class CT>
+        struct xbitmap_operand<xvariable_scalar<CT>> : std::true_type
+        {
+        };
+
+        template <class F, class R, class... CT>
+        struct xbitmap_operand<xvariable_function<F, R, CT...>>
+            : xtl::conjunction<xbitmap_operand<xdecay_variable_closure_t<CT>>...>
+        {
+        };
+
+        template <class E1, class E2>
+        struct xbitmap_assignable
+            : xtl::conjunction<xbitmap_operand<E1>, xbitmap_operand<E2>>
+        {
+        };
+
+        using bitmap_operand_list = std::vector<const xbitmap_storage*>;
+
+        template <class T>
+        inline bool bitmap_scalar_flag(const T&) noexcept
+        {
+            return true;
+        }
+
+        template <class T, class B>
+        inline bool bitmap_scalar_flag(const xtl::xoptional<T, B>& v) noexcept
+        {
+            return v.has_value();
+        }
+
+        template <class CCT, class ECT>
+        bool collect_bitmap_operands(const xvariable_container<CCT, ECT>& e, bitmap_operand_list& bitmaps);
+
+        template <class CT>
+        bool collect_bitmap_operands(const xvariable_scalar<CT>& e, bitmap_operand_list& bitmaps);
+
+        template <class F, class R, class... CT>
+        bool collect_bitmap_operands(const xvariable_function<F, R, CT...>& e, bitmap_operand_list& bitmaps);
+
+        /**
+         * Appends the validity bitmaps of the leaves of an expression to bitmaps.
+         * Returns false if a scalar operand is missing, i.e. if every element of
+         * the expression is missing.
+         */
+        template <class CCT, class ECT>
+        inline bool collect_bitmap_operands(const xvariable_container<CCT, ECT>& e, bitmap_operand_list& bitmaps)
+        {
+            bitmaps.push_back(&(e.data().has_value().storage()));
+            return true;
+        }
+
+        template <class CT>
+        inline bool collect_bitmap_operands(const xvariable_scalar<CT>& e, bitmap_operand_list&)
+        {
+            return bitmap_scalar_flag(e());
+        }
+
+        template <class F, class R, class... CT>
+        inline bool collect_bitmap_operands(const xvariable_function<F, R, CT...>& e, bitmap_operand_list& bitmaps)
+        {
+            bool res = true;
+            xt::for_each([&res, &bitmaps](const auto& arg) { res = collect_bitmap_operands(arg, bitmaps) && res; },
+                         e.arguments());
+            return res;
+        }
+
+        /**
+         * Computes the validity bitmap of res as the intersection of the bitmaps
+         * of the leaves of e, 64 elements at a time. Returns false without
+         * modifying res if a leaf does not have the size of res.
+         */
+        template <class E>
+        inline bool assign_bitmap(xbitmap_storage& res, const E& e)
+        {
+            bitmap_operand_list bitmaps;
+            bool has_value = collect_bitmap_operands(e, bitmaps);
+            bool same_size = std::all_of(bitmaps.cbegin(), bitmaps.cend(),
+                                         [&res](const xbitmap_storage* b) { return b->size() == res.size(); });
+            if (!same_size)
+            {
+                return false;
+            }
+
+            std::size_t word_count = res.word_count();
+            if (!has_value || bitmaps.empty())
+            {
+                res.fill(has_value);
+            }
+            else if (bitmaps.size() == 1)
+            {
+                if (bitmaps[0] != &res)
+                {
+                    std::copy(bitmaps[0]->words(), bitmaps[0]->words() + word_count, res.words());
+                }
+            }
+            else
+            {
+                bitmap_and(res.words(), bitmaps[0]->words(), bitmaps[1]->words(), word_count);
+                for (std::size_t i = 2; i < bitmaps.size(); ++i)
+                {
+                    bitmap_and(res.words(), res.words(), bitmaps[i]->words(), word_count);
+                }
+            }
+            return true;
+        }
+
+        /***********************
+         * parallel assignment *
+         ***********************/
+
+        /**
+         * Number of elements of the data of E that may share a word of memory
+         * and must be assigned by the same thread. 0 means that the data of E
+         * is assigned by a single thread.
+         */
+        template <class E>
+        struct xdata_alignment : std::integral_constant<std::size_t, 0>
+        {
+        };
+
+        template <class CCT, class ECT>
+        struct xdata_alignment<xvariable_container<CCT, ECT>>
+            : std::integral_constant<std::size_t, is_bitmap_optional_assembly<std::decay_t<ECT>>::value ?
+                                                  xbitmap_storage::word_bits : std::size_t(1)>
+        {
+        };
+
+        /**
+         * Calls assign(lhs_rows, rhs_rows) on blocks of rows of the leading
+         * dimension of lhs and rhs, which must have the same shape. Blocks
+         * are assigned concurrently if several threads are available.
+         */
+        template <class E1, class E2, class F>
+        inline void assign_by_rows(E1& lhs, const E2& rhs, std::size_t alignment, F&& assign)
+        {
+            const auto& shape = lhs.shape();
+            std::size_t nb_rows = shape.size() != 0 ? static_cast<std::size_t>(shape[0]) : std::size_t(1);
+            std::size_t size = std::accumulate(shape.cbegin(), shape.cend(), std::size_t(1), std::multiplies<std::size_t>());
+            std::size_t row_size = nb_rows != 0 ? size / nb_rows : std::size_t(0);
+            parallel_for_rows(nb_rows, row_size, alignment, [&](std::size_t begin, std::size_t end)
+            {
+                if (begin == 0 && end == nb_rows)
+                {
+                    assign(lhs, rhs);
+                }
+                else
+                {
+                    auto lhs_rows = xt::view(lhs, xt::range(begin, end));
+                    assign(lhs_rows, xt::view(rhs, xt::range(begin, end)));
+                }
+            });
+        }
+    }
+}
 
 namespace xt
 {
@@ -44,9 +911,18 @@ namespace xt
         template <class E1, class E2>
         static xf::xtrivial_broadcast resize(xexpression<E1>& e1, const xexpression<E2>& e2);
 
+        template <class E1, class G>
+        static void gather_rows(E1& lhs, const G& prototype, std::size_t begin, std::size_t end);
+
         template <class E1, class E2>
         static void assign_optional_tensor(xexpression<E1>& e1, const xexpression<E2>& e2, bool trivial);
 
+        template <class E1, class E2>
+        static void assign_optional_tensor_impl(E1& e1, const E2& e2, bool trivial, std::true_type);
+
+        template <class E1, class E2>
+        static void assign_optional_tensor_impl(E1& e1, const E2& e2, bool trivial, std::false_type);
+
         template <class E1, class E2>
         static void assign_resized_xexpression(xexpression<E1>& e1, const xexpression<E2>& e2,
                                                xf::xtrivial_broadcast trivial);
@@ -80,38 +956,93 @@ namespace xt
         }
     }
 
+    /**
+     * Assigns e2 to e1 when their labels are not the same, or when e2 is a
+     * reindex view. The labels of each axis of e1 are resolved once into
+     * offsets in the data of the leaves of e2, then the data is gathered row
+     * by row along the last dimension of e1. Labels of e1 that do not belong
+     * to a leaf of e2 (outer join, or labels missing from a reindexed axis)
+     * are filled with missing values. Blocks of the leading dimension of e1
+     * are gathered concurrently if several threads are available, see
+     * set_num_threads. Leaves of e2 whose dimensions are not in the order of
+     * e1 may be reordered once before the gathering, see xcontainer_gatherer.
+     */
     template <class E1, class E2>
     inline void xexpression_assigner<xvariable_expression_tag>::assign_data(xexpression<E1>& e1,
                                                                             const xexpression<E2>& e2,
                                                                             bool /*trivial*/)
     {
-        const auto& dim_label = e1.derived_cast().dimension_mapping().labels();
-        const auto& coords = e1.derived_cast().coordinates();
         using size_type = typename E1::size_type;
-        std::vector<size_type> index(dim_label.size(), size_type(0));
-        using selector_sequence_type = typename E1::template selector_sequence_type<>;
-        selector_sequence_type selector(index.size());
-        bool end = false;
+        using gatherer_type = xf::detail::xgatherer_t<E2, E1>;
+
+        XFRAME_TRACE_SCOPE(assign_data)
+        XFRAME_TRACE_SCOPE_IF(xf::detail::is_reindex_view<E2>::value, reindex)
+        E1& lhs = e1.derived_cast();
+        const E2& rhs = e2.derived_cast();
+        const auto& shape = lhs.shape();
+        if (std::find(shape.cbegin(), shape.cend(), size_type(0)) != shape.cend())
+        {
+            return;
+        }
+
+        gatherer_type prototype(rhs, lhs);
+        size_type nb_rows = shape.size() != 0 ? static_cast<size_type>(shape[0]) : size_type(1);
+        size_type size = std::accumulate(shape.cbegin(), shape.cend(), size_type(1), std::multiplies<size_type>());
+        xf::detail::parallel_for_rows(nb_rows, size / nb_rows, xf::detail::xdata_alignment<E1>::value,
+            [&lhs, &prototype](std::size_t begin, std::size_t end) { gather_rows(lhs, prototype, begin, end); });
+    }
+
+    /**
+     * Gathers the elements of e1 whose index in the leading dimension is in
+     * [begin, end). Each call uses its own copy of the gatherer.
+     */
+    template <class E1, class G>
+    inline void xexpression_assigner<xvariable_expression_tag>::gather_rows(E1& lhs, const G& prototype,
+                                                                            std::size_t begin, std::size_t end)
+    {
+        using size_type = typename E1::size_type;
+
+        G gatherer(prototype);
+        const auto& shape = lhs.shape();
+        auto& storage = lhs.data().storage();
+        const auto& strides = lhs.data().strides();
+        size_type dimension = shape.size();
+        size_type inner_begin = dimension == 1 ? begin : size_type(0);
+        size_type inner_size = dimension > 1 ? static_cast<size_type>(shape.back()) : size_type(end);
+        size_type inner_stride = dimension != 0 ? static_cast<size_type>(strides.back()) : size_type(0);
+
+        std::vector<size_type> outer_shape(shape.cbegin(), dimension != 0 ? shape.cend() - 1 : shape.cend());
+        std::vector<size_type> index(outer_shape.size(), size_type(0));
+        if (!index.empty())
+        {
+            index[0] = begin;
+            outer_shape[0] = end;
+        }
+        bool end_reached = false;
         do
         {
-            for(size_type i = 0; i < index.size(); ++i)
+            size_type offset = 0;
+            for (size_type i = 0; i < index.size(); ++i)
             {
-                selector[i] = std::make_pair(dim_label[i], coords[dim_label[i]].label(index[i]));
+                offset += index[i] * static_cast<size_type>(strides[i]);
             }
-            e1.derived_cast().select(selector) = e2.derived_cast().select(selector);
-            end = detail::increment_index(e1.derived_cast().shape(), index);
+            gatherer.set_row(index);
+            offset += inner_begin * inner_stride;
+            for (size_type i = inner_begin; i < inner_size; ++i, offset += inner_stride)
+            {
+                storage[offset] = gatherer(i);
+            }
+            end_reached = detail::increment_index(outer_shape, index);
         }
-        while(!end);
+        while(!end_reached);
     }
 
     template <class E1, class E2>
     inline void xexpression_assigner<xvariable_expression_tag>::assign_xexpression(xexpression<E1>& e1,
                                                                                    const xexpression<E2>& e2)
     {
-        XFRAME_TRACE("ASSIGN EXPRESSION - BEGIN");
         xf::xtrivial_broadcast trivial = resize(e1, e2);
         assign_resized_xexpression(e1, e2, trivial);
-        XFRAME_TRACE("ASSIGN EXPRESSION - END" << std::endl);
     }
 
     template <class E1, class E2>
@@ -167,6 +1098,7 @@ namespace xt
     {
         using coordinate_type = typename E1::coordinate_type;
         using dimension_type = typename E1::dimension_type;
+        XFRAME_TRACE_SCOPE(resize)
         coordinate_type c;
         dimension_type d;
         xf::xtrivial_broadcast res = e2.derived_cast().broadcast_coordinates(c);
@@ -181,9 +1113,44 @@ namespace xt
                                                                                        const xexpression<E2>& e2,
                                                                                        bool trivial)
     {
-        xexpression_assigner<xoptional_expression_tag>::assign_data(e1.derived_cast().data(),
-                                                                    e2.derived_cast().data(),
-                                                                    trivial);
+        assign_optional_tensor_impl(e1.derived_cast(), e2.derived_cast(), trivial,
+                                    xf::detail::xbitmap_assignable<E1, E2>());
+    }
+
+    /**
+     * Assigns data whose flags are validity bitmaps. When the operands have
+     * the same shape as e1, the values are assigned on their own and the flags
+     * are computed as the bitwise AND of the bitmaps of the operands.
+     */
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_optional_tensor_impl(E1& e1,
+                                                                                            const E2& e2,
+                                                                                            bool trivial,
+                                                                                            std::true_type)
+    {
+        auto& lhs = e1.data();
+        decltype(auto) rhs = e2.data();
+        if (trivial && xf::detail::assign_bitmap(lhs.has_value().storage(), e2))
+        {
+            auto rhs_values = xt::value(rhs);
+            xf::detail::assign_by_rows(lhs.value(), rhs_values, std::size_t(1),
+                [trivial](auto& l, const auto& r) { xt::assign_data(l, r, trivial); });
+        }
+        else
+        {
+            assign_optional_tensor_impl(e1, e2, trivial, std::false_type());
+        }
+    }
+
+    template <class E1, class E2>
+    inline void xexpression_assigner<xvariable_expression_tag>::assign_optional_tensor_impl(E1& e1,
+                                                                                            const E2& e2,
+                                                                                            bool trivial,
+                                                                                            std::false_type)
+    {
+        decltype(auto) rhs = e2.data();
+        xf::detail::assign_by_rows(e1.data(), rhs, xf::detail::xdata_alignment<E1>::value,
+            [trivial](auto& l, const auto& r) { xexpression_assigner<xoptional_expression_tag>::assign_data(l, r, trivial); });
     }
 
     template <class E1, class E2>
@@ -191,7 +1158,8 @@ namespace xt
                                                                                            const xexpression<E2>& e2,
                                                                                            xf::xtrivial_broadcast trivial)
     {
-        if (trivial.m_same_labels)
+        XFRAME_TRACE_BROADCAST(trivial.m_same_labels)
+        if (trivial.m_same_labels && !xf::detail::xgather_assignable<E2>::value)
         {
             assign_optional_tensor(e1, e2, trivial.m_same_dimensions);
         }
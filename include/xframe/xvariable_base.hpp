@@ -12,7 +12,9 @@
 #define XFRAME_XVARIABLE_BASE_HPP
 
 #include "xtensor/xnoalias.hpp"
+#include "xtensor/xoptional_assembly.hpp"
 
+#include "xbitmap.hpp"
 #include "xcoordinate_system.hpp"
 #include "xselecting.hpp"
 #include "xnamed_axis.hpp"
@@ -98,6 +100,14 @@ namespace xf
         using locator_type = typename selector_traits<N>::locator_type;
         template <std::size_t N = dynamic()>
         using locator_sequence_type = typename selector_traits<N>::locator_sequence_type;
+        template <std::size_t N = dynamic()>
+        using prepared_selector_type = typename selector_traits<N>::prepared_selector_type;
+        template <std::size_t N = dynamic()>
+        using name_sequence_type = typename selector_traits<N>::name_sequence_type;
+        template <std::size_t N = dynamic()>
+        using label_sequence_type = typename selector_traits<N>::label_sequence_type;
+        template <std::size_t N = dynamic()>
+        using label_batch_type = typename selector_traits<N>::label_batch_type;
 
         static const_reference missing();
 
@@ -173,6 +183,24 @@ namespace xf
         template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N = dynamic()>
         const_reference select(selector_sequence_type<N>&& selector) const;
 
+        template <std::size_t N = dynamic()>
+        prepared_selector_type<N> prepare_selector(const name_sequence_type<N>& names) const;
+
+        template <std::size_t N>
+        reference select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                         const label_sequence_type<N>& labels);
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N>
+        const_reference select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                               const label_sequence_type<N>& labels) const;
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N = dynamic()>
+        xt::xarray<value_type> select_batch(const name_sequence_type<N>& names, const label_batch_type<N>& labels) const;
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N>
+        xt::xarray<value_type> select_batch(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                            const label_batch_type<N>& labels) const;
+
         template <std::size_t N = dynamic()>
         reference iselect(const iselector_sequence_type<N>& selector);
 
@@ -444,6 +472,58 @@ namespace xf
         return select_join<Join>(selector_type<N>(std::move(selector)));
     }
 
+    /**
+     * Returns a selector prepared for the specified dimension names. The
+     * positions of the dimensions and the axes they are mapped to are
+     * resolved once, so that selecting with the returned selector only
+     * requires the labels.
+     * @param names the dimension names to select.
+     */
+    template <class D>
+    template <std::size_t N>
+    inline auto xvariable_base<D>::prepare_selector(const name_sequence_type<N>& names) const -> prepared_selector_type<N>
+    {
+        return prepared_selector_type<N>(coordinates(), dimension_mapping(), names);
+    }
+
+    template <class D>
+    template <std::size_t N>
+    inline auto xvariable_base<D>::select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                          const label_sequence_type<N>& labels) -> reference
+    {
+        return select_impl(detail::bind_labels(selector, labels));
+    }
+
+    template <class D>
+    template <class Join, std::size_t N>
+    inline auto xvariable_base<D>::select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                          const label_sequence_type<N>& labels) const -> const_reference
+    {
+        return select_join<Join>(detail::bind_labels(selector, labels));
+    }
+
+    template <class D>
+    template <class Join, std::size_t N>
+    inline auto xvariable_base<D>::select_batch(const name_sequence_type<N>& names, const label_batch_type<N>& labels) const
+        -> xt::xarray<value_type>
+    {
+        return select_batch<Join>(prepare_selector<N>(names), labels);
+    }
+
+    template <class D>
+    template <class Join, std::size_t N>
+    inline auto xvariable_base<D>::select_batch(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                                const label_batch_type<N>& labels) const -> xt::xarray<value_type>
+    {
+        return selector.template gather<value_type>(labels, [this](const auto& idx)
+        {
+            return data().element(idx.cbegin(), idx.cend());
+        }, /*missing*/ [this, &selector](const auto& point)
+        {
+            return this->template select_join<Join>(detail::bind_labels(selector, point));
+        });
+    }
+
     template <class D>
     template <std::size_t N>
     inline auto xvariable_base<D>::iselect(const iselector_sequence_type<N>& selector) -> reference
@@ -492,12 +572,53 @@ namespace xf
         return shape;
     }
 
+    namespace detail
+    {
+        /**
+         * Number of bytes of the buffers holding the data of a variable, as
+         * reported to the trace. The values and the flags of an optional
+         * assembly are counted separately, since the elements of the assembly
+         * are proxies that are not stored.
+         */
+        template <class D>
+        struct xdata_allocation
+        {
+            static std::size_t bytes(const D& d) noexcept
+            {
+                return d.size() * sizeof(typename D::value_type);
+            }
+        };
+
+        template <class VE, class FE>
+        struct xdata_allocation<xt::xoptional_assembly<VE, FE>>
+        {
+            static std::size_t bytes(const xt::xoptional_assembly<VE, FE>& d) noexcept
+            {
+                return xdata_allocation<VE>::bytes(d.value()) + xdata_allocation<FE>::bytes(d.has_value());
+            }
+        };
+
+        template <>
+        struct xdata_allocation<xbitmap_array>
+        {
+            static std::size_t bytes(const xbitmap_array& d) noexcept
+            {
+                return d.storage().word_count() * sizeof(xbitmap_storage::word_type);
+            }
+        };
+    }
+
     template <class D>
     template <class C, class DM>
     inline void xvariable_base<D>::resize_impl(C&& coords, DM&& dims)
     {
         coordinate_base::resize(std::forward<C>(coords), std::forward<DM>(dims));
+        size_type old_size = data().size();
         data().resize(compute_shape());
+        if (data().size() != old_size)
+        {
+            XFRAME_TRACE_ALLOCATION(detail::xdata_allocation<std::decay_t<data_type>>::bytes(data()))
+        }
     }
 
     template <class D>
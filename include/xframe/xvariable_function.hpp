@@ -11,8 +11,14 @@
 #ifndef XFRAME_XVARIABLE_FUNCTION_HPP
 #define XFRAME_XVARIABLE_FUNCTION_HPP
 
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
 #include "xtensor/xoptional.hpp"
 
+#include "xbroadcast_cache.hpp"
 #include "xcoordinate.hpp"
 #include "xselecting.hpp"
 #include "xvariable_meta.hpp"
@@ -36,6 +42,48 @@ namespace xf
 
         template <class CT>
         using xvariable_data_closure_t = typename xvariable_data_closure<CT>::type;
+
+        /**
+         * Broadcast coordinates of a function, computed once per join type.
+         * Computed results are published with an atomic flag, so that readers
+         * do not lock once the coordinates are available; the computation
+         * itself is serialized by a mutex.
+         */
+        template <class C, class D>
+        class xfunction_coordinate_cache
+        {
+        public:
+
+            using coordinate_type = C;
+            using dimension_type = D;
+
+            struct entry
+            {
+                coordinate_type m_coordinate;
+                dimension_type m_dimension_mapping;
+                xtrivial_broadcast m_trivial_broadcast;
+            };
+
+            xfunction_coordinate_cache() = default;
+            xfunction_coordinate_cache(const xfunction_coordinate_cache& rhs);
+            xfunction_coordinate_cache(xfunction_coordinate_cache&& rhs);
+            xfunction_coordinate_cache& operator=(const xfunction_coordinate_cache& rhs);
+            xfunction_coordinate_cache& operator=(xfunction_coordinate_cache&& rhs);
+
+            template <class Join, class F>
+            const entry& get(F&& compute) const;
+
+        private:
+
+            static constexpr std::size_t nb_joins = 2;
+
+            template <class T>
+            void assign(T&& rhs);
+
+            mutable std::array<entry, nb_joins> m_entries;
+            mutable std::array<std::atomic<bool>, nb_joins> m_ready = {{ {false}, {false} }};
+            mutable std::mutex m_mutex;
+        };
     }
 
     template <class CCT, class ECT>
@@ -107,11 +155,17 @@ namespace xf
         const_reference select(selector_sequence_type<N>&& selector) const;
 
         const std::tuple<xvariable_closure_t<CT>...>& arguments() const { return m_e; }
+        const functor_type& functor() const { return m_f; }
 
     private:
 
+        using coordinate_cache = detail::xfunction_coordinate_cache<coordinate_type, dimension_type>;
+
+        template <class Join>
+        const typename coordinate_cache::entry& compute_coordinates() const;
+
         template <class Join>
-        void compute_coordinates() const;
+        xtrivial_broadcast broadcast_operands(coordinate_type& coords) const;
 
         template <std::size_t... I, class... Args>
         const_reference access_impl(std::index_sequence<I...>, Args... args) const;
@@ -127,16 +181,90 @@ namespace xf
 
         std::tuple<xvariable_closure_t<CT>...> m_e;
         functor_type m_f;
-        mutable coordinate_type m_coordinate;
-        mutable dimension_type m_dimension_mapping;
-        mutable join::join_id m_join_id;
-        mutable bool m_coordinate_computed;
-        mutable xtrivial_broadcast m_trivial_broadcast;
+        coordinate_cache m_coordinate_cache;
     };
 
     template <class F, class R, class... CT>
     std::ostream& operator<<(std::ostream& out, const xvariable_function<F, R, CT...>& f);
 
+    /*********************************************
+     * xfunction_coordinate_cache implementation *
+     *********************************************/
+
+    namespace detail
+    {
+        template <class C, class D>
+        inline xfunction_coordinate_cache<C, D>::xfunction_coordinate_cache(const xfunction_coordinate_cache& rhs)
+        {
+            assign(rhs);
+        }
+
+        template <class C, class D>
+        inline xfunction_coordinate_cache<C, D>::xfunction_coordinate_cache(xfunction_coordinate_cache&& rhs)
+        {
+            assign(std::move(rhs));
+        }
+
+        template <class C, class D>
+        inline auto xfunction_coordinate_cache<C, D>::operator=(const xfunction_coordinate_cache& rhs) -> xfunction_coordinate_cache&
+        {
+            if (this != &rhs)
+            {
+                assign(rhs);
+            }
+            return *this;
+        }
+
+        template <class C, class D>
+        inline auto xfunction_coordinate_cache<C, D>::operator=(xfunction_coordinate_cache&& rhs) -> xfunction_coordinate_cache&
+        {
+            if (this != &rhs)
+            {
+                assign(std::move(rhs));
+            }
+            return *this;
+        }
+
+        /**
+         * Returns the entry of the join type Join, calling
+         * compute(coordinate, dimension_mapping) the first time.
+         */
+        template <class C, class D>
+        template <class Join, class F>
+        inline auto xfunction_coordinate_cache<C, D>::get(F&& compute) const -> const entry&
+        {
+            std::size_t i = static_cast<std::size_t>(Join::id());
+            if (!m_ready[i].load(std::memory_order_acquire))
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_ready[i].load(std::memory_order_relaxed))
+                {
+                    entry& e = m_entries[i];
+                    e.m_coordinate.clear();
+                    e.m_trivial_broadcast = compute(e.m_coordinate, e.m_dimension_mapping);
+                    m_ready[i].store(true, std::memory_order_release);
+                }
+            }
+            return m_entries[i];
+        }
+
+        template <class C, class D>
+        template <class T>
+        inline void xfunction_coordinate_cache<C, D>::assign(T&& rhs)
+        {
+            std::lock_guard<std::mutex> lock(rhs.m_mutex);
+            for (std::size_t i = 0; i < nb_joins; ++i)
+            {
+                bool ready = rhs.m_ready[i].load(std::memory_order_acquire);
+                if (ready)
+                {
+                    m_entries[i] = std::forward<T>(rhs).m_entries[i];
+                }
+                m_ready[i].store(ready, std::memory_order_release);
+            }
+        }
+    }
+
     /*************************************
      * xvariable_function implementation *
      *************************************/
@@ -146,10 +274,7 @@ namespace xf
     inline xvariable_function<F, R, CT...>::xvariable_function(Func&& f, CT... e) noexcept
         : m_e(e...),
           m_f(std::forward<Func>(f)),
-          m_coordinate(),
-          m_dimension_mapping(),
-          m_join_id(join::inner::id()),
-          m_coordinate_computed(false)
+          m_coordinate_cache()
     {
     }
 
@@ -181,26 +306,66 @@ namespace xf
     template <class Join>
     inline auto xvariable_function<F, R, CT...>::coordinates() const -> const coordinate_type&
     {
-        compute_coordinates<Join>();
-        return m_coordinate;
+        return compute_coordinates<Join>().m_coordinate;
     }
 
     template <class F, class R, class... CT>
     template <class Join>
     inline auto xvariable_function<F, R, CT...>::dimension_mapping() const -> const dimension_type&
     {
-        compute_coordinates<Join>();
-        return m_dimension_mapping;
+        return compute_coordinates<Join>().m_dimension_mapping;
+    }
+
+    namespace detail
+    {
+        template <class K, class E>
+        inline bool append_broadcast_key(xbroadcast_key<K>& key, const E& e)
+        {
+            return key.append(e.coordinates());
+        }
+
+        template <class K, class F, class R, class... CT>
+        inline bool append_broadcast_key(xbroadcast_key<K>& key, const xvariable_function<F, R, CT...>& f)
+        {
+            bool res = true;
+            auto func = [&key, &res](const auto& arg) {
+                res = res && append_broadcast_key(key, arg);
+            };
+            xt::for_each(func, f.arguments());
+            return res;
+        }
+
+        template <class Join, class E, class C, class Func>
+        inline xtrivial_broadcast cached_broadcast(const E& /*e*/, C& coords, Func&& compute)
+        {
+            return compute(coords);
+        }
+
+        // Broadcasting to empty coordinates only depends on the axes of
+        // the operands, the result can be taken from the broadcast cache
+        template <class Join, class E, class K, class L, class S, class MT, class Func>
+        inline xtrivial_broadcast cached_broadcast(const E& e, xcoordinate<K, L, S, MT>& coords, Func&& compute)
+        {
+            if (coords.empty() && get_broadcast_cache_capacity() != 0)
+            {
+                xbroadcast_key<K> key(Join::id());
+                if (append_broadcast_key(key, e))
+                {
+                    using cache_type = xbroadcast_cache<xcoordinate<K, L, S, MT>>;
+                    return cache_type::instance().broadcast(key, coords, std::forward<Func>(compute));
+                }
+            }
+            return compute(coords);
+        }
     }
 
     template <class F, class R, class... CT>
     template <class Join>
     inline xtrivial_broadcast xvariable_function<F, R, CT...>::broadcast_coordinates(coordinate_type& coords) const
     {
-        auto func = [&coords](xtrivial_broadcast trivial, const auto& arg) {
-            return arg.template broadcast_coordinates<Join>(coords) && trivial;
-        };
-        return xt::accumulate(func, xtrivial_broadcast(true, true), m_e);
+        return detail::cached_broadcast<Join>(*this, coords, [this](coordinate_type& c) {
+            return broadcast_operands<Join>(c);
+        });
     }
 
     namespace detail
@@ -283,18 +448,30 @@ namespace xf
         return select_impl<Join>(std::make_index_sequence<sizeof...(CT)>(), std::move(selector));
     }
 
+    /**
+     * Computes the coordinates and the dimension mapping of the function for
+     * the join type Join, once. Results of inner and outer joins are kept side
+     * by side; this method can be called concurrently.
+     */
     template <class F, class R, class... CT>
     template <class Join>
-    inline void xvariable_function<F, R, CT...>::compute_coordinates() const
+    inline auto xvariable_function<F, R, CT...>::compute_coordinates() const -> const typename coordinate_cache::entry&
     {
-        if(!m_coordinate_computed || m_join_id != Join::id())
-        {
-            m_coordinate.clear();
-            m_trivial_broadcast = broadcast_coordinates<Join>(m_coordinate);
-            broadcast_dimensions(m_dimension_mapping, m_trivial_broadcast.m_same_dimensions);
-            m_coordinate_computed = true;
-            m_join_id = Join::id();
-        }
+        return m_coordinate_cache.template get<Join>([this](coordinate_type& coords, dimension_type& dims) {
+            xtrivial_broadcast trivial = broadcast_coordinates<Join>(coords);
+            broadcast_dimensions(dims, trivial.m_same_dimensions);
+            return trivial;
+        });
+    }
+
+    template <class F, class R, class... CT>
+    template <class Join>
+    inline xtrivial_broadcast xvariable_function<F, R, CT...>::broadcast_operands(coordinate_type& coords) const
+    {
+        auto func = [&coords](xtrivial_broadcast trivial, const auto& arg) {
+            return arg.template broadcast_coordinates<Join>(coords) && trivial;
+        };
+        return xt::accumulate(func, xtrivial_broadcast(true, true), m_e);
     }
 
     template <class F, class R, class... CT>
@@ -11,6 +11,8 @@
 #ifndef XFRAME_XWHERE_VIEW_HPP
 #define XFRAME_XWHERE_VIEW_HPP
 
+#include <algorithm>
+
 #include "xtensor/xgenerator.hpp"
 #include "xtensor/xmasked_view.hpp"
 
@@ -236,11 +238,21 @@ namespace xf
         return *this;
     }
 
+    /**
+     * Assigns tmp to the visible elements of the view. When tmp has the
+     * dimensions and the labels of the view, its data is copied at once
+     * through the masked data; otherwise, each element is assigned by label.
+     */
     template <class CTV, class CTAX>
     inline void xvariable_masked_view<CTV, CTAX>::assign_temporary_impl(temporary_type&& tmp)
     {
-        // TODO: improve this with iterators when they are available
         const temporary_type& tmp2 = tmp;
+        if (tmp2.dimension_labels() == dimension_labels() && tmp2.coordinates() == coordinates())
+        {
+            std::copy(tmp2.data().cbegin(), tmp2.data().cend(), data().begin());
+            return;
+        }
+
         const auto& dim_label = dimension_labels();
         const auto& coords = coordinates();
         std::vector<size_type> index(dim_label.size(), size_type(0));
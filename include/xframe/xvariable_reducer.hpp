@@ -0,0 +1,1077 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#ifndef XFRAME_XVARIABLE_REDUCER_HPP
+#define XFRAME_XVARIABLE_REDUCER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "xtensor/xarray.hpp"
+#include "xtensor/xoptional_assembly.hpp"
+
+#include "xbitmap.hpp"
+#include "xvariable.hpp"
+
+namespace xf
+{
+    /**********************
+     * reducing functions *
+     **********************/
+
+    template <class E>
+    using xreducer_dimension_list = std::vector<typename std::decay_t<E>::coordinate_type::key_type>;
+
+    template <class E>
+    auto sum(const E& e, const xreducer_dimension_list<E>& dims, bool skipna = true);
+
+    template <class E>
+    auto mean(const E& e, const xreducer_dimension_list<E>& dims, bool skipna = true);
+
+    template <class E>
+    auto amin(const E& e, const xreducer_dimension_list<E>& dims, bool skipna = true);
+
+    template <class E>
+    auto amax(const E& e, const xreducer_dimension_list<E>& dims, bool skipna = true);
+
+    template <class E>
+    auto variance(const E& e, const xreducer_dimension_list<E>& dims, bool skipna = true);
+
+    template <class E>
+    auto stddev(const E& e, const xreducer_dimension_list<E>& dims, bool skipna = true);
+
+    template <class E>
+    auto count(const E& e, const xreducer_dimension_list<E>& dims);
+
+    /*******************
+     * reducer kernels *
+     *******************/
+
+    namespace detail
+    {
+        /**
+         * Base class of the reducer kernels, counting the non-missing values
+         * reduced into each element of the result.
+         *
+         * A kernel provides two operations on contiguous buffers of values and
+         * flags: reduce, that reduces a whole buffer into a single element of the
+         * result, and accumulate, that reduces the i-th value of the buffer into
+         * the i-th element of a contiguous range of the result. Both are written
+         * as branchless loops over byte flags so that they can be vectorized.
+         * Kernels of the same size can be merged, which allows to reduce disjoint
+         * parts of a buffer independently; merge must be called in the order of
+         * the parts for kernels that depend on it.
+         */
+        class xreducer_counter
+        {
+        public:
+
+            explicit xreducer_counter(std::size_t size);
+
+            std::size_t count(std::size_t o) const noexcept;
+
+        protected:
+
+            std::size_t reduce_count(std::size_t o, const std::uint8_t* f, std::size_t n);
+            void accumulate_count(std::size_t o, const std::uint8_t* f, std::size_t n);
+            void merge_count(const xreducer_counter& rhs);
+
+            std::vector<std::size_t> m_count;
+        };
+
+        template <class T>
+        class xsum_kernel : public xreducer_counter
+        {
+        public:
+
+            using self_type = xsum_kernel<T>;
+            using result_type = T;
+
+            explicit xsum_kernel(std::size_t size);
+
+            void reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void merge(const self_type& rhs);
+
+            bool has_result(std::size_t o) const noexcept;
+            result_type result(std::size_t o) const noexcept;
+
+        private:
+
+            std::vector<T> m_sum;
+        };
+
+        template <class T>
+        class xmean_kernel : public xreducer_counter
+        {
+        public:
+
+            using self_type = xmean_kernel<T>;
+            using result_type = std::common_type_t<T, double>;
+
+            explicit xmean_kernel(std::size_t size);
+
+            void reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void merge(const self_type& rhs);
+
+            bool has_result(std::size_t o) const noexcept;
+            result_type result(std::size_t o) const noexcept;
+
+        private:
+
+            std::vector<result_type> m_sum;
+        };
+
+        template <class T, class C>
+        class xextremum_kernel : public xreducer_counter
+        {
+        public:
+
+            using self_type = xextremum_kernel<T, C>;
+            using result_type = T;
+
+            explicit xextremum_kernel(std::size_t size);
+
+            void reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void merge(const self_type& rhs);
+
+            bool has_result(std::size_t o) const noexcept;
+            result_type result(std::size_t o) const noexcept;
+
+        private:
+
+            static T init_value() noexcept;
+
+            std::vector<T> m_value;
+        };
+
+        struct xless_than
+        {
+            template <class T>
+            static constexpr T worst() noexcept
+            {
+                return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                            : std::numeric_limits<T>::max();
+            }
+
+            template <class T>
+            static constexpr bool better(const T& lhs, const T& rhs) noexcept
+            {
+                return lhs < rhs;
+            }
+        };
+
+        struct xgreater_than
+        {
+            template <class T>
+            static constexpr T worst() noexcept
+            {
+                return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                            : std::numeric_limits<T>::lowest();
+            }
+
+            template <class T>
+            static constexpr bool better(const T& lhs, const T& rhs) noexcept
+            {
+                return rhs < lhs;
+            }
+        };
+
+        /**
+         * Variance kernel. Contiguous buffers are reduced with a two-pass
+         * algorithm and merged into the result with the pairwise update of
+         * Chan et al.; accumulation uses the online update of Welford.
+         */
+        template <class T, bool SQRT>
+        class xvariance_kernel : public xreducer_counter
+        {
+        public:
+
+            using self_type = xvariance_kernel<T, SQRT>;
+            using result_type = std::common_type_t<T, double>;
+
+            explicit xvariance_kernel(std::size_t size);
+
+            void reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void merge(const self_type& rhs);
+
+            bool has_result(std::size_t o) const noexcept;
+            result_type result(std::size_t o) const noexcept;
+
+        private:
+
+            std::vector<result_type> m_mean;
+            std::vector<result_type> m_m2;
+        };
+
+        template <class T>
+        class xcount_kernel : public xreducer_counter
+        {
+        public:
+
+            using self_type = xcount_kernel<T>;
+            using result_type = std::size_t;
+
+            explicit xcount_kernel(std::size_t size);
+
+            void reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void merge(const self_type& rhs);
+
+            bool has_result(std::size_t o) const noexcept;
+            result_type result(std::size_t o) const noexcept;
+        };
+
+        /**
+         * Selection kernel, keeping the first or the last non-missing value
+         * in the order of the reduced buffers.
+         */
+        template <class T, bool LAST>
+        class xpick_kernel : public xreducer_counter
+        {
+        public:
+
+            using self_type = xpick_kernel<T, LAST>;
+            using result_type = T;
+
+            explicit xpick_kernel(std::size_t size);
+
+            void reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n);
+            void merge(const self_type& rhs);
+
+            bool has_result(std::size_t o) const noexcept;
+            result_type result(std::size_t o) const noexcept;
+
+        private:
+
+            std::vector<T> m_value;
+        };
+    }
+
+    /***********************************
+     * xreducer_counter implementation *
+     ***********************************/
+
+    namespace detail
+    {
+        inline xreducer_counter::xreducer_counter(std::size_t size)
+            : m_count(size, std::size_t(0))
+        {
+        }
+
+        inline std::size_t xreducer_counter::count(std::size_t o) const noexcept
+        {
+            return m_count[o];
+        }
+
+        inline std::size_t xreducer_counter::reduce_count(std::size_t o, const std::uint8_t* f, std::size_t n)
+        {
+            std::size_t cnt = 0;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                cnt += static_cast<std::size_t>(f[i]);
+            }
+            m_count[o] += cnt;
+            return cnt;
+        }
+
+        inline void xreducer_counter::accumulate_count(std::size_t o, const std::uint8_t* f, std::size_t n)
+        {
+            std::size_t* c = m_count.data() + o;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                c[i] += static_cast<std::size_t>(f[i]);
+            }
+        }
+
+        inline void xreducer_counter::merge_count(const xreducer_counter& rhs)
+        {
+            for (std::size_t i = 0; i < m_count.size(); ++i)
+            {
+                m_count[i] += rhs.m_count[i];
+            }
+        }
+
+        /******************************
+         * xsum_kernel implementation *
+         ******************************/
+
+        template <class T>
+        inline xsum_kernel<T>::xsum_kernel(std::size_t size)
+            : xreducer_counter(size), m_sum(size, T(0))
+        {
+        }
+
+        template <class T>
+        inline void xsum_kernel<T>::reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            T acc = T(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const T x = v[i];
+                acc += f[i] ? x : T(0);
+            }
+            m_sum[o] += acc;
+            reduce_count(o, f, n);
+        }
+
+        template <class T>
+        inline void xsum_kernel<T>::accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            T* s = m_sum.data() + o;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const T x = v[i];
+                s[i] += f[i] ? x : T(0);
+            }
+            accumulate_count(o, f, n);
+        }
+
+        template <class T>
+        inline void xsum_kernel<T>::merge(const self_type& rhs)
+        {
+            for (std::size_t i = 0; i < m_sum.size(); ++i)
+            {
+                m_sum[i] += rhs.m_sum[i];
+            }
+            merge_count(rhs);
+        }
+
+        template <class T>
+        inline bool xsum_kernel<T>::has_result(std::size_t) const noexcept
+        {
+            // The sum of an empty set of values is 0.
+            return true;
+        }
+
+        template <class T>
+        inline auto xsum_kernel<T>::result(std::size_t o) const noexcept -> result_type
+        {
+            return m_sum[o];
+        }
+
+        /*******************************
+         * xmean_kernel implementation *
+         *******************************/
+
+        template <class T>
+        inline xmean_kernel<T>::xmean_kernel(std::size_t size)
+            : xreducer_counter(size), m_sum(size, result_type(0))
+        {
+        }
+
+        template <class T>
+        inline void xmean_kernel<T>::reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            result_type acc = result_type(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const result_type x = static_cast<result_type>(v[i]);
+                acc += f[i] ? x : result_type(0);
+            }
+            m_sum[o] += acc;
+            reduce_count(o, f, n);
+        }
+
+        template <class T>
+        inline void xmean_kernel<T>::accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            result_type* s = m_sum.data() + o;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const result_type x = static_cast<result_type>(v[i]);
+                s[i] += f[i] ? x : result_type(0);
+            }
+            accumulate_count(o, f, n);
+        }
+
+        template <class T>
+        inline void xmean_kernel<T>::merge(const self_type& rhs)
+        {
+            for (std::size_t i = 0; i < m_sum.size(); ++i)
+            {
+                m_sum[i] += rhs.m_sum[i];
+            }
+            merge_count(rhs);
+        }
+
+        template <class T>
+        inline bool xmean_kernel<T>::has_result(std::size_t o) const noexcept
+        {
+            return m_count[o] != 0;
+        }
+
+        template <class T>
+        inline auto xmean_kernel<T>::result(std::size_t o) const noexcept -> result_type
+        {
+            return m_count[o] != 0 ? m_sum[o] / static_cast<result_type>(m_count[o]) : result_type(0);
+        }
+
+        /***********************************
+         * xextremum_kernel implementation *
+         ***********************************/
+
+        template <class T, class C>
+        inline xextremum_kernel<T, C>::xextremum_kernel(std::size_t size)
+            : xreducer_counter(size), m_value(size, init_value())
+        {
+        }
+
+        template <class T, class C>
+        inline void xextremum_kernel<T, C>::reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            T acc = m_value[o];
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const T x = v[i];
+                acc = (f[i] & C::better(x, acc)) ? x : acc;
+            }
+            m_value[o] = acc;
+            reduce_count(o, f, n);
+        }
+
+        template <class T, class C>
+        inline void xextremum_kernel<T, C>::accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            T* r = m_value.data() + o;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const T x = v[i];
+                const T y = r[i];
+                r[i] = (f[i] & C::better(x, y)) ? x : y;
+            }
+            accumulate_count(o, f, n);
+        }
+
+        template <class T, class C>
+        inline void xextremum_kernel<T, C>::merge(const self_type& rhs)
+        {
+            for (std::size_t i = 0; i < m_value.size(); ++i)
+            {
+                const T x = rhs.m_value[i];
+                const T y = m_value[i];
+                m_value[i] = (rhs.m_count[i] != 0 && C::better(x, y)) ? x : y;
+            }
+            merge_count(rhs);
+        }
+
+        template <class T, class C>
+        inline bool xextremum_kernel<T, C>::has_result(std::size_t o) const noexcept
+        {
+            return m_count[o] != 0;
+        }
+
+        template <class T, class C>
+        inline auto xextremum_kernel<T, C>::result(std::size_t o) const noexcept -> result_type
+        {
+            return m_value[o];
+        }
+
+        template <class T, class C>
+        inline T xextremum_kernel<T, C>::init_value() noexcept
+        {
+            return C::template worst<T>();
+        }
+
+        /***********************************
+         * xvariance_kernel implementation *
+         ***********************************/
+
+        template <class T, bool SQRT>
+        inline xvariance_kernel<T, SQRT>::xvariance_kernel(std::size_t size)
+            : xreducer_counter(size), m_mean(size, result_type(0)), m_m2(size, result_type(0))
+        {
+        }
+
+        template <class T, bool SQRT>
+        inline void xvariance_kernel<T, SQRT>::reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            std::size_t count_a = m_count[o];
+            std::size_t count_b = reduce_count(o, f, n);
+            if (count_b == 0)
+            {
+                return;
+            }
+
+            result_type sum = result_type(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const result_type x = static_cast<result_type>(v[i]);
+                sum += f[i] ? x : result_type(0);
+            }
+            result_type mean_b = sum / static_cast<result_type>(count_b);
+            result_type m2_b = result_type(0);
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                result_type delta = static_cast<result_type>(v[i]) - mean_b;
+                m2_b += f[i] ? delta * delta : result_type(0);
+            }
+
+            result_type na = static_cast<result_type>(count_a);
+            result_type nb = static_cast<result_type>(count_b);
+            result_type nab = na + nb;
+            result_type delta = mean_b - m_mean[o];
+            m_mean[o] += delta * nb / nab;
+            m_m2[o] += m2_b + delta * delta * na * nb / nab;
+        }
+
+        template <class T, bool SQRT>
+        inline void xvariance_kernel<T, SQRT>::accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            accumulate_count(o, f, n);
+            const std::size_t* c = m_count.data() + o;
+            result_type* mean = m_mean.data() + o;
+            result_type* m2 = m_m2.data() + o;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                result_type x = static_cast<result_type>(v[i]);
+                result_type delta = x - mean[i];
+                result_type new_mean = mean[i] + delta / static_cast<result_type>(c[i] != 0 ? c[i] : 1);
+                mean[i] = f[i] ? new_mean : mean[i];
+                m2[i] += f[i] ? delta * (x - new_mean) : result_type(0);
+            }
+        }
+
+        template <class T, bool SQRT>
+        inline void xvariance_kernel<T, SQRT>::merge(const self_type& rhs)
+        {
+            for (std::size_t i = 0; i < m_mean.size(); ++i)
+            {
+                if (rhs.m_count[i] != 0)
+                {
+                    result_type na = static_cast<result_type>(m_count[i]);
+                    result_type nb = static_cast<result_type>(rhs.m_count[i]);
+                    result_type nab = na + nb;
+                    result_type delta = rhs.m_mean[i] - m_mean[i];
+                    m_mean[i] += delta * nb / nab;
+                    m_m2[i] += rhs.m_m2[i] + delta * delta * na * nb / nab;
+                }
+            }
+            merge_count(rhs);
+        }
+
+        template <class T, bool SQRT>
+        inline bool xvariance_kernel<T, SQRT>::has_result(std::size_t o) const noexcept
+        {
+            return m_count[o] != 0;
+        }
+
+        template <class T, bool SQRT>
+        inline auto xvariance_kernel<T, SQRT>::result(std::size_t o) const noexcept -> result_type
+        {
+            result_type var = m_count[o] != 0 ? m_m2[o] / static_cast<result_type>(m_count[o]) : result_type(0);
+            return SQRT ? std::sqrt(var) : var;
+        }
+
+        /********************************
+         * xcount_kernel implementation *
+         ********************************/
+
+        template <class T>
+        inline xcount_kernel<T>::xcount_kernel(std::size_t size)
+            : xreducer_counter(size)
+        {
+        }
+
+        template <class T>
+        inline void xcount_kernel<T>::reduce(std::size_t o, const T*, const std::uint8_t* f, std::size_t n)
+        {
+            reduce_count(o, f, n);
+        }
+
+        template <class T>
+        inline void xcount_kernel<T>::accumulate(std::size_t o, const T*, const std::uint8_t* f, std::size_t n)
+        {
+            accumulate_count(o, f, n);
+        }
+
+        template <class T>
+        inline void xcount_kernel<T>::merge(const self_type& rhs)
+        {
+            merge_count(rhs);
+        }
+
+        template <class T>
+        inline bool xcount_kernel<T>::has_result(std::size_t) const noexcept
+        {
+            return true;
+        }
+
+        template <class T>
+        inline auto xcount_kernel<T>::result(std::size_t o) const noexcept -> result_type
+        {
+            return m_count[o];
+        }
+
+        /*******************************
+         * xpick_kernel implementation *
+         *******************************/
+
+        template <class T, bool LAST>
+        inline xpick_kernel<T, LAST>::xpick_kernel(std::size_t size)
+            : xreducer_counter(size), m_value(size, T())
+        {
+        }
+
+        template <class T, bool LAST>
+        inline void xpick_kernel<T, LAST>::reduce(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            if (LAST)
+            {
+                for (std::size_t i = n; i != 0; --i)
+                {
+                    if (f[i - 1])
+                    {
+                        m_value[o] = v[i - 1];
+                        break;
+                    }
+                }
+            }
+            else if (m_count[o] == 0)
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    if (f[i])
+                    {
+                        m_value[o] = v[i];
+                        break;
+                    }
+                }
+            }
+            reduce_count(o, f, n);
+        }
+
+        template <class T, bool LAST>
+        inline void xpick_kernel<T, LAST>::accumulate(std::size_t o, const T* v, const std::uint8_t* f, std::size_t n)
+        {
+            const std::size_t* c = m_count.data() + o;
+            T* r = m_value.data() + o;
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                const bool pick = LAST ? f[i] != 0 : (f[i] != 0 && c[i] == 0);
+                r[i] = pick ? v[i] : r[i];
+            }
+            accumulate_count(o, f, n);
+        }
+
+        template <class T, bool LAST>
+        inline void xpick_kernel<T, LAST>::merge(const self_type& rhs)
+        {
+            for (std::size_t i = 0; i < m_value.size(); ++i)
+            {
+                const bool pick = rhs.m_count[i] != 0 && (LAST || m_count[i] == 0);
+                m_value[i] = pick ? rhs.m_value[i] : m_value[i];
+            }
+            merge_count(rhs);
+        }
+
+        template <class T, bool LAST>
+        inline bool xpick_kernel<T, LAST>::has_result(std::size_t o) const noexcept
+        {
+            return m_count[o] != 0;
+        }
+
+        template <class T, bool LAST>
+        inline auto xpick_kernel<T, LAST>::result(std::size_t o) const noexcept -> result_type
+        {
+            return m_value[o];
+        }
+    }
+
+    /*************************************
+     * reducing functions implementation *
+     *************************************/
+
+    namespace detail
+    {
+        template <class CCT, class ECT>
+        inline const xvariable_container<CCT, ECT>& reducer_operand(const xvariable_container<CCT, ECT>& e)
+        {
+            return e;
+        }
+
+        /**
+         * Variable type used for evaluating expressions that are not
+         * containers, such as functions and views, before reducing them.
+         */
+        template <class E>
+        struct xreducer_temporary
+        {
+            using value_type = typename E::value_type::value_type;
+            using coordinate_type = typename E::temporary_type::coordinate_type;
+            using data_type = xt::xoptional_assembly<xt::xarray<value_type>, xt::xarray<bool>>;
+            using type = xvariable_container<coordinate_type, data_type>;
+        };
+
+        template <class E>
+        using xreducer_temporary_t = typename xreducer_temporary<E>::type;
+
+        template <class E>
+        inline xreducer_temporary_t<E> reducer_operand(const E& e)
+        {
+            return xreducer_temporary_t<E>(e);
+        }
+
+        /**
+         * Provides the value and flag buffers of the data of a variable. The
+         * buffers of an xoptional_assembly are used directly, except validity
+         * bitmaps that are unpacked; other data are evaluated into temporary
+         * arrays.
+         */
+        template <class D>
+        struct xreducer_buffers
+        {
+            using value_type = typename D::value_type::value_type;
+            using value_buffer = xt::xarray<value_type>;
+            using flag_buffer = xt::xarray<bool>;
+
+            static value_buffer values(const D& d)
+            {
+                return xt::value(d);
+            }
+
+            static flag_buffer flags(const D& d)
+            {
+                return xt::has_value(d);
+            }
+        };
+
+        template <class VE, class FE>
+        struct xreducer_buffers<xt::xoptional_assembly<VE, FE>>
+        {
+            using data_type = xt::xoptional_assembly<VE, FE>;
+            using value_type = typename VE::value_type;
+
+            static const VE& values(const data_type& d)
+            {
+                return d.value();
+            }
+
+            static const FE& flags(const data_type& d)
+            {
+                return d.has_value();
+            }
+        };
+
+        template <class VE>
+        struct xreducer_buffers<xt::xoptional_assembly<VE, xbitmap_array>>
+        {
+            using data_type = xt::xoptional_assembly<VE, xbitmap_array>;
+            using value_type = typename VE::value_type;
+            using flag_buffer = xt::xarray<bool>;
+
+            static const VE& values(const data_type& d)
+            {
+                return d.value();
+            }
+
+            static flag_buffer flags(const data_type& d)
+            {
+                const auto& bitmap = d.has_value();
+                flag_buffer res = flag_buffer::from_shape(bitmap.shape());
+                bitmap.storage().unpack(res.data());
+                return res;
+            }
+        };
+
+        /**
+         * Reduces row-major buffers of values and flags with the given kernel.
+         * Adjacent axes that are both reduced or both kept are merged first, so
+         * that the innermost loop runs over the longest contiguous range.
+         */
+        template <class K, class T>
+        inline void reduce_buffers(K& kernel, const T* v, const std::uint8_t* f,
+                                   const std::vector<std::size_t>& shape, const std::vector<bool>& reduced)
+        {
+            std::vector<std::size_t> cshape;
+            std::vector<bool> creduced;
+            std::size_t size = 1;
+            for (std::size_t d = 0; d < shape.size(); ++d)
+            {
+                size *= shape[d];
+                if (!cshape.empty() && creduced.back() == reduced[d])
+                {
+                    cshape.back() *= shape[d];
+                }
+                else
+                {
+                    cshape.push_back(shape[d]);
+                    creduced.push_back(reduced[d]);
+                }
+            }
+
+            if (cshape.empty())
+            {
+                kernel.reduce(0, v, f, 1);
+                return;
+            }
+            if (size == 0)
+            {
+                return;
+            }
+
+            std::size_t last = cshape.size() - 1;
+            std::vector<std::size_t> out_strides(cshape.size(), 0);
+            std::size_t stride = 1;
+            for (std::size_t d = cshape.size(); d != 0; --d)
+            {
+                if (!creduced[d - 1])
+                {
+                    out_strides[d - 1] = stride;
+                    stride *= cshape[d - 1];
+                }
+            }
+
+            std::size_t n = cshape[last];
+            std::size_t outer_size = size / n;
+            std::vector<std::size_t> index(last, 0);
+            std::size_t out_offset = 0;
+            for (std::size_t k = 0; k < outer_size; ++k)
+            {
+                if (creduced[last])
+                {
+                    kernel.reduce(out_offset, v + k * n, f + k * n, n);
+                }
+                else
+                {
+                    kernel.accumulate(out_offset, v + k * n, f + k * n, n);
+                }
+
+                for (std::size_t d = last; d != 0; --d)
+                {
+                    out_offset += out_strides[d - 1];
+                    if (++index[d - 1] != cshape[d - 1])
+                    {
+                        break;
+                    }
+                    out_offset -= index[d - 1] * out_strides[d - 1];
+                    index[d - 1] = 0;
+                }
+            }
+        }
+
+        template <template <class> class K, class E>
+        inline auto reduce_variable(const E& e, const xreducer_dimension_list<E>& dims, bool skipna)
+        {
+            const auto& var = reducer_operand(e);
+            using variable_type = std::decay_t<decltype(var)>;
+            using coordinate_type = typename variable_type::coordinate_type;
+            using coordinate_map = typename coordinate_type::map_type;
+            using dimension_list = typename variable_type::dimension_list;
+            using buffers_type = xreducer_buffers<typename variable_type::data_type>;
+            using kernel_type = K<typename buffers_type::value_type>;
+            using result_type = typename kernel_type::result_type;
+
+            const auto& dimension_mapping = var.dimension_mapping();
+            std::vector<bool> reduced(var.dimension(), false);
+            for (const auto& name : dims)
+            {
+                if (!dimension_mapping.contains(name))
+                {
+                    throw std::out_of_range("invalid dimension name in reduction");
+                }
+                reduced[dimension_mapping[name]] = true;
+            }
+
+            std::vector<std::size_t> shape(var.shape().cbegin(), var.shape().cend());
+            std::vector<std::size_t> result_shape;
+            std::size_t group_size = 1;
+            coordinate_map result_coordinates;
+            dimension_list result_dimensions;
+            for (std::size_t d = 0; d < shape.size(); ++d)
+            {
+                const auto& name = var.dimension_labels()[d];
+                if (reduced[d])
+                {
+                    group_size *= shape[d];
+                }
+                else
+                {
+                    result_shape.push_back(shape[d]);
+                    result_coordinates.emplace(name, var.coordinates()[name]);
+                    result_dimensions.push_back(name);
+                }
+            }
+
+            xt::xarray<result_type> values = xt::xarray<result_type>::from_shape(result_shape);
+            xt::xarray<bool> flags = xt::xarray<bool>::from_shape(result_shape);
+            kernel_type kernel(values.size());
+            {
+                const auto& v = buffers_type::values(var.data());
+                const auto& f = buffers_type::flags(var.data());
+                // Flags are read as bytes, which lets compilers vectorize the
+                // loops mixing them with values.
+                const std::uint8_t* fp = reinterpret_cast<const std::uint8_t*>(f.data());
+                reduce_buffers(kernel, v.data(), fp, shape, reduced);
+            }
+
+            for (std::size_t o = 0; o < values.size(); ++o)
+            {
+                values.data()[o] = kernel.result(o);
+                flags.data()[o] = kernel.has_result(o) && (skipna || kernel.count(o) == group_size);
+            }
+
+            using data_type = xt::xoptional_assembly<xt::xarray<result_type>, xt::xarray<bool>>;
+            return variable(data_type(std::move(values), std::move(flags)),
+                            std::move(result_coordinates),
+                            std::move(result_dimensions));
+        }
+
+        template <class T>
+        using xmin_kernel = xextremum_kernel<T, xless_than>;
+
+        template <class T>
+        using xmax_kernel = xextremum_kernel<T, xgreater_than>;
+
+        template <class T>
+        using xvar_kernel = xvariance_kernel<T, false>;
+
+        template <class T>
+        using xstd_kernel = xvariance_kernel<T, true>;
+
+        template <class T>
+        using xfirst_kernel = xpick_kernel<T, false>;
+
+        template <class T>
+        using xlast_kernel = xpick_kernel<T, true>;
+    }
+
+    /**
+     * @defgroup reducers Reducing functions
+     */
+
+    /**
+     * @ingroup reducers
+     * @brief Sum of the values over the given dimensions.
+     *
+     * Returns a variable holding the sum of the values of \c e over the
+     * dimensions \c dims. The result has the remaining dimensions of \c e
+     * and their coordinates. Missing values are skipped if \c skipna is true,
+     * so that the sum of missing values only is 0; otherwise an element
+     * of the result is missing if any of the reduced values is missing.
+     * @param e the variable expression to reduce.
+     * @param dims the names of the dimensions to reduce.
+     * @param skipna whether missing values are skipped.
+     */
+    template <class E>
+    inline auto sum(const E& e, const xreducer_dimension_list<E>& dims, bool skipna)
+    {
+        return detail::reduce_variable<detail::xsum_kernel>(e, dims, skipna);
+    }
+
+    /**
+     * @ingroup reducers
+     * @brief Mean of the values over the given dimensions.
+     *
+     * An element of the result is missing if all the reduced values
+     * are missing.
+     * @param e the variable expression to reduce.
+     * @param dims the names of the dimensions to reduce.
+     * @param skipna whether missing values are skipped.
+     * @sa sum
+     */
+    template <class E>
+    inline auto mean(const E& e, const xreducer_dimension_list<E>& dims, bool skipna)
+    {
+        return detail::reduce_variable<detail::xmean_kernel>(e, dims, skipna);
+    }
+
+    /**
+     * @ingroup reducers
+     * @brief Minimum of the values over the given dimensions.
+     *
+     * An element of the result is missing if all the reduced values
+     * are missing.
+     * @param e the variable expression to reduce.
+     * @param dims the names of the dimensions to reduce.
+     * @param skipna whether missing values are skipped.
+     * @sa sum
+     */
+    template <class E>
+    inline auto amin(const E& e, const xreducer_dimension_list<E>& dims, bool skipna)
+    {
+        return detail::reduce_variable<detail::xmin_kernel>(e, dims, skipna);
+    }
+
+    /**
+     * @ingroup reducers
+     * @brief Maximum of the values over the given dimensions.
+     *
+     * An element of the result is missing if all the reduced values
+     * are missing.
+     * @param e the variable expression to reduce.
+     * @param dims the names of the dimensions to reduce.
+     * @param skipna whether missing values are skipped.
+     * @sa sum
+     */
+    template <class E>
+    inline auto amax(const E& e, const xreducer_dimension_list<E>& dims, bool skipna)
+    {
+        return detail::reduce_variable<detail::xmax_kernel>(e, dims, skipna);
+    }
+
+    /**
+     * @ingroup reducers
+     * @brief Population variance of the values over the given dimensions.
+     *
+     * An element of the result is missing if all the reduced values
+     * are missing.
+     * @param e the variable expression to reduce.
+     * @param dims the names of the dimensions to reduce.
+     * @param skipna whether missing values are skipped.
+     * @sa sum
+     */
+    template <class E>
+    inline auto variance(const E& e, const xreducer_dimension_list<E>& dims, bool skipna)
+    {
+        return detail::reduce_variable<detail::xvar_kernel>(e, dims, skipna);
+    }
+
+    /**
+     * @ingroup reducers
+     * @brief Population standard deviation of the values over the given dimensions.
+     *
+     * An element of the result is missing if all the reduced values
+     * are missing.
+     * @param e the variable expression to reduce.
+     * @param dims the names of the dimensions to reduce.
+     * @param skipna whether missing values are skipped.
+     * @sa sum
+     */
+    template <class E>
+    inline auto stddev(const E& e, const xreducer_dimension_list<E>& dims, bool skipna)
+    {
+        return detail::reduce_variable<detail::xstd_kernel>(e, dims, skipna);
+    }
+
+    /**
+     * @ingroup reducers
+     * @brief Number of non-missing values over the given dimensions.
+     * @param e the variable expression to reduce.
+     * @param dims the names of the dimensions to reduce.
+     */
+    template <class E>
+    inline auto count(const E& e, const xreducer_dimension_list<E>& dims)
+    {
+        return detail::reduce_variable<detail::xcount_kernel>(e, dims, true);
+    }
+}
+
+#endif
@@ -114,6 +114,14 @@ namespace xf
         using locator_type = typename selector_traits<N>::locator_type;
         template <std::size_t N = dynamic()>
         using locator_sequence_type = typename selector_traits<N>::locator_sequence_type;
+        template <std::size_t N = dynamic()>
+        using prepared_selector_type = typename selector_traits<N>::prepared_selector_type;
+        template <std::size_t N = dynamic()>
+        using name_sequence_type = typename selector_traits<N>::name_sequence_type;
+        template <std::size_t N = dynamic()>
+        using label_sequence_type = typename selector_traits<N>::label_sequence_type;
+        template <std::size_t N = dynamic()>
+        using label_batch_type = typename selector_traits<N>::label_batch_type;
 
         static const_reference missing();
 
@@ -190,6 +198,24 @@ namespace xf
         template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N = dynamic()>
         const_reference select(selector_sequence_type<N>&& selector) const;
 
+        template <std::size_t N = dynamic()>
+        prepared_selector_type<N> prepare_selector(const name_sequence_type<N>& names) const;
+
+        template <std::size_t N>
+        reference select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                         const label_sequence_type<N>& labels);
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N>
+        const_reference select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                               const label_sequence_type<N>& labels) const;
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N = dynamic()>
+        xt::xarray<value_type> select_batch(const name_sequence_type<N>& names, const label_batch_type<N>& labels) const;
+
+        template <class Join = XFRAME_DEFAULT_JOIN, std::size_t N>
+        xt::xarray<value_type> select_batch(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                            const label_batch_type<N>& labels) const;
+
         template <std::size_t N = dynamic()>
         reference iselect(const iselector_sequence_type<N>& selector);
 
@@ -504,6 +530,54 @@ namespace xf
         return select_join<Join>(selector_type<N>(std::move(selector)));
     }
 
+    template <class CT>
+    template <std::size_t N>
+    inline auto xvariable_view<CT>::prepare_selector(const name_sequence_type<N>& names) const -> prepared_selector_type<N>
+    {
+        // Positions are resolved in the dimension mapping of the underlying
+        // expression so that squeezed dimensions can be filled afterwards.
+        return prepared_selector_type<N>(coordinates(), m_e.dimension_mapping(), names);
+    }
+
+    template <class CT>
+    template <std::size_t N>
+    inline auto xvariable_view<CT>::select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                           const label_sequence_type<N>& labels) -> reference
+    {
+        return select_impl(detail::bind_labels(selector, labels));
+    }
+
+    template <class CT>
+    template <class Join, std::size_t N>
+    inline auto xvariable_view<CT>::select(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                           const label_sequence_type<N>& labels) const -> const_reference
+    {
+        return select_join<Join>(detail::bind_labels(selector, labels));
+    }
+
+    template <class CT>
+    template <class Join, std::size_t N>
+    inline auto xvariable_view<CT>::select_batch(const name_sequence_type<N>& names, const label_batch_type<N>& labels) const
+        -> xt::xarray<value_type>
+    {
+        return select_batch<Join>(prepare_selector<N>(names), labels);
+    }
+
+    template <class CT>
+    template <class Join, std::size_t N>
+    inline auto xvariable_view<CT>::select_batch(const xprepared_selector<coordinate_type, dimension_type, N>& selector,
+                                                 const label_batch_type<N>& labels) const -> xt::xarray<value_type>
+    {
+        return selector.template gather<value_type>(labels, [this](auto idx)
+        {
+            fill_squeeze(idx);
+            return m_e.element(idx);
+        }, /*missing*/ [this, &selector](const auto& point)
+        {
+            return this->template select_join<Join>(detail::bind_labels(selector, point));
+        });
+    }
+
     template <class CT>
     template <std::size_t N>
     inline auto xvariable_view<CT>::iselect(const iselector_sequence_type<N>& selector) -> reference
@@ -747,11 +821,21 @@ namespace xf
         }
     }
 
+    /**
+     * Assigns tmp to the view. When tmp has the dimensions and the labels of
+     * the view, its data is assigned at once to the strided view of the
+     * underlying data; otherwise, each element is assigned by label.
+     */
     template <class CT>
     inline void xvariable_view<CT>::assign_temporary_impl(temporary_type&& tmp)
     {
-        // TODO: improve this with iterators when they are available
         const temporary_type& tmp2 = tmp;
+        if (tmp2.dimension_labels() == dimension_labels() && tmp2.coordinates() == coordinates())
+        {
+            xt::noalias(data()) = tmp2.data();
+            return;
+        }
+
         const auto& dim_label = dimension_labels();
         const auto& coords = coordinates();
         std::vector<size_type> index(dim_label.size(), size_type(0));
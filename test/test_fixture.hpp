@@ -19,7 +19,7 @@
 
 namespace xf
 {
-    using saxis_type = xaxis<fstring, std::size_t>;
+    using saxis_type = xaxis<XFRAME_STRING_LABEL, std::size_t>;
     using iaxis_type = xaxis<int, std::size_t>;
     using daxis_type = xaxis_default<int, std::size_t>;
     using dimension_type = xdimension<fstring, std::size_t>;
@@ -317,6 +317,27 @@ namespace xf
         return bool_variable_type(make_test_bool_data(), make_test_coordinate(), dimension_type({ "abscissa", "ordinate" }));
     }
 
+    // x: { x0, ..., x0 + nx - 1 }
+    // y: { y0, ..., y0 + ny - 1 }
+    // dims: {{ "x", 0 }, { "y", 1 }}
+    // data(i, j) = i * ny + j, every seventh element missing
+    template <class V = variable_type>
+    inline V make_test_grid_variable(std::size_t nx, std::size_t ny, int x0 = 0, int y0 = 0)
+    {
+        auto c = coordinate<fstring>(
+            named_axis(fstring("x"), axis(x0, x0 + static_cast<int>(nx))),
+            named_axis(fstring("y"), axis(y0, y0 + static_cast<int>(ny)))
+        );
+        using grid_data_type = typename V::data_type;
+        grid_data_type d(typename grid_data_type::shape_type({nx, ny}));
+        for (std::size_t i = 0; i < d.size(); ++i)
+        {
+            d.storage()[i].value() = double(i);
+            d.storage()[i].has_value() = i % 7 != 0;
+        }
+        return V(std::move(d), std::move(c), dimension_type({"x", "y"}));
+    }
+
     /*************
      * selectors *
      *************/
@@ -22,6 +22,8 @@ namespace xf
     using caxis_type = xaxis<char>;
     using iaxis_type = xaxis<int>;
     using daxis_type = xaxis<double>;
+    using saxis_type = xaxis<fstring, std::size_t, sorted_vector_tag>;
+    using faxis_type = xaxis<fstring, std::size_t, flat_hash_map_tag>;
 
     TEST(xaxis, constructors)
     {
@@ -288,6 +290,32 @@ namespace xf
         EXPECT_FALSE(t4);
     }
 
+    TEST(xaxis, intersect_unsorted)
+    {
+        axis_type a1 = { "e", "b", "a", "d" };
+        axis_type a2 = { "a", "d", "c", "e" };
+        axis_type tmp = a1;
+        bool t1 = intersect_axes(tmp, a2);
+        EXPECT_FALSE(t1);
+        EXPECT_EQ(tmp.size(), 3u);
+        EXPECT_EQ(tmp["e"], 0u);
+        EXPECT_EQ(tmp["a"], 1u);
+        EXPECT_EQ(tmp["d"], 2u);
+        EXPECT_FALSE(tmp.contains("b"));
+
+        axis_type a3 = { "e", "a", "d", "c" };
+        tmp = a1;
+        bool t2 = intersect_axes(tmp, a2, a3);
+        EXPECT_FALSE(t2);
+        EXPECT_EQ(tmp.size(), 3u);
+
+        axis_type a4 = { "e", "b", "a", "d", "f" };
+        tmp = a1;
+        bool t3 = intersect_axes(tmp, a4);
+        EXPECT_TRUE(t3);
+        EXPECT_EQ(tmp, a1);
+    }
+
     TEST(xaxis, filter)
     {
         axis_type a = { "a", "b", "d", "e" };
@@ -296,4 +324,109 @@ namespace xf
         EXPECT_EQ(a["a"], 0u);
         EXPECT_EQ(a["b"], 1u);
     }
+
+    TEST(xaxis, sorted_vector_access)
+    {
+        saxis_type a = { "a", "b", "c" };
+        EXPECT_TRUE(a.is_sorted());
+        EXPECT_TRUE(a.contains("b"));
+        EXPECT_FALSE(a.contains("d"));
+        EXPECT_EQ(a["a"], 0u);
+        EXPECT_EQ(a["b"], 1u);
+        EXPECT_EQ(a["c"], 2u);
+        EXPECT_THROW(a["d"], std::out_of_range);
+
+        saxis_type b = { "c", "a", "d", "b" };
+        EXPECT_FALSE(b.is_sorted());
+        EXPECT_TRUE(b.contains("d"));
+        EXPECT_FALSE(b.contains("e"));
+        EXPECT_EQ(b["c"], 0u);
+        EXPECT_EQ(b["a"], 1u);
+        EXPECT_EQ(b["d"], 2u);
+        EXPECT_EQ(b["b"], 3u);
+        EXPECT_THROW(b["e"], std::out_of_range);
+    }
+
+    TEST(xaxis, sorted_vector_iterator)
+    {
+        saxis_type a = { "c", "a", "b" };
+
+        auto it = a.find("a");
+        EXPECT_EQ(it->first, "a");
+        EXPECT_EQ(it->second, 1u);
+        EXPECT_EQ(a.find("d"), a.end());
+
+        std::size_t i = 0;
+        for (const auto& p : a)
+        {
+            EXPECT_EQ(p.first, a.labels()[i]);
+            EXPECT_EQ(p.second, i);
+            ++i;
+        }
+        EXPECT_EQ(a["b"], (a.begin() + 2)->second);
+    }
+
+    TEST(xaxis, sorted_vector_set_operations)
+    {
+        saxis_type a1 = { "a", "b", "d", "e" };
+        saxis_type a2 = { "h", "c", "a", "b", "d", "e" };
+        saxis_type res;
+        bool t1 = merge_axes(res, a1, a2);
+        EXPECT_FALSE(t1);
+        EXPECT_FALSE(res.is_sorted());
+        EXPECT_EQ(res.size(), 6u);
+        EXPECT_EQ(res["h"], 0u);
+        EXPECT_EQ(res["c"], 1u);
+        EXPECT_EQ(res["a"], 2u);
+        EXPECT_EQ(res["e"], 5u);
+
+        saxis_type a3 = { "b", "c", "d" };
+        saxis_type tmp = a1;
+        bool t2 = intersect_axes(tmp, a3);
+        EXPECT_FALSE(t2);
+        EXPECT_EQ(tmp.size(), 2u);
+        EXPECT_EQ(tmp["b"], 0u);
+        EXPECT_EQ(tmp["d"], 1u);
+        EXPECT_FALSE(tmp.contains("a"));
+    }
+
+    TEST(xaxis, flat_hash_map_access)
+    {
+        faxis_type a = { "c", "a", "d", "b" };
+        EXPECT_TRUE(a.contains("d"));
+        EXPECT_FALSE(a.contains("e"));
+        EXPECT_EQ(a["c"], 0u);
+        EXPECT_EQ(a["a"], 1u);
+        EXPECT_EQ(a["d"], 2u);
+        EXPECT_EQ(a["b"], 3u);
+        EXPECT_THROW(a["e"], std::out_of_range);
+
+        auto it = a.find("d");
+        EXPECT_EQ(it->first, "d");
+        EXPECT_EQ(it->second, 2u);
+        EXPECT_EQ(a.find("e"), a.end());
+    }
+
+    TEST(xaxis, flat_hash_map_set_operations)
+    {
+        faxis_type a1 = { "a", "b", "d", "e" };
+        faxis_type a2 = { "h", "c", "a", "b", "d", "e" };
+        faxis_type res;
+        bool t1 = merge_axes(res, a1, a2);
+        EXPECT_FALSE(t1);
+        EXPECT_EQ(res.size(), 6u);
+        EXPECT_EQ(res["h"], 0u);
+        EXPECT_EQ(res["c"], 1u);
+        EXPECT_EQ(res["a"], 2u);
+        EXPECT_EQ(res["e"], 5u);
+
+        faxis_type a3 = { "b", "c", "d" };
+        faxis_type tmp = a1;
+        bool t2 = intersect_axes(tmp, a3);
+        EXPECT_FALSE(t2);
+        EXPECT_EQ(tmp.size(), 2u);
+        EXPECT_EQ(tmp["b"], 0u);
+        EXPECT_EQ(tmp["d"], 1u);
+        EXPECT_FALSE(tmp.contains("a"));
+    }
 }
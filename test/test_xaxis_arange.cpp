@@ -0,0 +1,239 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+
+#include "xframe/xframe_config.hpp"
+#include "xframe/xaxis.hpp"
+#include "xframe/xaxis_arange.hpp"
+#include "xframe/xaxis_variant.hpp"
+
+namespace xf
+{
+    using axis_type = xaxis<int>;
+    using label_type = std::vector<int>;
+    using axis_range_type = xaxis_arange<int>;
+    using axis_variant_type = xaxis_variant<XFRAME_DEFAULT_LABEL_LIST, std::size_t>;
+
+    TEST(xaxis_arange, range_axis)
+    {
+        auto a = range_axis(2, 11, 3);
+        EXPECT_EQ(2, a.start());
+        EXPECT_EQ(3, a.step());
+        EXPECT_EQ(3u, a.size());
+
+        auto a2 = range_axis(2, 12, 3);
+        EXPECT_EQ(4u, a2.size());
+
+        auto a3 = range_axis(4, 2);
+        EXPECT_TRUE(a3.empty());
+
+        EXPECT_THROW(axis_range_type(0, 0, 4), std::runtime_error);
+        EXPECT_THROW(range_axis(0, 10, 0), std::runtime_error);
+        EXPECT_THROW(range_axis(0, 10, -1), std::runtime_error);
+    }
+
+    TEST(xaxis_arange, labels)
+    {
+        axis_range_type a(10, 5, 4);
+        EXPECT_EQ(10, a.label(0));
+        EXPECT_EQ(25, a.label(3));
+
+        label_type labels = a.labels();
+        EXPECT_EQ(label_type({10, 15, 20, 25}), labels);
+
+        // Copies share the label list once built
+        axis_range_type a2 = a;
+        EXPECT_EQ(&a.labels(), &a2.labels());
+
+        axis_range_type a3(0, 2, 1000);
+        std::vector<const label_type*> res(8, nullptr);
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < res.size(); ++i)
+        {
+            threads.emplace_back([&a3, &res, i]() { res[i] = &a3.labels(); });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        for (std::size_t i = 0; i < res.size(); ++i)
+        {
+            EXPECT_EQ(res[0], res[i]);
+        }
+        EXPECT_EQ(1000u, res[0]->size());
+        EXPECT_EQ(1998, res[0]->back());
+
+        a3.merge(axis_range_type(2000, 2, 1));
+        EXPECT_EQ(1001u, a3.labels().size());
+        EXPECT_EQ(1000u, res[0]->size());
+    }
+
+    TEST(xaxis_arange, contains)
+    {
+        axis_range_type a(10, 5, 4);
+        EXPECT_TRUE(a.contains(10));
+        EXPECT_TRUE(a.contains(20));
+        EXPECT_TRUE(a.contains(25));
+        EXPECT_FALSE(a.contains(5));
+        EXPECT_FALSE(a.contains(12));
+        EXPECT_FALSE(a.contains(30));
+    }
+
+    TEST(xaxis_arange, access)
+    {
+        axis_range_type a(10, 5, 4);
+        EXPECT_EQ(0u, a[10]);
+        EXPECT_EQ(2u, a[20]);
+        EXPECT_EQ(3u, a[25]);
+        EXPECT_THROW(a[12], std::out_of_range);
+        EXPECT_THROW(a[30], std::out_of_range);
+    }
+
+    TEST(xaxis_arange, iterator)
+    {
+        axis_range_type a(10, 5, 3);
+
+        auto it = a.begin();
+        EXPECT_TRUE(it == a.cbegin());
+        EXPECT_TRUE(it != a.end());
+        EXPECT_TRUE(it < a.end());
+
+        EXPECT_EQ(it->first, 10);
+        EXPECT_EQ(it->second, a[10]);
+        ++it;
+        EXPECT_EQ(it->first, 15);
+        EXPECT_EQ(it->second, a[15]);
+        auto tmp = it++;
+        EXPECT_EQ(tmp->first, 15);
+        EXPECT_EQ(it->first, 20);
+        ++it;
+        EXPECT_EQ(it, a.end());
+
+        EXPECT_EQ(20, (a.begin() + 2)->first);
+        EXPECT_EQ(15, (a.end() - 2)->first);
+        EXPECT_EQ(3, a.end() - a.begin());
+
+        EXPECT_EQ(15, a.find(15)->first);
+        EXPECT_EQ(1u, a.find(15)->second);
+        EXPECT_EQ(a.end(), a.find(16));
+    }
+
+    TEST(xaxis_arange, filter)
+    {
+        axis_range_type a(0, 2, 10);
+        axis_type res = a.filter([](const auto& arg) { return arg >= 10; });
+        EXPECT_TRUE(res.is_sorted());
+        EXPECT_EQ(label_type({10, 12, 14, 16, 18}), res.labels());
+
+        axis_type res2 = a.filter([](const auto& arg) { return arg < 4; }, std::size_t(2));
+        EXPECT_EQ(label_type({0, 2}), res2.labels());
+    }
+
+    TEST(xaxis_arange, merge)
+    {
+        axis_range_type a(0, 2, 4);
+        axis_range_type a2(6, 2, 3);
+        axis_range_type a3(12, 2, 1);
+        axis_range_type a4(1, 2, 4);
+
+        EXPECT_TRUE(a.can_merge(a2));
+        EXPECT_FALSE(a.can_merge(a3));
+        EXPECT_TRUE(a.can_merge(a3, a2));
+        EXPECT_FALSE(a.can_merge(a4));
+
+        axis_range_type res = a;
+        EXPECT_TRUE(res.merge(a));
+        EXPECT_EQ(a, res);
+
+        EXPECT_FALSE(res.merge(a3, a2));
+        EXPECT_EQ(axis_range_type(0, 2, 7), res);
+
+        axis_range_type res2 = a;
+        EXPECT_THROW(res2.merge(a4), std::runtime_error);
+        EXPECT_EQ(a, res2);
+    }
+
+    TEST(xaxis_arange, intersect)
+    {
+        axis_range_type a(0, 2, 6);
+        axis_range_type a2(4, 2, 6);
+        axis_range_type a3(1, 2, 4);
+        axis_range_type a4(0, 3, 4);
+
+        axis_range_type res = a;
+        EXPECT_TRUE(res.intersect(a));
+        EXPECT_FALSE(res.intersect(a2));
+        EXPECT_EQ(axis_range_type(4, 2, 4), res);
+
+        EXPECT_FALSE(res.intersect(a3));
+        EXPECT_TRUE(res.empty());
+
+        EXPECT_FALSE(a.can_intersect(a4));
+        axis_range_type res2 = a;
+        EXPECT_THROW(res2.intersect(a4), std::runtime_error);
+    }
+
+    TEST(xaxis_arange, variant)
+    {
+        axis_variant_type a = axis_range_type(10, 5, 4);
+        EXPECT_EQ(4u, a.size());
+        EXPECT_TRUE(a.contains(15));
+        EXPECT_FALSE(a.contains(16));
+        EXPECT_EQ(1u, a[15]);
+        EXPECT_EQ(axis_variant_type::key_type(25), a.label(3));
+        EXPECT_EQ(a.as_xaxis(), a);
+
+        auto labels = get_labels<int>(a);
+        EXPECT_EQ(label_type({10, 15, 20, 25}), labels);
+    }
+
+    TEST(xaxis_arange, variant_set_operations)
+    {
+        axis_variant_type a = axis_range_type(0, 2, 4);
+        axis_variant_type a2 = axis_range_type(8, 2, 2);
+        axis_variant_type a3 = axis_range_type(1, 2, 2);
+
+        // Aligned ranges are merged into a range
+        axis_variant_type res = a;
+        EXPECT_FALSE(res.merge(a2));
+        EXPECT_EQ(axis_variant_type(axis_range_type(0, 2, 6)), res);
+
+        res = a;
+        EXPECT_FALSE(res.intersect(a2));
+        EXPECT_TRUE(res.empty());
+
+        // Other ranges are merged into an xaxis
+        res = a;
+        EXPECT_FALSE(res.merge(a3));
+        EXPECT_EQ(axis_variant_type(axis_type({0, 1, 2, 3, 4, 6})), res);
+
+        // Merging an xaxis with a range
+        axis_variant_type res2 = axis_type({1, 3});
+        EXPECT_FALSE(res2.merge(a));
+        EXPECT_EQ(axis_variant_type(axis_type({0, 1, 2, 3, 4, 6})), res2);
+    }
+
+    TEST(xaxis_arange, equality)
+    {
+        axis_variant_type a = axis_range_type(10, 5, 4);
+        EXPECT_EQ(axis_variant_type(axis_type({10, 15, 20, 25})), a);
+        EXPECT_EQ(a, axis_variant_type(axis_type({10, 15, 20, 25})));
+        EXPECT_NE(axis_variant_type(axis_type({10, 15, 20})), a);
+        EXPECT_NE(axis_variant_type(axis_type({10, 15, 20, 26})), a);
+
+        using daxis_type = xaxis_default<int, std::size_t>;
+        EXPECT_EQ(axis_variant_type(daxis_type(4)), axis_variant_type(axis_range_type(0, 1, 4)));
+        EXPECT_NE(axis_variant_type(daxis_type(4)), axis_variant_type(axis_range_type(0, 2, 4)));
+    }
+}
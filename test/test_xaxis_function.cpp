@@ -131,4 +131,11 @@ namespace xf
         xt::xarray<bool> val = array && mask;
         EXPECT_EQ(val, expected);
     }
+
+    TEST(xaxis_function, mask_missing_axis)
+    {
+        auto axis1 = named_axis(fstring("abs"), axis({0, 2, 5}));
+        auto array = xt::xarray<bool>::from_shape({3});
+        EXPECT_THROW(axis_function_mask(equal(axis1, 0), dimension_type({"ord"}), array.shape()), std::runtime_error);
+    }
 }
@@ -67,4 +67,108 @@ namespace xf
         EXPECT_EQ(2u, a2);
         EXPECT_THROW(a[3], std::out_of_range);
     }
+
+    TEST(xaxis_variant, stamp)
+    {
+        auto a = axis_variant_type(axis({1, 2, 4}));
+        auto a2 = a;
+        EXPECT_EQ(a.stamp(), a2.stamp());
+
+        auto b = axis_variant_type(axis({1, 2, 4}));
+        EXPECT_NE(a.stamp(), b.stamp());
+
+        a2.merge(axis_variant_type(axis({3})));
+        EXPECT_NE(a.stamp(), a2.stamp());
+
+        auto a3 = a;
+        a3.intersect(axis_variant_type(axis({2, 4})));
+        EXPECT_NE(a.stamp(), a3.stamp());
+    }
+
+    TEST(xaxis_variant, copy_on_write)
+    {
+        auto a = axis_variant_type(axis({1, 2, 4}));
+        auto a2 = a;
+        EXPECT_EQ(a, a2);
+        EXPECT_EQ(&get_labels<int>(a), &get_labels<int>(a2));
+
+        a2.merge(axis_variant_type(axis({3})));
+        EXPECT_EQ(3u, a.size());
+        EXPECT_EQ(4u, a2.size());
+        EXPECT_NE(&get_labels<int>(a), &get_labels<int>(a2));
+        EXPECT_NE(a, a2);
+
+        auto a3 = a;
+        EXPECT_TRUE(a3.intersect(a));
+        EXPECT_EQ(&get_labels<int>(a), &get_labels<int>(a3));
+        EXPECT_EQ(a.stamp(), a3.stamp());
+
+        auto a4 = a.as_xaxis();
+        EXPECT_EQ(&get_labels<int>(a), &get_labels<int>(a4));
+
+        auto d = axis_variant_type(axis(3));
+        auto d2 = d.as_xaxis();
+        EXPECT_TRUE(d.labels() == d2.labels());
+        EXPECT_NE(d.stamp(), d2.stamp());
+    }
+
+    template <class MT>
+    void test_axis_variant_map_tag()
+    {
+        using variant_type = xaxis_variant<XFRAME_DEFAULT_LABEL_LIST, std::size_t, MT>;
+        using int_axis_type = xaxis<int, std::size_t, MT>;
+
+        auto a = variant_type(int_axis_type({4, 1, 2}));
+        EXPECT_EQ(3u, a.size());
+        EXPECT_FALSE(a.is_sorted());
+        EXPECT_TRUE(a.contains(1));
+        EXPECT_FALSE(a.contains(3));
+        EXPECT_EQ(0u, a[4]);
+        EXPECT_EQ(1u, a[1]);
+        EXPECT_EQ(2u, a[2]);
+        EXPECT_THROW(a[3], std::out_of_range);
+
+        // The position held by the dereferenced value must not depend
+        // on the lifetime of the iterator
+        auto p = *a.find(2);
+        EXPECT_EQ(2u, p.second);
+        EXPECT_EQ(1u, (*a.find(1)).second);
+        EXPECT_EQ(a.end(), a.find(3));
+
+        auto it = a.begin();
+        auto p0 = *it;
+        auto p1 = *(++it);
+        EXPECT_EQ(0u, p0.second);
+        EXPECT_EQ(1u, p1.second);
+
+        std::size_t i = 0;
+        for (auto iter = a.cbegin(); iter != a.cend(); ++iter, ++i)
+        {
+            EXPECT_EQ(i, iter->second);
+        }
+
+        auto m = a;
+        m.merge(variant_type(int_axis_type({1, 3})));
+        EXPECT_EQ(4u, m.size());
+        EXPECT_TRUE(m.contains(3));
+        EXPECT_TRUE(m.contains(4));
+        EXPECT_EQ(3u, a.size());
+
+        auto in = a;
+        in.intersect(variant_type(int_axis_type({2, 3, 4})));
+        EXPECT_EQ(2u, in.size());
+        EXPECT_EQ(0u, in[4]);
+        EXPECT_EQ(1u, in[2]);
+        EXPECT_FALSE(in.contains(1));
+    }
+
+    TEST(xaxis_variant, sorted_vector_tag)
+    {
+        test_axis_variant_map_tag<sorted_vector_tag>();
+    }
+
+    TEST(xaxis_variant, flat_hash_map_tag)
+    {
+        test_axis_variant_map_tag<flat_hash_map_tag>();
+    }
 }
@@ -0,0 +1,162 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xbitmap.hpp"
+#include "xframe/xvariable_reducer.hpp"
+
+namespace xf
+{
+    using bitmap_data_type = xbitmap_optional_assembly<double>;
+    using bitmap_variable_type = xvariable_container<coordinate_type, bitmap_data_type>;
+
+    inline bitmap_variable_type make_bitmap_variable(const variable_type& v)
+    {
+        return bitmap_variable_type(bitmap_data_type(v.data()), v.coordinates(), v.dimension_mapping());
+    }
+
+    TEST(xbitmap, storage)
+    {
+        xbitmap_storage s(130, true);
+        EXPECT_EQ(130u, s.size());
+        EXPECT_EQ(3u, s.word_count());
+        EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(s.words()) % xbitmap_storage::alignment);
+        EXPECT_TRUE(s.all());
+
+        s[5] = false;
+        s[129] = false;
+        EXPECT_FALSE(s[5]);
+        EXPECT_TRUE(s[6]);
+        EXPECT_EQ(128u, s.count());
+
+        s.resize(200, true);
+        EXPECT_EQ(198u, s.count());
+        EXPECT_FALSE(s[129]);
+        EXPECT_TRUE(s[150]);
+
+        s.resize(10);
+        EXPECT_EQ(9u, s.count());
+        EXPECT_EQ(std::uint64_t(0x3DF), s.words()[0]);
+
+        s.fill(false);
+        EXPECT_TRUE(s.none());
+
+        xbitmap_storage s2 = { true, false, true };
+        xbitmap_storage s3 = s2;
+        EXPECT_EQ(s2, s3);
+        s3[1] = true;
+        EXPECT_NE(s2, s3);
+    }
+
+    TEST(xbitmap, iterator)
+    {
+        std::vector<bool> v(70, false);
+        v[3] = true;
+        v[69] = true;
+        xbitmap_storage s(v.cbegin(), v.cend());
+        EXPECT_EQ(2u, s.count());
+        EXPECT_EQ(70, s.cend() - s.cbegin());
+        EXPECT_TRUE(std::equal(v.cbegin(), v.cend(), s.cbegin()));
+
+        std::vector<std::uint8_t> u(70);
+        s.unpack(u.data());
+        EXPECT_EQ(1u, u[3]);
+        EXPECT_EQ(0u, u[4]);
+        EXPECT_EQ(1u, u[69]);
+
+        auto it = s.begin() + 69;
+        *it = false;
+        EXPECT_FALSE(s[69]);
+        std::fill(s.begin(), s.end(), true);
+        EXPECT_TRUE(s.all());
+    }
+
+    TEST(xbitmap, optional_assembly)
+    {
+        bitmap_data_type d = {{ 1., 2., 3. },
+                              { 4., 5., 6. }};
+        d(0, 2).has_value() = false;
+        EXPECT_FALSE(d(0, 2).has_value());
+        EXPECT_TRUE(d(1, 2).has_value());
+        EXPECT_EQ(5., d(1, 1).value());
+        EXPECT_EQ(5u, d.has_value().storage().count());
+
+        bitmap_data_type d2 = make_test_data();
+        EXPECT_EQ(make_test_data(), d2);
+    }
+
+    TEST(xbitmap, variable)
+    {
+        auto v = make_test_variable();
+        auto bv = make_bitmap_variable(v);
+
+        EXPECT_EQ(v.select({{"abscissa", "a"}, {"ordinate", 1}}), bv.select({{"abscissa", "a"}, {"ordinate", 1}}));
+        EXPECT_FALSE(bv.select({{"abscissa", "a"}, {"ordinate", 4}}).has_value());
+        EXPECT_FALSE(bv.select<join::outer>({{"abscissa", "e"}, {"ordinate", 1}}).has_value());
+        EXPECT_FALSE(bitmap_variable_type::missing().has_value());
+
+        auto res = xf::sum(bv, {"ordinate"});
+        EXPECT_EQ(3., res.select({{"abscissa", "a"}}).value());
+        EXPECT_EQ(11., res.select({{"abscissa", "c"}}).value());
+        EXPECT_EQ(24., res.select({{"abscissa", "d"}}).value());
+    }
+
+    TEST(xbitmap, assign)
+    {
+        DEFINE_TEST_VARIABLES();
+        auto ba = make_bitmap_variable(a);
+        auto bb = make_bitmap_variable(b);
+        auto bc = make_bitmap_variable(c);
+        auto bd = make_bitmap_variable(d);
+
+        {
+            SCOPED_TRACE("same coordinate");
+            bitmap_variable_type res = ba + ba * ba;
+            selector_list sl = make_selector_list_aa();
+            for (std::size_t i = 0; i < sl.size(); ++i)
+            {
+                EXPECT_EQ(res.select(sl[i]), a.select(sl[i]) + a.select(sl[i]) * a.select(sl[i]));
+            }
+        }
+
+        {
+            SCOPED_TRACE("scalar");
+            bitmap_variable_type res = ba + 2.;
+            selector_list sl = make_selector_list_aa();
+            CHECK_SCALAR2_EQUALITY(res, a, 2., sl, +)
+        }
+
+        {
+            SCOPED_TRACE("different coordinates");
+            bitmap_variable_type res = ba + bb;
+            selector_list sl = make_selector_list_ab();
+            CHECK_EQUALITY(res, a, b, sl, +)
+        }
+
+        {
+            SCOPED_TRACE("broadcasting coordinates");
+            bitmap_variable_type res = bc + bd;
+            selector_list sl = make_selector_list_cd();
+            CHECK_EQUALITY(res, c, d, sl, +)
+        }
+
+        {
+            SCOPED_TRACE("aliasing");
+            bitmap_variable_type res = ba;
+            res = res * ba;
+            selector_list sl = make_selector_list_aa();
+            CHECK_EQUALITY(res, a, a, sl, *)
+        }
+    }
+}
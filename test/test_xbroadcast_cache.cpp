@@ -0,0 +1,154 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xbroadcast_cache.hpp"
+
+namespace xf
+{
+    using broadcast_cache_type = xbroadcast_cache<coordinate_type>;
+
+    // Restores the default state of the broadcast caches
+    struct broadcast_cache_guard
+    {
+        broadcast_cache_guard()
+            : m_capacity(get_broadcast_cache_capacity())
+        {
+            clear_broadcast_cache();
+            reset_broadcast_cache_statistics();
+        }
+
+        ~broadcast_cache_guard()
+        {
+            set_broadcast_cache_capacity(m_capacity);
+            clear_broadcast_cache();
+        }
+
+        std::size_t m_capacity;
+    };
+
+    TEST(xbroadcast_cache, key)
+    {
+        auto c1 = make_test_coordinate();
+        auto c2 = make_test_coordinate3();
+
+        xbroadcast_key<fstring> k1(join::outer::id());
+        k1.append(c1);
+        k1.append(c2);
+
+        auto c3 = c1;
+        xbroadcast_key<fstring> k2(join::outer::id());
+        k2.append(c3);
+        k2.append(c2);
+        EXPECT_TRUE(k1 == k2);
+        EXPECT_EQ(k1.hash(), k2.hash());
+
+        xbroadcast_key<fstring> k3(join::inner::id());
+        k3.append(c1);
+        k3.append(c2);
+        EXPECT_FALSE(k1 == k3);
+
+        xbroadcast_key<fstring> k4(join::outer::id());
+        k4.append(c2);
+        k4.append(c1);
+        EXPECT_FALSE(k1 == k4);
+
+        auto c4 = make_test_coordinate();
+        xbroadcast_key<fstring> k5(join::outer::id());
+        k5.append(c4);
+        k5.append(c2);
+        EXPECT_FALSE(k1 == k5);
+    }
+
+    TEST(xbroadcast_cache, hit)
+    {
+        broadcast_cache_guard guard;
+        DEFINE_TEST_VARIABLES();
+
+        variable_type res = a + b;
+        auto stats = broadcast_cache_statistics();
+        EXPECT_EQ(0u, stats.m_hits);
+        EXPECT_EQ(1u, stats.m_misses);
+        EXPECT_EQ(1u, broadcast_cache_type::instance().size());
+
+        variable_type res2 = a + b;
+        stats = broadcast_cache_statistics();
+        EXPECT_EQ(1u, stats.m_hits);
+        EXPECT_EQ(1u, stats.m_misses);
+        EXPECT_EQ(res, res2);
+        EXPECT_EQ(make_intersect_coordinate(), res2.coordinates());
+
+        auto f = a + b;
+        EXPECT_EQ(make_merge_coordinate(), f.coordinates<join::outer>());
+        EXPECT_EQ(make_intersect_coordinate(), f.coordinates<join::inner>());
+        stats = broadcast_cache_statistics();
+        EXPECT_EQ(2u, stats.m_hits);
+        EXPECT_EQ(2u, stats.m_misses);
+
+        variable_type res3 = (a + b) * 2.;
+        stats = broadcast_cache_statistics();
+        EXPECT_EQ(3u, stats.m_hits);
+        EXPECT_EQ(2u, stats.m_misses);
+        EXPECT_EQ(variable_type(res * 2.), res3);
+    }
+
+    TEST(xbroadcast_cache, miss)
+    {
+        broadcast_cache_guard guard;
+        DEFINE_TEST_VARIABLES();
+
+        variable_type res = a + b;
+        auto a2 = a;
+        variable_type res2 = a2 + b;
+        EXPECT_EQ(1u, broadcast_cache_statistics().m_hits);
+
+        // Labels with the same content but a different identity
+        auto a3 = make_test_variable();
+        variable_type res3 = a3 + b;
+        auto stats = broadcast_cache_statistics();
+        EXPECT_EQ(1u, stats.m_hits);
+        EXPECT_EQ(2u, stats.m_misses);
+        EXPECT_EQ(res, res3);
+
+        variable_type res4 = a + c;
+        EXPECT_EQ(3u, broadcast_cache_statistics().m_misses);
+        EXPECT_EQ(3u, broadcast_cache_type::instance().size());
+    }
+
+    TEST(xbroadcast_cache, capacity)
+    {
+        broadcast_cache_guard guard;
+        DEFINE_TEST_VARIABLES();
+
+        set_broadcast_cache_capacity(1);
+        variable_type res = a + b;
+        variable_type res2 = a + c;
+        auto stats = broadcast_cache_statistics();
+        EXPECT_EQ(2u, stats.m_misses);
+        EXPECT_EQ(1u, stats.m_evictions);
+        EXPECT_EQ(1u, broadcast_cache_type::instance().size());
+
+        variable_type res3 = a + b;
+        EXPECT_EQ(3u, broadcast_cache_statistics().m_misses);
+        EXPECT_EQ(res, res3);
+
+        set_broadcast_cache_capacity(0);
+        variable_type res4 = a + b;
+        stats = broadcast_cache_statistics();
+        EXPECT_EQ(0u, stats.m_hits);
+        EXPECT_EQ(3u, stats.m_misses);
+        EXPECT_EQ(res, res4);
+
+        set_broadcast_cache_capacity(4);
+        clear_broadcast_cache();
+        EXPECT_EQ(0u, broadcast_cache_type::instance().size());
+    }
+}
@@ -13,7 +13,7 @@
 
 namespace xf
 {
-    using slabel_type = std::vector<fstring>;
+    using slabel_type = std::vector<XFRAME_STRING_LABEL>;
     using ilabel_type = std::vector<int>;
 
     TEST(xcoordinate, constructor)
@@ -70,9 +70,9 @@ namespace xf
         EXPECT_EQ(c["ordinate"][2], 1u);
         EXPECT_EQ(c["ordinate"][4], 2u);
 
-        EXPECT_EQ(c[std::make_pair("abscissa", fstring("a"))], 0u);
-        EXPECT_EQ(c[std::make_pair("abscissa", fstring("c"))], 1u);
-        EXPECT_EQ(c[std::make_pair("abscissa", fstring("d"))], 2u);
+        EXPECT_EQ(c[std::make_pair("abscissa", XFRAME_STRING_LABEL("a"))], 0u);
+        EXPECT_EQ(c[std::make_pair("abscissa", XFRAME_STRING_LABEL("c"))], 1u);
+        EXPECT_EQ(c[std::make_pair("abscissa", XFRAME_STRING_LABEL("d"))], 2u);
         EXPECT_EQ(c[std::make_pair("ordinate", 1)], 0u);
         EXPECT_EQ(c[std::make_pair("ordinate", 2)], 1u);
         EXPECT_EQ(c[std::make_pair("ordinate", 4)], 2u);
@@ -141,6 +141,20 @@ namespace xf
         EXPECT_EQ(cres1, cres2);
     }
 
+    TEST(xcoordinate, merge_axis_range)
+    {
+        using range_type = xaxis_arange<int, std::size_t>;
+        coordinate_type c1 = {{"abscissa", make_test_saxis()}, {"ordinate", range_type(0, 2, 4)}};
+        coordinate_type c2 = {{"abscissa", make_test_saxis()}, {"ordinate", range_type(8, 2, 2)}};
+        coordinate_type coord_res = {{"abscissa", make_test_saxis()}, {"ordinate", range_type(0, 2, 6)}};
+
+        decltype(c1) cres;
+        auto res = broadcast_coordinates<join::outer>(cres, c1, c2);
+        EXPECT_TRUE(res.m_same_dimensions);
+        EXPECT_FALSE(res.m_same_labels);
+        EXPECT_EQ(cres, coord_res);
+    }
+
     TEST(xcoordinate, intersect)
     {
         auto c1 = make_test_coordinate();
@@ -170,4 +184,79 @@ namespace xf
         broadcast_coordinates<join::inner>(cres2, c2, c1);
         EXPECT_EQ(cres2, coord_res);
     }
+
+    TEST(xcoordinate, intersect_axis_range)
+    {
+        using range_type = xaxis_arange<int, std::size_t>;
+        coordinate_type c1 = {{"abscissa", make_test_saxis()}, {"ordinate", range_type(0, 2, 6)}};
+        coordinate_type c2 = {{"abscissa", make_test_saxis()}, {"ordinate", range_type(4, 2, 6)}};
+        coordinate_type coord_res = {{"abscissa", make_test_saxis()}, {"ordinate", range_type(4, 2, 4)}};
+
+        decltype(c1) cres;
+        auto res = broadcast_coordinates<join::inner>(cres, c1, c2);
+        EXPECT_TRUE(res.m_same_dimensions);
+        EXPECT_FALSE(res.m_same_labels);
+        EXPECT_EQ(cres, coord_res);
+    }
+
+    TEST(xcoordinate, shared_axes)
+    {
+        auto c1 = make_test_coordinate();
+        auto c2 = c1;
+        EXPECT_EQ(&get_labels<XFRAME_STRING_LABEL>(c1["abscissa"]), &get_labels<XFRAME_STRING_LABEL>(c2["abscissa"]));
+        EXPECT_EQ(c1, c2);
+
+        auto c3 = make_test_coordinate3();
+        decltype(c1) cres;
+        broadcast_coordinates<join::outer>(cres, c1, c3);
+        EXPECT_EQ(make_test_coordinate(), c1);
+        EXPECT_EQ(make_test_coordinate3(), c3);
+        EXPECT_NE(&get_labels<XFRAME_STRING_LABEL>(c1["abscissa"]), &get_labels<XFRAME_STRING_LABEL>(cres["abscissa"]));
+        EXPECT_EQ(&get_labels<int>(c3["altitude"]), &get_labels<int>(cres["altitude"]));
+    }
+
+    template <class MT>
+    void test_coordinate_map_tag()
+    {
+        using tag_coordinate_type = xcoordinate<fstring, XFRAME_DEFAULT_LABEL_LIST, std::size_t, MT>;
+        using tag_saxis_type = xaxis<XFRAME_STRING_LABEL, std::size_t, MT>;
+        using tag_iaxis_type = xaxis<int, std::size_t, MT>;
+
+        tag_coordinate_type c1 = {{"abscissa", tag_saxis_type({"a", "c", "d"})}, {"ordinate", tag_iaxis_type({1, 2, 4})}};
+        tag_coordinate_type c2 = {{"abscissa", tag_saxis_type({"a", "d", "e"})}, {"ordinate", tag_iaxis_type({1, 4, 5})}};
+
+        EXPECT_TRUE(c1.contains("abscissa"));
+        EXPECT_EQ(2u, c1["abscissa"]["d"]);
+        EXPECT_EQ(1u, c1["ordinate"][2]);
+        EXPECT_EQ(2u, (*c1["ordinate"].find(4)).second);
+        EXPECT_THROW(c1["ordinate"][3], std::out_of_range);
+
+        tag_coordinate_type outer_res = {{"abscissa", tag_saxis_type({"a", "c", "d", "e"})},
+                                         {"ordinate", tag_iaxis_type({1, 2, 4, 5})}};
+        tag_coordinate_type cres1;
+        auto res1 = broadcast_coordinates<join::outer>(cres1, c1, c2);
+        EXPECT_TRUE(res1.m_same_dimensions);
+        EXPECT_FALSE(res1.m_same_labels);
+        EXPECT_EQ(outer_res, cres1);
+        EXPECT_EQ(3u, cres1["abscissa"]["e"]);
+
+        tag_coordinate_type inner_res = {{"abscissa", tag_saxis_type({"a", "d"})},
+                                         {"ordinate", tag_iaxis_type({1, 4})}};
+        auto cres2 = c1;
+        auto res2 = broadcast_coordinates<join::inner>(cres2, c2);
+        EXPECT_TRUE(res2.m_same_dimensions);
+        EXPECT_FALSE(res2.m_same_labels);
+        EXPECT_EQ(inner_res, cres2);
+        EXPECT_EQ(1u, cres2["ordinate"][4]);
+    }
+
+    TEST(xcoordinate, sorted_vector_tag)
+    {
+        test_coordinate_map_tag<sorted_vector_tag>();
+    }
+
+    TEST(xcoordinate, flat_hash_map_tag)
+    {
+        test_coordinate_map_tag<flat_hash_map_tag>();
+    }
 }
@@ -0,0 +1,147 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xcsv.hpp"
+
+namespace xf
+{
+    class csv_file
+    {
+    public:
+
+        csv_file(const std::string& name, const std::string& content)
+            : m_name(name)
+        {
+            std::ofstream out(m_name, std::ios::binary);
+            out << content;
+        }
+
+        ~csv_file()
+        {
+            std::remove(m_name.c_str());
+        }
+
+        const std::string& name() const { return m_name; }
+
+    private:
+
+        std::string m_name;
+    };
+
+    TEST(xcsv, read_csv)
+    {
+        csv_file f("xframe_test_long.csv",
+                   "city,year,population\n"
+                   "Paris,2019,2.15\n"
+                   "London,2019,8.9\r\n"
+                   "Paris,2020,\n"
+                   "\n"
+                   "London,2020,9\n"
+                   "Berlin,2019, 3.6 \n");
+
+        auto v = read_csv(f.name(), {"city", "year"}, "population");
+        EXPECT_EQ(dimension_type({"city", "year"}), v.dimension_mapping());
+        EXPECT_EQ(std::vector<XFRAME_STRING_LABEL>({"Paris", "London", "Berlin"}), get_labels<XFRAME_STRING_LABEL>(v.coordinates()["city"]));
+        EXPECT_EQ(std::vector<int>({2019, 2020}), get_labels<int>(v.coordinates()["year"]));
+
+        EXPECT_EQ(2.15, v.select({{"city", "Paris"}, {"year", 2019}}).value());
+        EXPECT_EQ(8.9, v.select({{"city", "London"}, {"year", 2019}}).value());
+        EXPECT_EQ(9., v.select({{"city", "London"}, {"year", 2020}}).value());
+        EXPECT_EQ(3.6, v.select({{"city", "Berlin"}, {"year", 2019}}).value());
+        EXPECT_FALSE(v.select({{"city", "Paris"}, {"year", 2020}}).has_value());
+        EXPECT_FALSE(v.select({{"city", "Berlin"}, {"year", 2020}}).has_value());
+
+        auto v2 = read_csv(f.name(), {"year", "city"}, "population");
+        EXPECT_EQ(dimension_type({"year", "city"}), v2.dimension_mapping());
+        EXPECT_EQ(9., v2.select({{"city", "London"}, {"year", 2020}}).value());
+
+        csv_file f2("xframe_test_long_int.csv", "x,value\n1,-3\n2,+4\n3,NaN\n");
+        auto vi = read_csv<int>(f2.name(), {"x"}, "value");
+        EXPECT_EQ(-3, vi.select({{"x", 1}}).value());
+        EXPECT_EQ(4, vi.select({{"x", 2}}).value());
+        EXPECT_FALSE(vi.select({{"x", 3}}).has_value());
+    }
+
+    TEST(xcsv, read_wide_csv)
+    {
+        csv_file f("xframe_test_wide.csv",
+                   "AAPL;date;MSFT\n"
+                   "10.5;1;20\n"
+                   "11;2;NA\n"
+                   "12;4;22.25\n");
+
+        auto v = read_wide_csv(f.name(), {"date"}, "ticker", ';');
+        EXPECT_EQ(dimension_type({"date", "ticker"}), v.dimension_mapping());
+        EXPECT_EQ(std::vector<int>({1, 2, 4}), get_labels<int>(v.coordinates()["date"]));
+        EXPECT_EQ(std::vector<XFRAME_STRING_LABEL>({"AAPL", "MSFT"}), get_labels<XFRAME_STRING_LABEL>(v.coordinates()["ticker"]));
+
+        EXPECT_EQ(10.5, v.select({{"date", 1}, {"ticker", "AAPL"}}).value());
+        EXPECT_EQ(20., v.select({{"date", 1}, {"ticker", "MSFT"}}).value());
+        EXPECT_FALSE(v.select({{"date", 2}, {"ticker", "MSFT"}}).has_value());
+        EXPECT_EQ(22.25, v.select({{"date", 4}, {"ticker", "MSFT"}}).value());
+    }
+
+    TEST(xcsv, parallel)
+    {
+        std::size_t n = 100000, m = 4;
+        std::string content = "id,a,b,c,d\n";
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            content += std::to_string(i);
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                content += (i + j) % 13 == 0 ? std::string(",") : "," + std::to_string(i * m + j) + ".25";
+            }
+            content += "\n";
+        }
+        csv_file f("xframe_test_parallel.csv", content);
+
+        auto v = read_wide_csv(f.name(), {"id"}, "column");
+        ASSERT_EQ(n, v.shape()[0]);
+        ASSERT_EQ(m, v.shape()[1]);
+        for (std::size_t i = 0; i < n; i += 7)
+        {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                bool has_value = (i + j) % 13 != 0;
+                EXPECT_EQ(has_value, v.data()(i, j).has_value());
+                if (has_value)
+                {
+                    EXPECT_EQ(static_cast<double>(i * m + j) + 0.25, v.data()(i, j).value());
+                }
+            }
+        }
+
+        xnum_threads_scope scope(4);
+        EXPECT_EQ(v, read_wide_csv(f.name(), {"id"}, "column"));
+    }
+
+    TEST(xcsv, errors)
+    {
+        csv_file f("xframe_test_errors.csv",
+                   "city,year,population\n"
+                   "Paris,2019,2.15\n"
+                   "Paris,2019,2.2\n");
+        csv_file f2("xframe_test_errors2.csv",
+                    "city,year,population\n"
+                    "Paris,2019,abc\n");
+
+        EXPECT_THROW(read_csv("xframe_missing_file.csv", {"city"}, "population"), std::runtime_error);
+        EXPECT_THROW(read_csv(f.name(), {"country"}, "population"), std::out_of_range);
+        EXPECT_THROW(read_csv(f.name(), {"city", "year"}, "year"), std::runtime_error);
+        EXPECT_THROW(read_csv(f.name(), {"city", "year"}, "population"), std::runtime_error);
+        EXPECT_THROW(read_csv(f2.name(), {"city", "year"}, "population"), std::runtime_error);
+    }
+}
@@ -0,0 +1,126 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <string>
+#include "gtest/gtest.h"
+#include "xframe/xflat_hash_map.hpp"
+
+namespace xf
+{
+    using map_type = xflat_hash_map<std::string, std::size_t>;
+
+    TEST(xflat_hash_map, constructor)
+    {
+        map_type m;
+        EXPECT_TRUE(m.empty());
+        EXPECT_EQ(m.size(), 0u);
+        EXPECT_EQ(m.bucket_count(), 0u);
+        EXPECT_EQ(m.find("a"), nullptr);
+    }
+
+    TEST(xflat_hash_map, insert)
+    {
+        map_type m;
+        EXPECT_TRUE(m.insert("a", 0u).second);
+        EXPECT_TRUE(m.insert("b", 1u).second);
+        auto res = m.insert("a", 2u);
+        EXPECT_FALSE(res.second);
+        EXPECT_EQ(*(res.first), 0u);
+        EXPECT_EQ(res.first, m.find("a"));
+        EXPECT_EQ(m.size(), 2u);
+        EXPECT_EQ(m.at("a"), 0u);
+        EXPECT_EQ(m.at("b"), 1u);
+        EXPECT_EQ(m.count("a"), 1u);
+        EXPECT_EQ(m.count("c"), 0u);
+        EXPECT_THROW(m.at("c"), std::out_of_range);
+    }
+
+    TEST(xflat_hash_map, access)
+    {
+        map_type m;
+        m["a"] = 2u;
+        m["a"] = 3u;
+        m["b"];
+        EXPECT_EQ(m.size(), 2u);
+        EXPECT_EQ(*(m.find("a")), 3u);
+        EXPECT_EQ(*(m.find("b")), 0u);
+    }
+
+    TEST(xflat_hash_map, reserve)
+    {
+        map_type m;
+        m.reserve(1000u);
+        std::size_t bucket_count = m.bucket_count();
+        EXPECT_GE(bucket_count, 1000u);
+        for (std::size_t i = 0; i < 1000u; ++i)
+        {
+            m[std::to_string(i)] = i;
+        }
+        EXPECT_EQ(m.bucket_count(), bucket_count);
+        EXPECT_EQ(m.size(), 1000u);
+        for (std::size_t i = 0; i < 1000u; ++i)
+        {
+            EXPECT_EQ(m.at(std::to_string(i)), i);
+        }
+    }
+
+    TEST(xflat_hash_map, rehash)
+    {
+        xflat_hash_map<int, int> m;
+        for (int i = 0; i < 10000; ++i)
+        {
+            m[i * 1024] = i;
+        }
+        EXPECT_EQ(m.size(), 10000u);
+        for (int i = 0; i < 10000; ++i)
+        {
+            EXPECT_EQ(m.at(i * 1024), i);
+        }
+        EXPECT_EQ(m.find(1), nullptr);
+    }
+
+    struct constant_hash
+    {
+        std::size_t operator()(int) const noexcept
+        {
+            return 0u;
+        }
+    };
+
+    TEST(xflat_hash_map, degenerate_hash)
+    {
+        xflat_hash_map<int, int, constant_hash> m;
+        for (int i = 0; i < 2000; ++i)
+        {
+            m[i] = 2 * i;
+        }
+        EXPECT_EQ(m.size(), 2000u);
+        EXPECT_LE(m.bucket_count(), 4096u);
+        for (int i = 0; i < 2000; ++i)
+        {
+            EXPECT_EQ(m.at(i), 2 * i);
+        }
+        EXPECT_EQ(m.find(-1), nullptr);
+        EXPECT_EQ(m.find(2000), nullptr);
+    }
+
+    TEST(xflat_hash_map, clear)
+    {
+        map_type m;
+        m["a"] = 0u;
+        m["b"] = 1u;
+        std::size_t bucket_count = m.bucket_count();
+        m.clear();
+        EXPECT_TRUE(m.empty());
+        EXPECT_EQ(m.bucket_count(), bucket_count);
+        EXPECT_EQ(m.find("a"), nullptr);
+    }
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <sstream>
+#include <string>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xbroadcast_cache.hpp"
+#include "xframe/xframe_trace.hpp"
+#include "xframe/xreindex_view.hpp"
+
+namespace xf
+{
+    // Enables a clean trace and disables the broadcast cache, so that
+    // every assignment broadcasts the coordinates of its operands
+    struct trace_guard
+    {
+        trace_guard()
+            : m_capacity(get_broadcast_cache_capacity())
+        {
+            set_broadcast_cache_capacity(0);
+            reset_trace();
+            set_trace_enabled(true);
+        }
+
+        ~trace_guard()
+        {
+            set_trace_enabled(false);
+            reset_trace();
+            set_broadcast_cache_capacity(m_capacity);
+        }
+
+        std::size_t m_capacity;
+    };
+
+    TEST(xframe_trace, disabled)
+    {
+        reset_trace();
+        EXPECT_FALSE(is_trace_enabled());
+        DEFINE_TEST_VARIABLES();
+        variable_type res = a + b;
+        auto snapshot = trace_snapshot();
+        EXPECT_EQ(0u, snapshot[trace_event::resize].m_count);
+        EXPECT_EQ(0u, snapshot[trace_event::populate_index].m_count);
+        EXPECT_EQ(0u, snapshot.m_non_trivial_broadcasts);
+    }
+
+    TEST(xframe_trace, timers)
+    {
+        DEFINE_TEST_VARIABLES();
+        trace_guard guard;
+
+        variable_type res = a + a;
+        auto snapshot = trace_snapshot();
+        EXPECT_EQ(1u, snapshot[trace_event::resize].m_count);
+        // One broadcast per operand, dimensions are not broadcast
+        EXPECT_EQ(2u, snapshot[trace_event::broadcast_coordinates].m_count);
+        EXPECT_EQ(0u, snapshot[trace_event::broadcast_dimensions].m_count);
+        EXPECT_EQ(0u, snapshot[trace_event::assign_data].m_count);
+        EXPECT_LE(snapshot[trace_event::resize].m_max_ns, snapshot[trace_event::resize].m_total_ns);
+        EXPECT_EQ(1u, snapshot.m_trivial_broadcasts);
+        EXPECT_EQ(0u, snapshot.m_non_trivial_broadcasts);
+        // Values and flags are stored in separate buffers
+        EXPECT_EQ(res.data().size() * (sizeof(double) + sizeof(bool)), snapshot.m_allocated_bytes);
+
+        res = a + b;
+        snapshot = trace_snapshot();
+        EXPECT_EQ(2u, snapshot[trace_event::resize].m_count);
+        EXPECT_EQ(1u, snapshot[trace_event::assign_data].m_count);
+        EXPECT_EQ(1u, snapshot.m_non_trivial_broadcasts);
+        EXPECT_LT(0u, snapshot[trace_event::populate_index].m_count);
+
+        res = c + d;
+        EXPECT_LT(0u, trace_snapshot()[trace_event::broadcast_dimensions].m_count);
+
+        // Building the view does not gather anything, assigning it does
+        auto view = reindex(a, {{"abscissa", xf::axis({"a", "b", "c", "d"})}});
+        EXPECT_EQ(0u, trace_snapshot()[trace_event::reindex].m_count);
+        variable_type reindexed = view;
+        EXPECT_EQ(1u, trace_snapshot()[trace_event::reindex].m_count);
+
+        reset_trace();
+        snapshot = trace_snapshot();
+        EXPECT_EQ(0u, snapshot[trace_event::resize].m_count);
+        EXPECT_EQ(0u, snapshot.m_allocated_bytes);
+    }
+
+    TEST(xframe_trace, chrome_trace)
+    {
+        DEFINE_TEST_VARIABLES();
+        trace_guard guard;
+
+        variable_type res = a + b;
+        std::ostringstream out;
+        write_chrome_trace(out);
+        std::string trace = out.str();
+        EXPECT_EQ(0u, trace.find("{\"traceEvents\":["));
+        EXPECT_NE(std::string::npos, trace.find("{\"name\":\"resize\",\"cat\":\"xframe\",\"ph\":\"X\""));
+        EXPECT_NE(std::string::npos, trace.find("{\"name\":\"assign_data\""));
+        EXPECT_NE(std::string::npos, trace.find("\"args\":{\"trivial\":0,\"non_trivial\":1}"));
+        EXPECT_EQ(0u, trace_snapshot().m_dropped_events);
+    }
+}
@@ -0,0 +1,145 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <numeric>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xgroupby.hpp"
+
+namespace xf
+{
+    using key_data_type = xt::xoptional_assembly<xt::xarray<fstring>, xt::xarray<bool>>;
+    using key_variable_type = xvariable_container<coordinate_type, key_data_type>;
+
+    // abscissa: { "a", "c", "d" }
+    // keys: { "x", "y", "x" }
+    inline key_variable_type make_test_key_variable()
+    {
+        key_data_type d = xt::xarray<fstring>({"x", "y", "x"});
+        return key_variable_type(d, coordinate_type({{"abscissa", make_test_saxis()}}), dimension_type({"abscissa"}));
+    }
+
+    TEST(xgroupby, axis_keys)
+    {
+        auto v = make_test_variable();
+
+        auto g = groupby(v, "ordinate", v.axis<int>("ordinate") % 2);
+        EXPECT_EQ(2u, g.size());
+        EXPECT_EQ(iaxis_type({0, 1}), g.groups());
+
+        auto res = g.sum();
+        EXPECT_EQ(v.dimension_labels(), res.dimension_labels());
+        EXPECT_EQ(v.coordinates()["abscissa"], res.coordinates()["abscissa"]);
+        EXPECT_EQ(2., res.select({{"abscissa", "a"}, {"ordinate", 0}}).value());
+        EXPECT_EQ(1., res.select({{"abscissa", "a"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(11., res.select({{"abscissa", "c"}, {"ordinate", 0}}).value());
+        EXPECT_EQ(0., res.select({{"abscissa", "c"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(17., res.select({{"abscissa", "d"}, {"ordinate", 0}}).value());
+        EXPECT_EQ(7., res.select({{"abscissa", "d"}, {"ordinate", 1}}).value());
+
+        auto g2 = groupby(v, "ordinate", v.axis<int>("ordinate") % 2, group_order::first_seen);
+        EXPECT_EQ(iaxis_type({1, 0}), g2.groups());
+        auto res2 = g2.sum();
+        EXPECT_EQ(1., res2.data()(0, 0).value());
+        EXPECT_EQ(2., res2.data()(0, 1).value());
+    }
+
+    TEST(xgroupby, variable_keys)
+    {
+        auto v = make_test_variable();
+        auto keys = make_test_key_variable();
+
+        auto g = groupby(v, "abscissa", keys);
+        EXPECT_EQ(saxis_type({"x", "y"}), g.groups());
+
+        auto res = g.sum();
+        EXPECT_EQ(8., res.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(10., res.select({{"abscissa", "x"}, {"ordinate", 2}}).value());
+        EXPECT_EQ(9., res.select({{"abscissa", "x"}, {"ordinate", 4}}).value());
+        EXPECT_EQ(0., res.select({{"abscissa", "y"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(5., res.select({{"abscissa", "y"}, {"ordinate", 2}}).value());
+
+        auto res2 = g.sum(false);
+        EXPECT_TRUE(res2.select({{"abscissa", "x"}, {"ordinate", 1}}).has_value());
+        EXPECT_FALSE(res2.select({{"abscissa", "x"}, {"ordinate", 4}}).has_value());
+        EXPECT_FALSE(res2.select({{"abscissa", "y"}, {"ordinate", 1}}).has_value());
+
+        keys.data()(1).has_value() = false;
+        auto res3 = groupby(v, "abscissa", keys).sum();
+        EXPECT_EQ(1u, res3.coordinates()["abscissa"].size());
+        EXPECT_EQ(8., res3.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+    }
+
+    TEST(xgroupby, aggregations)
+    {
+        auto v = make_test_variable();
+        auto g = groupby(v, "abscissa", make_test_key_variable());
+
+        auto mean = g.mean();
+        EXPECT_EQ(4., mean.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(9., mean.select({{"abscissa", "x"}, {"ordinate", 4}}).value());
+        EXPECT_FALSE(mean.select({{"abscissa", "y"}, {"ordinate", 1}}).has_value());
+
+        auto min = g.amin();
+        auto max = g.amax();
+        EXPECT_EQ(1., min.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(7., max.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+
+        auto count = g.count();
+        EXPECT_EQ(2u, count.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(1u, count.select({{"abscissa", "x"}, {"ordinate", 4}}).value());
+        EXPECT_EQ(0u, count.select({{"abscissa", "y"}, {"ordinate", 1}}).value());
+
+        auto first = g.first();
+        auto last = g.last();
+        EXPECT_EQ(1., first.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(9., first.select({{"abscissa", "x"}, {"ordinate", 4}}).value());
+        EXPECT_EQ(7., last.select({{"abscissa", "x"}, {"ordinate", 1}}).value());
+        EXPECT_FALSE(last.select({{"abscissa", "y"}, {"ordinate", 1}}).has_value());
+        EXPECT_FALSE(g.first(false).select({{"abscissa", "x"}, {"ordinate", 4}}).has_value());
+    }
+
+    TEST(xgroupby, parallel)
+    {
+        std::size_t n = std::size_t(1) << 17;
+        std::vector<int> labels(n);
+        std::iota(labels.begin(), labels.end(), 0);
+        xt::xarray<double> values = xt::xarray<double>::from_shape({n});
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape({n});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            values(i) = static_cast<double>(i);
+            flags(i) = i % 5 != 0;
+        }
+        variable_type v(data_type(values, flags), coordinate_type({{"x", iaxis_type(labels)}}), dimension_type({"x"}));
+
+        auto g = groupby(v, "x", v.axis<int>("x") % 7);
+        auto sum = g.sum();
+        auto first = g.first();
+        auto last = g.last();
+        EXPECT_EQ(7., first.select({{"x", 0}}).value());
+
+        xnum_threads_scope scope(4);
+        EXPECT_EQ(sum, g.sum());
+        EXPECT_EQ(first, g.first());
+        EXPECT_EQ(last, g.last());
+    }
+
+    TEST(xgroupby, errors)
+    {
+        auto v = make_test_variable();
+        EXPECT_THROW(groupby(v, "altitude", v.axis<int>("ordinate")), std::out_of_range);
+        EXPECT_THROW(groupby(v, "abscissa", v.axis<int>("ordinate")), std::runtime_error);
+
+        key_data_type d = xt::xarray<fstring>({"x", "y", "x"});
+        key_variable_type keys(d, coordinate_type({{"abscissa", make_test_saxis2()}}), dimension_type({"abscissa"}));
+        EXPECT_THROW(groupby(v, "abscissa", keys), std::runtime_error);
+    }
+}
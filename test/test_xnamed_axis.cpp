@@ -32,4 +32,16 @@ namespace xf
         auto n_a = named_axis("axis_a", a);
         EXPECT_EQ("axis_a", n_a.name());
     }
+
+    TEST(xnamed_axis, label)
+    {
+        auto n_a = named_axis("axis_a", axis(56));
+        EXPECT_EQ(3, n_a.label(3));
+
+        using axis_variant_type = xaxis_variant<XFRAME_DEFAULT_LABEL_LIST, std::size_t>;
+        using named_range_type = xnamed_axis<const char*, std::size_t, hash_map_tag, XFRAME_DEFAULT_LABEL_LIST, int>;
+        named_range_type n_r("axis_r", axis_variant_type(range_axis(10, 30, 5)));
+        EXPECT_EQ(10, n_r.label(0));
+        EXPECT_EQ(20, n_r.label(2));
+    }
 }
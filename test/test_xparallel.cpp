@@ -0,0 +1,95 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xbitmap.hpp"
+#include "xframe/xparallel.hpp"
+
+namespace xf
+{
+    TEST(xparallel, num_threads)
+    {
+        std::size_t n = get_num_threads();
+        set_num_threads(3);
+        EXPECT_EQ(3u, get_num_threads());
+        {
+            xnum_threads_scope scope(5);
+            EXPECT_EQ(5u, get_num_threads());
+        }
+        EXPECT_EQ(3u, get_num_threads());
+        set_num_threads(n);
+    }
+
+    TEST(xparallel, parallel_for_rows)
+    {
+        xnum_threads_scope scope(4);
+        std::vector<int> count(1000 * 100, 0);
+        std::atomic<std::size_t> nb_blocks(0);
+        detail::parallel_for_rows(1000, 100, 64, [&count, &nb_blocks](std::size_t begin, std::size_t end)
+        {
+            EXPECT_EQ(0u, (begin * 100) % 64);
+            for (std::size_t i = begin * 100; i < end * 100; ++i)
+            {
+                ++count[i];
+            }
+            ++nb_blocks;
+        });
+        EXPECT_EQ(3u, nb_blocks.load());
+        EXPECT_TRUE(std::all_of(count.cbegin(), count.cend(), [](int c) { return c == 1; }));
+
+        EXPECT_THROW(detail::parallel_for_rows(1000, 100, 1, [](std::size_t begin, std::size_t) {
+            if (begin != 0)
+            {
+                throw std::runtime_error("block");
+            }
+        }), std::runtime_error);
+    }
+
+    TEST(xparallel, assign)
+    {
+        auto a = make_test_grid_variable(300, 400);
+        auto b = make_test_grid_variable(300, 400, 50, 100);
+
+        variable_type same_labels = a * a + 2.;
+        variable_type different_labels = a + b;
+        {
+            xnum_threads_scope scope(4);
+            variable_type res = a * a + 2.;
+            EXPECT_EQ(same_labels, res);
+            res = a + b;
+            EXPECT_EQ(different_labels, res);
+            res += a;
+            EXPECT_EQ(variable_type(different_labels + a), res);
+        }
+    }
+
+    TEST(xparallel, assign_bitmap)
+    {
+        using bitmap_variable_type = xvariable_container<coordinate_type, xbitmap_optional_assembly<double>>;
+        auto a = make_test_grid_variable<bitmap_variable_type>(300, 400);
+        auto b = make_test_grid_variable<bitmap_variable_type>(300, 400, 50, 100);
+
+        bitmap_variable_type same_labels = a * a;
+        bitmap_variable_type different_labels = a - b;
+        {
+            xnum_threads_scope scope(4);
+            bitmap_variable_type res = a * a;
+            EXPECT_EQ(same_labels, res);
+            res = a - b;
+            EXPECT_EQ(different_labels, res);
+        }
+    }
+}
@@ -271,6 +271,40 @@ namespace xf
         EXPECT_EQ(mis, view.missing());
     }
 
+    TEST(xreindex_view, prepared_select)
+    {
+        auto var = make_test_variable();
+        coordinate_map new_coord = make_new_coordinate();
+        auto view = reindex(var, new_coord);
+        auto selector = view.prepare_selector({"abscissa", "ordinate"});
+
+        EXPECT_EQ(view.select(selector, {"a", 1}), view(0, 0));
+        EXPECT_EQ(view.select(selector, {"b", 2}), view(1, 1));
+        EXPECT_EQ(view.select(selector, {"b", 2}), view.missing());
+        EXPECT_EQ(view.select(selector, {"d", 4}), view(3, 2));
+        EXPECT_ANY_THROW(view.select(selector, {"e", 1}));
+
+        EXPECT_EQ(view.select<join::outer>(selector, {"c", 1}), view(2, 0));
+        EXPECT_EQ(view.select<join::outer>(selector, {"e", 1}), view.missing());
+    }
+
+    TEST(xreindex_view, select_batch)
+    {
+        auto var = make_test_variable();
+        coordinate_map new_coord = make_new_coordinate();
+        auto view = reindex(var, new_coord);
+
+        auto res = view.select_batch({"abscissa", "ordinate"}, {{"d", "b", "a"}, {4, 2, 1}});
+        ASSERT_EQ(3u, res.size());
+        EXPECT_EQ(res(0), view(3, 2));
+        EXPECT_EQ(res(1), view.missing());
+        EXPECT_EQ(res(2), view(0, 0));
+
+        EXPECT_ANY_THROW(view.select_batch({"abscissa", "ordinate"}, {{"e"}, {1}}));
+        auto res2 = view.select_batch<join::outer>({"abscissa", "ordinate"}, {{"e"}, {1}});
+        EXPECT_EQ(res2(0), view.missing());
+    }
+
     TEST(xreindex_view, iselect)
     {
         auto var = make_test_variable();
@@ -325,4 +359,148 @@ namespace xf
         EXPECT_EQ(std::get<0>(res).data(), exp0);
         EXPECT_EQ(std::get<1>(res).data(), exp1);
     }
+
+    TEST(xreindex_view, gather_index)
+    {
+        auto var = make_test_variable();
+        coordinate_map new_coord = make_new_coordinate();
+        auto view = reindex(var, new_coord);
+
+        std::vector<std::int64_t> exp0 = {0, -1, 1, 2};
+        std::vector<std::int64_t> exp1 = {0, 1, 2};
+        EXPECT_EQ(view.gather_index(0), exp0);
+        EXPECT_EQ(view.gather_index(1), exp1);
+    }
+
+    TEST(xreindex_view, assign)
+    {
+        auto missing = xtl::missing<double>();
+        auto var = make_test_variable();
+        coordinate_map new_coord = make_new_coordinate();
+        auto view = reindex(var, new_coord);
+
+        variable_type res = view;
+        data_type exp = {{1., 2., missing}, {missing, missing, missing}, {missing, 5., 6.}, {7., 8., 9.}};
+        EXPECT_TRUE(view.coordinates() == res.coordinates());
+        EXPECT_EQ(res.data(), exp);
+
+        data_type d = view.data();
+        EXPECT_EQ(d, exp);
+    }
+
+    TEST(xreindex_view, assign_inner_dimensions)
+    {
+        auto var = make_test_variable2();
+        auto view = reindex(var, {{"ordinate", iaxis_type({5, 2, 1})}, {"altitude", iaxis_type({4, 3, 2, 1})}});
+
+        variable_type res = view;
+        EXPECT_TRUE(view.coordinates() == res.coordinates());
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                for (std::size_t k = 0; k < 4; ++k)
+                {
+                    EXPECT_EQ(res(i, j, k), view(i, j, k));
+                }
+            }
+        }
+        EXPECT_EQ(res(0, 1, 0), view.missing());
+        EXPECT_EQ(res(0, 0, 1), view.missing());
+        EXPECT_EQ(res(2, 2, 3), var(2, 0, 0));
+
+        data_type d = view.data();
+        EXPECT_EQ(d, res.data());
+    }
+
+    TEST(xreindex_view, fill_method)
+    {
+        auto var = make_test_variable();
+        coordinate_map new_coord;
+        new_coord["ordinate"] = iaxis_type({0, 1, 3, 6});
+
+        auto none = reindex(var, new_coord);
+        std::vector<std::int64_t> exp_none = {-1, 0, -1, -1};
+        EXPECT_EQ(none.gather_index(1), exp_none);
+
+        auto pad = reindex(var, new_coord, fill_method::pad);
+        std::vector<std::int64_t> exp_pad = {-1, 0, 1, 2};
+        EXPECT_EQ(pad.gather_index(1), exp_pad);
+
+        auto backfill = reindex(var, new_coord, fill_method::backfill);
+        std::vector<std::int64_t> exp_backfill = {0, 0, 2, -1};
+        EXPECT_EQ(backfill.gather_index(1), exp_backfill);
+
+        auto nearest = reindex(var, new_coord, fill_method::nearest);
+        std::vector<std::int64_t> exp_nearest = {0, 0, 2, 2};
+        EXPECT_EQ(nearest.gather_index(1), exp_nearest);
+
+        auto tolerance = reindex(var, new_coord, fill_method::nearest, 1.);
+        std::vector<std::int64_t> exp_tolerance = {0, 0, 2, -1};
+        EXPECT_EQ(tolerance.gather_index(1), exp_tolerance);
+    }
+
+    TEST(xreindex_view, fill_method_large_labels)
+    {
+        // Labels around 1.7e18 are 256 apart once converted to double
+        using taxis_type = xaxis<long long, std::size_t>;
+        using tcoordinate_type = xcoordinate<fstring, xtl::mpl::vector<long long>>;
+        using tvariable_type = xvariable_container<tcoordinate_type, data_type>;
+
+        const long long t0 = 1700000000000000000LL;
+        data_type d = {1., 2.};
+        tcoordinate_type c = {{"time", taxis_type({t0, t0 + 100})}};
+        tvariable_type var(d, c, dimension_type({"time"}));
+
+        typename tvariable_type::coordinate_map new_coord;
+        new_coord["time"] = taxis_type({t0 + 40, t0 + 200, t0 + 1000});
+
+        auto nearest = reindex(var, new_coord, fill_method::nearest);
+        std::vector<std::int64_t> exp_nearest = {0, 1, 1};
+        EXPECT_EQ(nearest.gather_index(0), exp_nearest);
+
+        auto tolerance = reindex(var, new_coord, fill_method::nearest, 150.);
+        std::vector<std::int64_t> exp_tolerance = {0, 1, -1};
+        EXPECT_EQ(tolerance.gather_index(0), exp_tolerance);
+    }
+
+    TEST(xreindex_view, fill_method_access)
+    {
+        auto var = make_test_variable();
+        coordinate_map new_coord;
+        new_coord["ordinate"] = iaxis_type({0, 1, 3, 6});
+        auto view = reindex(var, new_coord, fill_method::pad);
+
+        EXPECT_EQ(view(0, 0), view.missing());
+        EXPECT_EQ(view(0, 2), 2.);
+        EXPECT_EQ(view.locate("c", 6), 6.);
+        EXPECT_EQ(view.select({{"abscissa", "a"}, {"ordinate", 3}}), 2.);
+        EXPECT_EQ(view.select({{"abscissa", "a"}, {"ordinate", 0}}), view.missing());
+        EXPECT_EQ(view.select<join::outer>({{"abscissa", "d"}, {"ordinate", 6}}), 9.);
+        EXPECT_EQ(view.iselect({{"abscissa", 2}, {"ordinate", 2}}), 8.);
+
+        auto selector = view.prepare_selector({"abscissa", "ordinate"});
+        EXPECT_EQ(view.select(selector, {"d", 3}), 8.);
+        EXPECT_EQ(view.select(selector, {"d", 0}), view.missing());
+        EXPECT_ANY_THROW(view.select(selector, {"e", 1}));
+
+        variable_type res = view;
+        EXPECT_EQ(res.select({{"abscissa", "d"}, {"ordinate", 3}}), 8.);
+        EXPECT_EQ(res.select({{"abscissa", "c"}, {"ordinate", 6}}), 6.);
+        EXPECT_EQ(res.select({{"abscissa", "c"}, {"ordinate", 0}}), view.missing());
+    }
+
+    TEST(xreindex_view, fill_method_errors)
+    {
+        auto var = make_test_variable();
+        coordinate_map unsorted;
+        unsorted["ordinate"] = iaxis_type({3, 1});
+        EXPECT_THROW(reindex(var, unsorted, fill_method::pad), std::runtime_error);
+        EXPECT_NO_THROW(reindex(var, unsorted));
+
+        coordinate_map labels;
+        labels["abscissa"] = saxis_type({"b"});
+        EXPECT_EQ(reindex(var, labels, fill_method::pad)(0, 0), var(0, 0));
+        EXPECT_THROW(reindex(var, labels, fill_method::nearest), std::runtime_error);
+    }
 }
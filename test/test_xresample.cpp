@@ -0,0 +1,134 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xresample.hpp"
+
+namespace xf
+{
+    using range_type = xaxis_arange<int, std::size_t>;
+
+    // time: { 0, 10, 20, 65, 70, 190 }
+    // x: { 1, 2 }
+    // data(time, x) = 10 * time_index + x_index, (20, 1) is missing
+    inline variable_type make_resample_variable(bool time_first)
+    {
+        std::vector<std::size_t> shape = time_first ? std::vector<std::size_t>({6, 2}) : std::vector<std::size_t>({2, 6});
+        xt::xarray<double> values = xt::xarray<double>::from_shape(shape);
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape(shape);
+        for (std::size_t i = 0; i < 6; ++i)
+        {
+            for (std::size_t j = 0; j < 2; ++j)
+            {
+                double& value = time_first ? values(i, j) : values(j, i);
+                value = static_cast<double>(10 * i + j);
+                (time_first ? flags(i, j) : flags(j, i)) = i != 2 || j != 0;
+            }
+        }
+        dimension_type dims = time_first ? dimension_type({"time", "x"}) : dimension_type({"x", "time"});
+        return variable_type(data_type(values, flags),
+                             coordinate_type({{"time", iaxis_type({0, 10, 20, 65, 70, 190})},
+                                              {"x", iaxis_type({1, 2})}}),
+                             dims);
+    }
+
+    TEST(xresample, buckets)
+    {
+        auto v = make_resample_variable(true);
+        auto r = resample(v, "time", 60);
+        EXPECT_EQ(4u, r.size());
+        EXPECT_EQ(r.buckets(), range_type(0, 60, 4));
+
+        auto res = r.sum();
+        EXPECT_EQ(v.dimension_labels(), res.dimension_labels());
+        EXPECT_EQ(v.coordinates()["x"], res.coordinates()["x"]);
+        EXPECT_EQ(10., res.select({{"time", 0}, {"x", 1}}).value());
+        EXPECT_EQ(33., res.select({{"time", 0}, {"x", 2}}).value());
+        EXPECT_EQ(70., res.select({{"time", 60}, {"x", 1}}).value());
+        EXPECT_FALSE(res.select({{"time", 120}, {"x", 1}}).has_value());
+        EXPECT_EQ(50., res.select({{"time", 180}, {"x", 1}}).value());
+
+        auto res2 = resample(v, "time", 100).count();
+        EXPECT_EQ(2u, res2.coordinates()["time"].size());
+        EXPECT_EQ(4u, res2.select({{"time", 0}, {"x", 1}}).value());
+        EXPECT_EQ(5u, res2.select({{"time", 0}, {"x", 2}}).value());
+    }
+
+    TEST(xresample, aggregations)
+    {
+        for (bool time_first : { true, false })
+        {
+            auto v = make_resample_variable(time_first);
+            auto r = resample(v, "time", 60);
+
+            auto first = r.first();
+            auto last = r.last();
+            EXPECT_EQ(0., first.select({{"time", 0}, {"x", 1}}).value());
+            EXPECT_EQ(10., last.select({{"time", 0}, {"x", 1}}).value());
+            EXPECT_EQ(21., last.select({{"time", 0}, {"x", 2}}).value());
+            EXPECT_FALSE(r.last(false).select({{"time", 0}, {"x", 1}}).has_value());
+
+            auto min = r.amin();
+            auto max = r.amax();
+            EXPECT_EQ(30., min.select({{"time", 60}, {"x", 1}}).value());
+            EXPECT_EQ(41., max.select({{"time", 60}, {"x", 2}}).value());
+            EXPECT_FALSE(max.select({{"time", 120}, {"x", 2}}).has_value());
+
+            auto mean = r.mean();
+            EXPECT_EQ(5., mean.select({{"time", 0}, {"x", 1}}).value());
+            EXPECT_EQ(51., mean.select({{"time", 180}, {"x", 2}}).value());
+        }
+    }
+
+    TEST(xresample, negative_labels)
+    {
+        data_type d = {1., 2., 3.};
+        variable_type v(d, coordinate_type({{"time", iaxis_type({-30, -1, 0})}}), dimension_type({"time"}));
+        auto r = resample(v, "time", 60);
+        EXPECT_EQ(r.buckets(), range_type(-60, 60, 2));
+        auto res = r.sum();
+        EXPECT_EQ(3., res.select({{"time", -60}}).value());
+        EXPECT_EQ(3., res.select({{"time", 0}}).value());
+    }
+
+    TEST(xresample, timestamps)
+    {
+        using taxis_type = xaxis<long long, std::size_t>;
+        using trange_type = xaxis_arange<long long, std::size_t>;
+        using tcoordinate_type = xcoordinate<fstring, xtl::mpl::vector<long long>>;
+        using tvariable_type = xvariable_container<tcoordinate_type, data_type>;
+
+        // Epoch timestamps in seconds, resampled with an int width
+        const long long t0 = 1700000040LL;
+        data_type d = {1., 2., 3., 4.};
+        tvariable_type v(d, tcoordinate_type({{"time", taxis_type({t0, t0 + 30, t0 + 70, t0 + 190})}}), dimension_type({"time"}));
+        auto r = resample(v, "time", 60);
+        EXPECT_EQ(4u, r.size());
+        EXPECT_EQ(r.buckets(), trange_type(t0, 60, 4));
+
+        auto res = r.sum();
+        EXPECT_EQ(3., res.select({{"time", t0}}).value());
+        EXPECT_EQ(3., res.select({{"time", t0 + 60}}).value());
+        EXPECT_FALSE(res.select({{"time", t0 + 120}}).has_value());
+        EXPECT_EQ(4., res.select({{"time", t0 + 180}}).value());
+    }
+
+    TEST(xresample, errors)
+    {
+        auto v = make_resample_variable(true);
+        EXPECT_THROW(resample(v, "altitude", 60), std::out_of_range);
+        EXPECT_THROW(resample(v, "time", 0), std::runtime_error);
+
+        data_type d = {1., 2., 3.};
+        variable_type v2(d, coordinate_type({{"time", iaxis_type({0, 20, 10})}}), dimension_type({"time"}));
+        EXPECT_THROW(resample(v2, "time", 60), std::runtime_error);
+    }
+}
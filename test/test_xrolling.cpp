@@ -0,0 +1,132 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <algorithm>
+#include <numeric>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xrolling.hpp"
+
+namespace xf
+{
+    TEST(xrolling, sum)
+    {
+        auto v = make_test_variable();
+
+        auto res = rolling(v, "ordinate", 2, 1).sum();
+        EXPECT_EQ(v.dimension_labels(), res.dimension_labels());
+        EXPECT_EQ(v.coordinates(), res.coordinates());
+        EXPECT_EQ(1., res.select({{"abscissa", "a"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(3., res.select({{"abscissa", "a"}, {"ordinate", 2}}).value());
+        EXPECT_EQ(2., res.select({{"abscissa", "a"}, {"ordinate", 4}}).value());
+        EXPECT_FALSE(res.select({{"abscissa", "c"}, {"ordinate", 1}}).has_value());
+        EXPECT_EQ(11., res.select({{"abscissa", "c"}, {"ordinate", 4}}).value());
+        EXPECT_EQ(17., res.select({{"abscissa", "d"}, {"ordinate", 4}}).value());
+
+        auto res2 = rolling(v, "abscissa", 2, 1).sum();
+        EXPECT_EQ(1., res2.select({{"abscissa", "c"}, {"ordinate", 1}}).value());
+        EXPECT_EQ(13., res2.select({{"abscissa", "d"}, {"ordinate", 2}}).value());
+        EXPECT_FALSE(res2.select({{"abscissa", "a"}, {"ordinate", 4}}).has_value());
+        EXPECT_EQ(15., res2.select({{"abscissa", "d"}, {"ordinate", 4}}).value());
+    }
+
+    TEST(xrolling, min_periods)
+    {
+        auto v = make_test_variable();
+
+        auto r = rolling(v, "ordinate", 2);
+        EXPECT_EQ(2u, r.min_periods());
+        auto res = r.sum();
+        EXPECT_FALSE(res.select({{"abscissa", "d"}, {"ordinate", 1}}).has_value());
+        EXPECT_EQ(15., res.select({{"abscissa", "d"}, {"ordinate", 2}}).value());
+        EXPECT_EQ(3., res.select({{"abscissa", "a"}, {"ordinate", 2}}).value());
+        EXPECT_FALSE(res.select({{"abscissa", "a"}, {"ordinate", 4}}).has_value());
+
+        EXPECT_THROW(rolling(v, "altitude", 2), std::out_of_range);
+        EXPECT_THROW(rolling(v, "ordinate", 0), std::runtime_error);
+    }
+
+    TEST(xrolling, statistics)
+    {
+        auto v = make_test_variable();
+        auto r = rolling(v, "ordinate", 2, 1);
+
+        auto mean = r.mean();
+        EXPECT_EQ(1.5, mean.select({{"abscissa", "a"}, {"ordinate", 2}}).value());
+        EXPECT_EQ(2., mean.select({{"abscissa", "a"}, {"ordinate", 4}}).value());
+
+        auto var = r.variance();
+        EXPECT_EQ(0., var.select({{"abscissa", "d"}, {"ordinate", 1}}).value());
+        EXPECT_DOUBLE_EQ(0.25, var.select({{"abscissa", "d"}, {"ordinate", 2}}).value());
+        EXPECT_DOUBLE_EQ(0.25, var.select({{"abscissa", "d"}, {"ordinate", 4}}).value());
+        EXPECT_DOUBLE_EQ(0.5, r.stddev().select({{"abscissa", "d"}, {"ordinate", 4}}).value());
+
+        auto r3 = rolling(v, "ordinate", 3, 1);
+        auto min = r3.amin();
+        auto max = r3.amax();
+        EXPECT_EQ(7., min.select({{"abscissa", "d"}, {"ordinate", 4}}).value());
+        EXPECT_EQ(9., max.select({{"abscissa", "d"}, {"ordinate", 4}}).value());
+        EXPECT_FALSE(max.select({{"abscissa", "c"}, {"ordinate", 1}}).has_value());
+        EXPECT_EQ(5., min.select({{"abscissa", "c"}, {"ordinate", 4}}).value());
+
+        auto count = r3.count();
+        EXPECT_EQ(2u, count.select({{"abscissa", "a"}, {"ordinate", 4}}).value());
+    }
+
+    TEST(xrolling, parallel)
+    {
+        std::size_t n = 512, m = 256, w = 10;
+        std::vector<int> labels(n);
+        std::iota(labels.begin(), labels.end(), 0);
+        xt::xarray<double> values = xt::xarray<double>::from_shape({n, m});
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape({n, m});
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                values(i, j) = static_cast<double>((i * 7 + j * 13) % 101);
+                flags(i, j) = (i + j) % 11 != 0;
+            }
+        }
+        std::vector<int> labels2(labels.cbegin(), labels.cbegin() + static_cast<std::ptrdiff_t>(m));
+        variable_type v(data_type(values, flags),
+                        coordinate_type({{"x", iaxis_type(labels)}, {"y", iaxis_type(labels2)}}),
+                        dimension_type({"x", "y"}));
+
+        auto r = rolling(v, "x", w, 1);
+        auto sum = r.sum();
+        auto max = r.amax();
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                double s = 0.;
+                double mx = -1.;
+                std::size_t cnt = 0;
+                for (std::size_t k = i + 1 > w ? i + 1 - w : 0; k <= i; ++k)
+                {
+                    s += flags(k, j) ? values(k, j) : 0.;
+                    mx = flags(k, j) ? std::max(mx, values(k, j)) : mx;
+                    cnt += flags(k, j) ? 1u : 0u;
+                }
+                EXPECT_EQ(cnt != 0, max.data()(i, j).has_value());
+                if (cnt != 0)
+                {
+                    EXPECT_EQ(s, sum.data()(i, j).value());
+                    EXPECT_EQ(mx, max.data()(i, j).value());
+                }
+            }
+        }
+
+        xnum_threads_scope scope(4);
+        EXPECT_EQ(sum, r.sum());
+        EXPECT_EQ(max, r.amax());
+    }
+}
@@ -0,0 +1,118 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include "gtest/gtest.h"
+
+#include "xtl/xmeta_utils.hpp"
+#include "xframe/xaxis.hpp"
+#include "xframe/xaxis_variant.hpp"
+#include "xframe/xstring_label.hpp"
+
+namespace xf
+{
+    using label_type = xstring_label;
+    using slabel_axis_type = xaxis<xstring_label, std::size_t>;
+    using slabel_variant_type = xaxis_variant<xtl::mpl::vector<int, xstring_label>, std::size_t>;
+
+    TEST(xstring_label, constructor)
+    {
+        label_type l0;
+        EXPECT_TRUE(l0.empty());
+        EXPECT_EQ(0u, l0.size());
+        EXPECT_EQ(std::string(), l0.str());
+
+        label_type l1("apple");
+        label_type l2(std::string("apple"));
+        label_type l3("apple pie", 5);
+        EXPECT_EQ(l1.code(), l2.code());
+        EXPECT_EQ(l1.code(), l3.code());
+        EXPECT_EQ(5u, l1.size());
+        EXPECT_EQ(std::string("apple"), l1.c_str());
+
+        EXPECT_EQ(sizeof(std::uint32_t), sizeof(label_type));
+    }
+
+    TEST(xstring_label, comparison)
+    {
+        label_type a("a");
+        label_type ab("ab");
+        label_type b("b");
+
+        EXPECT_TRUE(a == label_type("a"));
+        EXPECT_TRUE(a != b);
+        EXPECT_TRUE(a < ab);
+        EXPECT_TRUE(ab < b);
+        EXPECT_TRUE(b > a);
+        EXPECT_TRUE(a <= a);
+        EXPECT_TRUE(b >= ab);
+        EXPECT_TRUE(label_type() < a);
+    }
+
+    TEST(xstring_label, hash)
+    {
+        std::unordered_set<label_type> s = { "a", "b", "a" };
+        EXPECT_EQ(2u, s.size());
+        EXPECT_EQ(1u, s.count("b"));
+        EXPECT_EQ(std::hash<label_type>()(label_type("b")), std::hash<label_type>()(label_type("b")));
+    }
+
+    TEST(xstring_label, print)
+    {
+        std::ostringstream out;
+        out << label_type("label");
+        EXPECT_EQ("label", out.str());
+    }
+
+    TEST(xstring_label, dictionary)
+    {
+        xstring_dictionary& dict = xstring_dictionary::instance();
+        std::size_t size = dict.size();
+        label_type l1("a string that has never been inserted");
+        EXPECT_EQ(size + 1, dict.size());
+        label_type l2("a string that has never been inserted");
+        EXPECT_EQ(size + 1, dict.size());
+        EXPECT_EQ(l1.data(), l2.data());
+        EXPECT_EQ(std::string("a string that has never been inserted"), dict.data(l1.code()));
+
+        std::string large(100000, 'x');
+        label_type l3(large);
+        EXPECT_EQ(large, l3.str());
+        EXPECT_LE(large.size(), dict.arena_size());
+    }
+
+    TEST(xstring_label, axis)
+    {
+        slabel_axis_type a = { "d", "a", "c" };
+        EXPECT_FALSE(a.is_sorted());
+        EXPECT_TRUE(a.contains("a"));
+        EXPECT_FALSE(a.contains("b"));
+        EXPECT_EQ(0u, a["d"]);
+        EXPECT_EQ(2u, a["c"]);
+
+        slabel_axis_type a2 = { "a", "b" };
+        slabel_axis_type res = a;
+        res.merge(a2);
+        EXPECT_EQ(4u, res.size());
+        EXPECT_EQ(3u, res["b"]);
+    }
+
+    TEST(xstring_label, axis_variant)
+    {
+        slabel_variant_type a = slabel_axis_type({ "a", "c", "d" });
+        EXPECT_TRUE(a.contains(label_type("c")));
+        EXPECT_EQ(1u, a[label_type("c")]);
+        EXPECT_EQ(2u, a["d"]);
+        EXPECT_EQ(slabel_variant_type::key_type(label_type("a")), a.label(0));
+    }
+}
@@ -0,0 +1,180 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <numeric>
+#include <type_traits>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xbitmap.hpp"
+#include "xframe/xtranspose.hpp"
+
+namespace xf
+{
+    template <class T1, class T2>
+    inline void expect_same_element(const T1& expected, const T2& actual)
+    {
+        EXPECT_EQ(expected.has_value(), actual.has_value());
+        if (expected.has_value() && actual.has_value())
+        {
+            EXPECT_EQ(expected.value(), actual.value());
+        }
+    }
+
+    inline variable_type make_transpose_variable(std::size_t n, std::size_t m, bool x_first)
+    {
+        std::vector<int> xlabels(n), ylabels(m);
+        std::iota(xlabels.begin(), xlabels.end(), 0);
+        std::iota(ylabels.begin(), ylabels.end(), 0);
+        std::vector<std::size_t> shape = x_first ? std::vector<std::size_t>({n, m}) : std::vector<std::size_t>({m, n});
+        xt::xarray<double> values = xt::xarray<double>::from_shape(shape);
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape(shape);
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                (x_first ? values(i, j) : values(j, i)) = static_cast<double>(i * m + j);
+                (x_first ? flags(i, j) : flags(j, i)) = (i + 2 * j) % 7 != 0;
+            }
+        }
+        dimension_type dims = x_first ? dimension_type({"x", "y"}) : dimension_type({"y", "x"});
+        return variable_type(data_type(values, flags),
+                             coordinate_type({{"x", iaxis_type(xlabels)}, {"y", iaxis_type(ylabels)}}),
+                             dims);
+    }
+
+    TEST(xtranspose, transpose)
+    {
+        auto v = make_test_variable();
+        auto res = transpose(v, {"ordinate", "abscissa"});
+        EXPECT_EQ(dimension_type({"ordinate", "abscissa"}), res.dimension_mapping());
+        EXPECT_EQ(v.coordinates(), res.coordinates());
+        EXPECT_EQ(v.shape()[0], res.shape()[1]);
+        EXPECT_EQ(v.shape()[1], res.shape()[0]);
+        for (std::size_t i = 0; i < v.shape()[0]; ++i)
+        {
+            for (std::size_t j = 0; j < v.shape()[1]; ++j)
+            {
+                expect_same_element(v.data()(i, j), res.data()(j, i));
+            }
+        }
+
+        auto res2 = transpose(res, {"abscissa", "ordinate"});
+        EXPECT_EQ(v, res2);
+    }
+
+    TEST(xtranspose, three_dimensions)
+    {
+        std::size_t n = 45, m = 3, p = 70;
+        xt::xarray<double> values = xt::xarray<double>::from_shape({n, m, p});
+        xt::xarray<bool> flags = xt::xarray<bool>::from_shape({n, m, p});
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            values.data()[i] = static_cast<double>(i);
+            flags.data()[i] = i % 5 != 0;
+        }
+        std::vector<int> labels(p);
+        std::iota(labels.begin(), labels.end(), 0);
+        variable_type v(data_type(values, flags),
+                        coordinate_type({{"a", iaxis_type(std::vector<int>(labels.cbegin(), labels.cbegin() + 45))},
+                                         {"b", iaxis_type({0, 1, 2})},
+                                         {"c", iaxis_type(labels)}}),
+                        dimension_type({"a", "b", "c"}));
+
+        auto res = transpose(v, {"c", "a", "b"});
+        EXPECT_EQ(dimension_type({"c", "a", "b"}), res.dimension_mapping());
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            for (std::size_t j = 0; j < m; ++j)
+            {
+                for (std::size_t k = 0; k < p; ++k)
+                {
+                    expect_same_element(v.data()(i, j, k), res.data()(k, i, j));
+                }
+            }
+        }
+
+        xnum_threads_scope scope(4);
+        EXPECT_EQ(res, transpose(v, {"c", "a", "b"}));
+    }
+
+    TEST(xtranspose, unit_dimension)
+    {
+        // The unit dimension has a null stride and must not be tiled
+        std::size_t n = 40, p = 70;
+        std::vector<std::size_t> shape = {p, 1, n};
+        std::vector<std::size_t> strides = {1, 0, p};
+        std::vector<std::size_t> copied(n * p, n * p);
+        detail::permuted_copy(shape, strides, [&copied](std::size_t dst, std::size_t src) { copied[dst] = src; });
+        for (std::size_t k = 0; k < p; ++k)
+        {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                EXPECT_EQ(i * p + k, copied[k * n + i]);
+            }
+        }
+    }
+
+    TEST(xtranspose, bitmap)
+    {
+        using bitmap_variable_type = xvariable_container<coordinate_type, xbitmap_optional_assembly<double>>;
+        auto v = make_test_grid_variable<bitmap_variable_type>(70, 90);
+        auto res = transpose(v, {"y", "x"});
+        bool same_data_type = std::is_same<bitmap_variable_type::data_type, decltype(res)::data_type>::value;
+        EXPECT_TRUE(same_data_type);
+        for (std::size_t i = 0; i < v.shape()[0]; ++i)
+        {
+            for (std::size_t j = 0; j < v.shape()[1]; ++j)
+            {
+                expect_same_element(v.data()(i, j), res.data()(j, i));
+            }
+        }
+
+        xnum_threads_scope scope(4);
+        EXPECT_EQ(res, transpose(v, {"y", "x"}));
+    }
+
+    TEST(xtranspose, errors)
+    {
+        auto v = make_test_variable();
+        EXPECT_THROW(transpose(v, {"ordinate"}), std::runtime_error);
+        EXPECT_THROW(transpose(v, {"ordinate", "ordinate"}), std::runtime_error);
+        EXPECT_THROW(transpose(v, {"ordinate", "altitude"}), std::out_of_range);
+    }
+
+    TEST(xtranspose, reordered_assign)
+    {
+        EXPECT_FALSE(detail::is_reorder_cheaper(1000, 1000, 100, 8));
+        EXPECT_FALSE(detail::is_reorder_cheaper(1 << 20, 1 << 20, 1, 8));
+        EXPECT_TRUE(detail::is_reorder_cheaper(1 << 20, 1 << 20, 1024, 8));
+
+        // 2.4MB operands, large enough for the reordered copy
+        std::size_t n = 600, m = 500;
+        auto a = make_transpose_variable(n, m, true);
+        auto b = make_transpose_variable(n, m, false);
+
+        variable_type res = a + b;
+        EXPECT_EQ(a.dimension_mapping(), res.dimension_mapping());
+        for (std::size_t i = 0; i < n; i += 7)
+        {
+            for (std::size_t j = 0; j < m; j += 3)
+            {
+                auto expected = a.data()(i, j) + b.data()(j, i);
+                expect_same_element(expected, res.data()(i, j));
+            }
+        }
+
+        variable_type res2 = a + transpose(b, {"x", "y"});
+        EXPECT_EQ(res, res2);
+
+        xnum_threads_scope scope(4);
+        variable_type res3 = a + b;
+        EXPECT_EQ(res, res3);
+    }
+}
@@ -218,6 +218,46 @@ namespace xf
         EXPECT_EQ(mis, v.missing());
     }
 
+    TEST(xvariable, prepared_select)
+    {
+        auto v = make_test_variable();
+        auto selector = v.prepare_selector({"abscissa", "ordinate", "altitude"});
+        EXPECT_EQ(3u, selector.size());
+
+        EXPECT_EQ(v.select(selector, {"a", 1, 1}), v(0, 0));
+        EXPECT_EQ(v.select(selector, {"c", 4, 1}), v(1, 2));
+        EXPECT_EQ(v.select(selector, {"d", 2, 1}), v(2, 1));
+        EXPECT_ANY_THROW(v.select(selector, {"e", 1, 1}));
+
+        auto selector2 = v.prepare_selector({"ordinate", "abscissa"});
+        v.select(selector2, {2, "c"}) = 2.5;
+        EXPECT_EQ(v(1, 1), 2.5);
+
+        const auto& cv = v;
+        EXPECT_EQ(cv.select(selector2, {1, "d"}), v(2, 0));
+        EXPECT_EQ(cv.select<join::outer>(selector2, {4, "a"}), v(0, 2));
+        EXPECT_EQ(cv.select<join::outer>(selector2, {1, "e"}), v.missing());
+    }
+
+    TEST(xvariable, select_batch)
+    {
+        const auto v = make_test_variable();
+        auto res = v.select_batch({"ordinate", "abscissa"}, {{4, 1, 4, 2}, {"c", "a", "c", "d"}});
+        ASSERT_EQ(4u, res.size());
+        EXPECT_EQ(res(0), v(1, 2));
+        EXPECT_EQ(res(1), v(0, 0));
+        EXPECT_EQ(res(2), v(1, 2));
+        EXPECT_EQ(res(3), v(2, 1));
+
+        EXPECT_ANY_THROW(v.select_batch({"ordinate", "abscissa"}, {{1, 1}, {"a", "e"}}));
+        EXPECT_ANY_THROW(v.select_batch({"ordinate", "abscissa"}, {{1, 1}, {"a"}}));
+
+        auto selector = v.prepare_selector({"abscissa", "ordinate"});
+        auto res2 = v.select_batch<join::outer>(selector, {{"e", "d"}, {1, 1}});
+        EXPECT_EQ(res2(0), v.missing());
+        EXPECT_EQ(res2(1), v(2, 0));
+    }
+
     TEST(xvariable, iselect)
     {
         auto v = make_test_variable();
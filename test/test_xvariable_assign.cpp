@@ -466,5 +466,23 @@ namespace xf
         EXPECT_EQ(res(1, 0), 6.);
         EXPECT_EQ(res(1, 1), 9.);
     }
-}
 
+    TEST(xvariable_assign, transposed_dimensions)
+    {
+        variable_type a = make_test_variable();
+
+        data_type d = {{ 1., 4., 7.},
+                       { 2., 5., 8.},
+                       { 3., 6., 9.}};
+        d(2, 0).has_value() = false;
+        d(0, 1).has_value() = false;
+        variable_type b = variable_type(d, make_test_coordinate(), dimension_type({"ordinate", "abscissa"}));
+
+        variable_type res = a + 2. * b;
+        selector_list sl = make_selector_list_aa();
+        for (std::size_t i = 0; i < sl.size(); ++i)
+        {
+            EXPECT_EQ(res.select(sl[i]), a.select(sl[i]) + 2. * b.select(sl[i]));
+        }
+    }
+}
@@ -8,6 +8,9 @@
 * The full license is in the file LICENSE, distributed with this software. *
 ****************************************************************************/
 
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include "gtest/gtest.h"
 #include "test_fixture.hpp"
 
@@ -152,6 +155,54 @@ namespace xf
         EXPECT_FALSE(res4.m_same_labels);
     }
 
+    TEST(xvariable_function, coordinates_cache)
+    {
+        xfunction_features f;
+        auto func = f.m_a + f.m_b;
+
+        const coordinate_type* inner = &func.coordinates();
+        const coordinate_type* outer = &func.coordinates<join::outer>();
+        EXPECT_NE(inner, outer);
+        EXPECT_EQ(inner, &func.coordinates());
+        EXPECT_EQ(outer, &func.coordinates<join::outer>());
+        EXPECT_EQ(*inner, make_intersect_coordinate());
+        EXPECT_EQ(*outer, make_merge_coordinate());
+
+        auto func2 = func;
+        EXPECT_EQ(func2.coordinates(), make_intersect_coordinate());
+        EXPECT_EQ(func2.coordinates<join::outer>(), make_merge_coordinate());
+    }
+
+    TEST(xvariable_function, concurrent_coordinates)
+    {
+        xfunction_features f;
+        auto func = f.m_a + f.m_b;
+        dict_type sel = {{"abscissa", "d"}, {"ordinate", 4}, {"altitude", 2}};
+        double expected = f.m_a.select(sel).value() + f.m_b.select(sel).value();
+
+        std::vector<std::thread> threads;
+        std::vector<int> success(8, 0);
+        for (std::size_t i = 0; i < success.size(); ++i)
+        {
+            threads.emplace_back([&func, &sel, &expected, &success, i]()
+            {
+                bool res = true;
+                for (std::size_t j = 0; j < 100; ++j)
+                {
+                    res = res && func.coordinates() == make_intersect_coordinate();
+                    res = res && func.coordinates<join::outer>() == make_merge_coordinate();
+                    res = res && func.select(sel).value() == expected;
+                }
+                success[i] = res;
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        EXPECT_TRUE(std::all_of(success.cbegin(), success.cend(), [](int r) { return r == 1; }));
+    }
+
     TEST(xvariable_function, select_inner)
     {
         xfunction_features f;
@@ -49,6 +49,35 @@ namespace xf
         }
     }
 
+    TEST(xvariable_masked_view, separable_mask)
+    {
+        variable_type var = make_test_variable4();
+        variable_type expected = var;
+        auto masked_var = where(var,
+            var.axis<int>("altitude") + var.axis<int>("ordinate") < 6 &&
+            not_equal(var.axis<fstring>("abscissa"), fstring("d"))
+        );
+        masked_var = 100.;
+
+        int altitude[3] = { 1, 2, 4 };
+        fstring abscissa[3] = { "a", "d", "e" };
+        int ordinate[3] = { 1, 4, 5 };
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            for (std::size_t j = 0; j < 3; ++j)
+            {
+                for (std::size_t k = 0; k < 3; ++k)
+                {
+                    if (altitude[i] + ordinate[k] < 6 && abscissa[j] != fstring("d"))
+                    {
+                        expected.iselect({{"altitude", i}, {"abscissa", j}, {"ordinate", k}}) = 100.;
+                    }
+                }
+            }
+        }
+        EXPECT_EQ(expected, var);
+    }
+
     TEST(xvariable_masked_view, select_inner)
     {
         variable_type var = make_test_view_variable();
@@ -241,4 +270,25 @@ namespace xf
         ASSERT_NE(masked_var.data(), test_var.data());
         ASSERT_NE(var.data(), test_var.data());
     }
+
+    TEST(xvariable_masked_view, aligned_assign)
+    {
+        variable_type var = make_test_view_variable();
+        variable_type expected = make_test_view_variable();
+        variable_type src = make_test_view_variable();
+        src.data().value() += 100.;
+
+        auto masked_var = where(var, var.axis<int>("ordinate") < 6);
+        masked_var = src;
+
+        // The first four labels of the ordinate are lower than 6
+        for (std::size_t i = 0; i < 8; ++i)
+        {
+            for (std::size_t j = 0; j < 4; ++j)
+            {
+                expected(i, j) = src(i, j);
+            }
+        }
+        EXPECT_EQ(expected, var);
+    }
 }
@@ -0,0 +1,118 @@
+/***************************************************************************
+* Copyright (c) Johan Mabille, Sylvain Corlay, Wolf Vollprecht and         *
+* Martin Renou                                                             *
+* Copyright (c) QuantStack                                                 *
+*                                                                          *
+* Distributed under the terms of the BSD 3-Clause License.                 *
+*                                                                          *
+* The full license is in the file LICENSE, distributed with this software. *
+****************************************************************************/
+
+#include <cmath>
+#include "gtest/gtest.h"
+#include "test_fixture.hpp"
+#include "xframe/xvariable_reducer.hpp"
+
+namespace xf
+{
+    using dimension_list = std::vector<fstring>;
+
+    TEST(xvariable_reducer, sum)
+    {
+        auto v = make_test_variable();
+
+        auto res = xf::sum(v, {"ordinate"});
+        EXPECT_EQ(dimension_list({"abscissa"}), res.dimension_labels());
+        EXPECT_EQ(v.coordinates()["abscissa"], res.coordinates()["abscissa"]);
+        EXPECT_FALSE(res.coordinates().contains("ordinate"));
+        EXPECT_EQ(3., res.select({{"abscissa", "a"}}).value());
+        EXPECT_EQ(11., res.select({{"abscissa", "c"}}).value());
+        EXPECT_EQ(24., res.select({{"abscissa", "d"}}).value());
+
+        auto res2 = xf::sum(v, {"abscissa"});
+        EXPECT_EQ(dimension_list({"ordinate"}), res2.dimension_labels());
+        EXPECT_EQ(8., res2.select({{"ordinate", 1}}).value());
+        EXPECT_EQ(15., res2.select({{"ordinate", 2}}).value());
+        EXPECT_EQ(15., res2.select({{"ordinate", 4}}).value());
+
+        EXPECT_ANY_THROW(xf::sum(v, {"altitude"}));
+    }
+
+    TEST(xvariable_reducer, skipna)
+    {
+        auto v = make_test_variable();
+
+        auto res = xf::sum(v, {"ordinate"}, false);
+        EXPECT_FALSE(res.select({{"abscissa", "a"}}).has_value());
+        EXPECT_FALSE(res.select({{"abscissa", "c"}}).has_value());
+        EXPECT_TRUE(res.select({{"abscissa", "d"}}).has_value());
+        EXPECT_EQ(24., res.select({{"abscissa", "d"}}).value());
+
+        auto res2 = xf::mean(v, {"abscissa"}, false);
+        EXPECT_FALSE(res2.select({{"ordinate", 1}}).has_value());
+        EXPECT_EQ(5., res2.select({{"ordinate", 2}}).value());
+        EXPECT_FALSE(res2.select({{"ordinate", 4}}).has_value());
+    }
+
+    TEST(xvariable_reducer, mean)
+    {
+        auto v = make_test_variable();
+        auto res = xf::mean(v, {"ordinate"});
+        EXPECT_EQ(1.5, res.select({{"abscissa", "a"}}).value());
+        EXPECT_EQ(5.5, res.select({{"abscissa", "c"}}).value());
+        EXPECT_EQ(8., res.select({{"abscissa", "d"}}).value());
+    }
+
+    TEST(xvariable_reducer, extrema)
+    {
+        auto v = make_test_variable();
+
+        auto res = xf::amin(v, {"abscissa"});
+        EXPECT_EQ(1., res.select({{"ordinate", 1}}).value());
+        EXPECT_EQ(2., res.select({{"ordinate", 2}}).value());
+        EXPECT_EQ(6., res.select({{"ordinate", 4}}).value());
+
+        auto res2 = xf::amax(v, {"ordinate"});
+        EXPECT_EQ(2., res2.select({{"abscissa", "a"}}).value());
+        EXPECT_EQ(6., res2.select({{"abscissa", "c"}}).value());
+        EXPECT_EQ(9., res2.select({{"abscissa", "d"}}).value());
+    }
+
+    TEST(xvariable_reducer, variance)
+    {
+        auto v = make_test_variable();
+
+        auto res = xf::variance(v, {"ordinate"});
+        EXPECT_DOUBLE_EQ(0.25, res.select({{"abscissa", "a"}}).value());
+        EXPECT_DOUBLE_EQ(0.25, res.select({{"abscissa", "c"}}).value());
+        EXPECT_DOUBLE_EQ(2. / 3., res.select({{"abscissa", "d"}}).value());
+
+        auto res2 = xf::stddev(v, {"abscissa"});
+        EXPECT_DOUBLE_EQ(3., res2.select({{"ordinate", 1}}).value());
+        EXPECT_DOUBLE_EQ(std::sqrt(6.), res2.select({{"ordinate", 2}}).value());
+        EXPECT_DOUBLE_EQ(1.5, res2.select({{"ordinate", 4}}).value());
+    }
+
+    TEST(xvariable_reducer, count)
+    {
+        auto v = make_test_variable();
+
+        auto res = xf::count(v, {"ordinate"});
+        EXPECT_EQ(2u, res.select({{"abscissa", "a"}}).value());
+        EXPECT_EQ(2u, res.select({{"abscissa", "c"}}).value());
+        EXPECT_EQ(3u, res.select({{"abscissa", "d"}}).value());
+
+        auto res2 = xf::count(v, {"abscissa", "ordinate"});
+        EXPECT_EQ(0u, res2.dimension());
+        EXPECT_EQ(7u, res2.data()().value());
+    }
+
+    TEST(xvariable_reducer, function)
+    {
+        auto v = make_test_variable();
+        auto res = xf::sum(v + v, {"ordinate"});
+        EXPECT_EQ(6., res.select({{"abscissa", "a"}}).value());
+        EXPECT_EQ(22., res.select({{"abscissa", "c"}}).value());
+        EXPECT_EQ(48., res.select({{"abscissa", "d"}}).value());
+    }
+}
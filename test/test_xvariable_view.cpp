@@ -181,6 +181,39 @@ namespace xf
         EXPECT_ANY_THROW(view.select({{ "abscissa", "e" }, { "ordinate", 1 }}));
     }
 
+    TEST(xvariable_view, prepared_select)
+    {
+        variable_type var = make_test_view_variable();
+        variable_view_type view = build_view(var);
+        auto selector = view.prepare_selector({"abscissa", "ordinate"});
+
+        EXPECT_EQ(view.select(selector, {"f", 1}), var.select({{"abscissa", "f"}, {"ordinate", 1}}));
+        EXPECT_EQ(view.select(selector, {"h", 4}), var.select({{"abscissa", "h"}, {"ordinate", 4}}));
+        EXPECT_EQ(view.select(selector, {"n", 6}), var.select({{"abscissa", "n"}, {"ordinate", 6}}));
+        EXPECT_ANY_THROW(view.select(selector, {"d", 1}));
+
+        const variable_view_type& cview = view;
+        EXPECT_EQ(cview.select(selector, {"g", 6}), var.select({{"abscissa", "g"}, {"ordinate", 6}}));
+        EXPECT_EQ(cview.select<join::outer>(selector, {"d", 1}), cview.missing());
+    }
+
+    TEST(xvariable_view, select_batch)
+    {
+        variable_type var = make_test_view_variable();
+        variable_view_type view = build_view(var);
+
+        auto res = view.select_batch({"abscissa", "ordinate"}, {{"f", "n", "f"}, {1, 6, 1}});
+        ASSERT_EQ(3u, res.size());
+        EXPECT_EQ(res(0), var.select({{"abscissa", "f"}, {"ordinate", 1}}));
+        EXPECT_EQ(res(1), var.select({{"abscissa", "n"}, {"ordinate", 6}}));
+        EXPECT_EQ(res(2), res(0));
+
+        EXPECT_ANY_THROW(view.select_batch({"abscissa", "ordinate"}, {{"d"}, {1}}));
+        auto res2 = view.select_batch<join::outer>({"abscissa", "ordinate"}, {{"d", "g"}, {1, 4}});
+        EXPECT_EQ(res2(0), view.missing());
+        EXPECT_EQ(res2(1), var.select({{"abscissa", "g"}, {"ordinate", 4}}));
+    }
+
     TEST(xvariable_view, select_outer)
     {
         variable_type var = make_test_view_variable();
@@ -560,4 +593,40 @@ namespace xf
         EXPECT_EQ(view, view4);
         EXPECT_EQ(view, view5);
     }
+
+    TEST(xvariable_view, assign)
+    {
+        variable_type var = make_test_view_variable();
+        auto view = select(var, {{"abscissa", range("f", "n")}, {"ordinate", range(1, 6, 2)}});
+        variable_type src = view;
+        src.data().value() += 100.;
+
+        view = src;
+        EXPECT_EQ(view.data(), src.data());
+        EXPECT_EQ(var.select({{"abscissa", "f"}, {"ordinate", 4}}), 126.);
+        EXPECT_EQ(var.select({{"abscissa", "n"}, {"ordinate", 6}}), 160.);
+        EXPECT_EQ(var.select({{"abscissa", "f"}, {"ordinate", 2}}), 25.);
+        EXPECT_EQ(var.select({{"abscissa", "a"}, {"ordinate", 1}}), 0.);
+    }
+
+    TEST(xvariable_view, assign_misaligned)
+    {
+        variable_type var = make_test_view_variable();
+        auto view = select(var, {{"abscissa", range("f", "n")}, {"ordinate", range(1, 6, 2)}});
+        variable_type src = view;
+        src.data().value() += 100.;
+
+        // Same labels as the view, in a different order
+        auto coord = coordinate<fstring>({
+            {fstring("abscissa"), saxis_type({"f", "g", "h", "m", "n"})},
+            {fstring("ordinate"), iaxis_type({6, 4, 1})}
+        });
+        variable_type reversed(src.data(), std::move(coord), dimension_type({"abscissa", "ordinate"}));
+
+        view = reversed;
+        EXPECT_EQ(var.select({{"abscissa", "f"}, {"ordinate", 6}}), 124.);
+        EXPECT_EQ(var.select({{"abscissa", "f"}, {"ordinate", 1}}), 128.);
+        EXPECT_EQ(var.select({{"abscissa", "n"}, {"ordinate", 4}}), 158.);
+        EXPECT_EQ(var.select({{"abscissa", "f"}, {"ordinate", 2}}), 25.);
+    }
 }